@@ -73,6 +73,10 @@ if [ ! -f "$RAYLIB_LIB" ]; then
     echo "Attempting to build anyway..."
 fi
 
+# Generate the asset manifest and pack (copied to build/assets with the other assets)
+./generate_manifest.sh
+python3 generate_pack.py
+
 # Create build directory
 mkdir -p build
 cd build
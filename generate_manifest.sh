@@ -0,0 +1,13 @@
+#!/bin/sh
+
+# Generate assets/manifest.txt, listing every file under assets/ with its
+# size in bytes ("path<tab>size", one per line).  MSRLWeb loads this at
+# startup so that imports and file loads can go straight to the right URL.
+
+cd "$(dirname "$0")"
+
+find assets -type f ! -name manifest.txt ! -name assets.pack ! -name '.*' | LC_ALL=C sort | while read -r f; do
+    printf '%s\t%s\n' "$f" "$(wc -c < "$f" | tr -d ' ')"
+done > assets/manifest.txt
+
+echo "Generated assets/manifest.txt ($(wc -l < assets/manifest.txt | tr -d ' ') files)"
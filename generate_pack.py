@@ -0,0 +1,64 @@
+#!/usr/bin/env python3
+
+# Generate assets/assets.pack: all files under assets/ in a single file, so
+# MSRLWeb can fetch them with one request at startup and serve them from
+# memory.  Files that compress well are stored raw-deflate compressed (which
+# raylib's DecompressData can inflate).  See src/loadfile.cpp for the format.
+
+import os
+import struct
+import sys
+import zlib
+
+PACK_NAME = "assets.pack"
+SKIP = {PACK_NAME, "manifest.txt"}
+COMPRESSED = 1
+
+
+def deflate(data):
+    c = zlib.compressobj(9, zlib.DEFLATED, -15)   # raw deflate, no zlib header
+    return c.compress(data) + c.flush()
+
+
+def main():
+    os.chdir(os.path.dirname(os.path.abspath(__file__)))
+    paths = []
+    for root, dirs, files in os.walk("assets"):
+        dirs[:] = [d for d in dirs if not d.startswith(".")]
+        for name in files:
+            if name in SKIP or name.startswith("."):
+                continue
+            paths.append(os.path.join(root, name).replace(os.sep, "/"))
+    paths.sort()
+
+    entries = []
+    for path in paths:
+        with open(path, "rb") as f:
+            data = f.read()
+        packed = deflate(data)
+        if len(packed) < len(data) * 0.9:
+            entries.append((path, COMPRESSED, packed, len(data)))
+        else:
+            entries.append((path, 0, data, len(data)))
+
+    index_size = 12 + sum(2 + len(p.encode("utf-8")) + 16 for p, _, _, _ in entries)
+    index = bytearray(b"MSPK" + struct.pack("<II", 1, len(entries)))
+    offset = index_size
+    for path, flags, stored, size in entries:
+        encoded = path.encode("utf-8")
+        index += struct.pack("<H", len(encoded)) + encoded
+        index += struct.pack("<IIII", flags, offset, len(stored), size)
+        offset += len(stored)
+
+    with open(os.path.join("assets", PACK_NAME), "wb") as f:
+        f.write(index)
+        for _, _, stored, _ in entries:
+            f.write(stored)
+
+    total = sum(size for _, _, _, size in entries)
+    print("Generated assets/%s (%d files, %d bytes; %d bytes unpacked)"
+          % (PACK_NAME, len(entries), offset, total))
+
+
+if __name__ == "__main__":
+    sys.exit(main())
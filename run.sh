@@ -6,6 +6,9 @@
 rm -r build/assets
 ln -s "../assets" build/assets
 
+# ...and drop the asset pack, which would otherwise serve stale copies of them
+rm -f assets/assets.pack
+
 # Function to cleanup on exit
 cleanup() {
     echo ""
@@ -11,10 +11,21 @@
 #include "raylib.h"
 #include "MiniscriptInterpreter.h"
 #include "MiniscriptTypes.h"
+#include "loadfile.h"
+#include "asyncload.h"
 #include "macros.h"
 
 using namespace MiniScript;
 
+// Helper: load a wave straight from its preloaded data, without copying it
+// (falling back on loading from the file as usual)
+static Wave LoadWavePreloaded(const char *fileName) {
+	int size;
+	const unsigned char *data = GetPreloadedFile(fileName, &size);
+	if (!data) return LoadWave(fileName);
+	return LoadWaveFromMemory(GetFileExtension(fileName), data, size);
+}
+
 void AddRAudioMethods(ValueDict raylibModule) {
 	Intrinsic *i;
 
@@ -25,60 +36,76 @@ void AddRAudioMethods(ValueDict raylibModule) {
 		InitAudioDevice();
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("InitAudioDevice", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "InitAudioDevice", i);
 
 	i = Intrinsic::Create("");
 	i->code = INTRINSIC_LAMBDA {
 		CloseAudioDevice();
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("CloseAudioDevice", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "CloseAudioDevice", i);
 
 	i = Intrinsic::Create("");
 	i->code = INTRINSIC_LAMBDA {
 		return IntrinsicResult(IsAudioDeviceReady());
 	};
-	raylibModule.SetValue("IsAudioDeviceReady", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "IsAudioDeviceReady", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("volume", Value(1.0));
 	i->code = INTRINSIC_LAMBDA {
-		float volume = context->GetVar(String("volume")).FloatValue();
+		float volume = ARG("volume").FloatValue();
 		SetMasterVolume(volume);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("SetMasterVolume", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "SetMasterVolume", i);
 
 	i = Intrinsic::Create("");
 	i->code = INTRINSIC_LAMBDA {
 		float volume = GetMasterVolume();
 		return IntrinsicResult(volume);
 	};
-	raylibModule.SetValue("GetMasterVolume", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetMasterVolume", i);
 
 	// Wave loading
 
 	i = Intrinsic::Create("");
 	i->AddParam("fileName");
 	i->code = INTRINSIC_LAMBDA {
-		String path = context->GetVar(String("fileName")).ToString();
-		Wave wave = LoadWave(path.c_str());
+		String path = ARG("fileName").ToString();
+		if (!WaitForFile(path, partialResult)) return partialResult;
+		Wave wave = LoadWavePreloaded(path.c_str());
 		if (!IsWaveValid(wave)) return IntrinsicResult::Null;
 		return IntrinsicResult(WaveToValue(wave));
 	};
-	raylibModule.SetValue("LoadWave", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "LoadWave", i);
+
+	i = Intrinsic::Create("");
+	i->AddParam("fileName");
+	i->code = INTRINSIC_LAMBDA {
+		String path = ARG("fileName").ToString();
+		const char *ext = GetFileExtension(path.c_str());
+		String fileType = ext ? ext : "";
+		long handle = StartAsyncLoad(path.c_str(), [fileType](const unsigned char *data, int size) -> Value {
+			Wave wave = LoadWaveFromMemory(fileType.c_str(), data, size);
+			if (!IsWaveValid(wave)) return Value::null;
+			return WaveToValue(wave);
+		});
+		return IntrinsicResult(Value((double)handle));
+	};
+	RegisterIntrinsic(raylibModule, "LoadWaveAsync", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("fileType");
 	i->AddParam("fileData");
 	i->AddParam("dataSize");
 	i->code = INTRINSIC_LAMBDA {
-		String fileType = context->GetVar(String("fileType")).ToString();
+		String fileType = ARG("fileType").ToString();
 		// Note: This would need a byte array type in MiniScript to be fully useful
 		// For now, we'll skip implementing this
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("LoadWaveFromMemory", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "LoadWaveFromMemory", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("frameCount");
@@ -87,11 +114,11 @@ void AddRAudioMethods(ValueDict raylibModule) {
 	i->AddParam("channels");
 	i->AddParam("samples");
 	i->code = INTRINSIC_LAMBDA {
-		unsigned int frameCount = (unsigned int)context->GetVar(String("frameCount")).IntValue();
-		unsigned int sampleRate = (unsigned int)context->GetVar(String("sampleRate")).IntValue();
-		unsigned int sampleSize = (unsigned int)context->GetVar(String("sampleSize")).IntValue();
-		unsigned int channels = (unsigned int)context->GetVar(String("channels")).IntValue();
-		Value samplesVal = context->GetVar(String("samples"));
+		unsigned int frameCount = (unsigned int)ARG("frameCount").IntValue();
+		unsigned int sampleRate = (unsigned int)ARG("sampleRate").IntValue();
+		unsigned int sampleSize = (unsigned int)ARG("sampleSize").IntValue();
+		unsigned int channels = (unsigned int)ARG("channels").IntValue();
+		Value samplesVal = ARG("samples");
 
 		// Validate parameters
 		if (sampleSize != 8 && sampleSize != 16 && sampleSize != 32) {
@@ -158,36 +185,30 @@ void AddRAudioMethods(ValueDict raylibModule) {
 
 		return IntrinsicResult(WaveToValue(wave));
 	};
-	raylibModule.SetValue("CreateWave", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "CreateWave", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("wave");
 	i->code = INTRINSIC_LAMBDA {
-		Wave wave = ValueToWave(context->GetVar(String("wave")));
+		Wave wave = ValueToWave(ARG("wave"));
 		return IntrinsicResult(IsWaveValid(wave));
 	};
-	raylibModule.SetValue("IsWaveValid", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "IsWaveValid", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("wave");
 	i->code = INTRINSIC_LAMBDA {
-		Wave wave = ValueToWave(context->GetVar(String("wave")));
+		Wave wave = ValueToWave(ARG("wave"));
 		UnloadWave(wave);
-		// Also delete the heap-allocated Wave
-		ValueDict map = context->GetVar(String("wave")).GetDict();
-		Value handleVal = map.Lookup(String("_handle"), Value::zero);
-		Wave* wavePtr = (Wave*)(long)handleVal.IntValue();
-		if (wavePtr != nullptr) {
-			delete wavePtr;
-		}
+		ReleaseWave(ARG("wave"));
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("UnloadWave", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "UnloadWave", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("wave");
 	i->code = INTRINSIC_LAMBDA {
-		Wave wave = ValueToWave(context->GetVar(String("wave")));
+		Wave wave = ValueToWave(ARG("wave"));
 		if (!IsWaveValid(wave)) return IntrinsicResult::Null;
 
 		// Load the samples as a float array
@@ -203,12 +224,12 @@ void AddRAudioMethods(ValueDict raylibModule) {
 
 		return IntrinsicResult(RawDataToValue(data));
 	};
-	raylibModule.SetValue("LoadWaveSamples", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "LoadWaveSamples", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("samples");
 	i->code = INTRINSIC_LAMBDA {
-		BinaryData* data = ValueToRawData(context->GetVar(String("samples")));
+		BinaryData* data = ValueToRawData(ARG("samples"));
 		if (data == nullptr) return IntrinsicResult::Null;
 
 		// Get the raw buffer and free it using raylib's UnloadWaveSamples
@@ -224,31 +245,31 @@ void AddRAudioMethods(ValueDict raylibModule) {
 
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("UnloadWaveSamples", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "UnloadWaveSamples", i);
 
 	// Wave manipulation
 
 	i = Intrinsic::Create("");
 	i->AddParam("wave");
 	i->code = INTRINSIC_LAMBDA {
-		Wave wave = ValueToWave(context->GetVar(String("wave")));
+		Wave wave = ValueToWave(ARG("wave"));
 		Wave copy = WaveCopy(wave);
 		return IntrinsicResult(WaveToValue(copy));
 	};
-	raylibModule.SetValue("WaveCopy", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "WaveCopy", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("wave");
 	i->AddParam("initFrame", Value::zero);
 	i->AddParam("finalFrame", Value(100));
 	i->code = INTRINSIC_LAMBDA {
-		Wave wave = ValueToWave(context->GetVar(String("wave")));
-		int initFrame = context->GetVar(String("initFrame")).IntValue();
-		int finalFrame = context->GetVar(String("finalFrame")).IntValue();
+		Wave wave = ValueToWave(ARG("wave"));
+		int initFrame = ARG("initFrame").IntValue();
+		int finalFrame = ARG("finalFrame").IntValue();
 		WaveCrop(&wave, initFrame, finalFrame);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("WaveCrop", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "WaveCrop", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("wave");
@@ -256,300 +277,322 @@ void AddRAudioMethods(ValueDict raylibModule) {
 	i->AddParam("sampleSize", Value(16));
 	i->AddParam("channels", Value(2));
 	i->code = INTRINSIC_LAMBDA {
-		Wave wave = ValueToWave(context->GetVar(String("wave")));
-		int sampleRate = context->GetVar(String("sampleRate")).IntValue();
-		int sampleSize = context->GetVar(String("sampleSize")).IntValue();
-		int channels = context->GetVar(String("channels")).IntValue();
+		Wave wave = ValueToWave(ARG("wave"));
+		int sampleRate = ARG("sampleRate").IntValue();
+		int sampleSize = ARG("sampleSize").IntValue();
+		int channels = ARG("channels").IntValue();
 		WaveFormat(&wave, sampleRate, sampleSize, channels);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("WaveFormat", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "WaveFormat", i);
 
 	// Music loading and control
 
 	i = Intrinsic::Create("");
 	i->AddParam("fileName");
 	i->code = INTRINSIC_LAMBDA {
-		String path = context->GetVar(String("fileName")).ToString();
-		Music music = LoadMusicStream(path.c_str());
-		if (!IsMusicValid(music)) return IntrinsicResult::Null;
-		return IntrinsicResult(MusicToValue(music));
+		String path = ARG("fileName").ToString();
+		if (!WaitForFile(path, partialResult)) return partialResult;
+		// (Music streams from its data as it plays, so that must stay in memory
+		// until the music is unloaded.)
+		int size;
+		const unsigned char *data = GetPreloadedFile(path.c_str(), &size);
+		bool pinned = data && PinPreloadedFile(path.c_str());
+		Music music = data ? LoadMusicStreamFromMemory(GetFileExtension(path.c_str()), data, size)
+			: LoadMusicStream(path.c_str());
+		if (!IsMusicValid(music)) {
+			if (pinned) UnpinPreloadedFile(path.c_str());
+			return IntrinsicResult::Null;
+		}
+		return IntrinsicResult(MusicToValue(music, pinned ? path.c_str() : nullptr));
 	};
-	raylibModule.SetValue("LoadMusicStream", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "LoadMusicStream", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("fileType");
 	i->AddParam("data");
 	i->AddParam("dataSize");
 	i->code = INTRINSIC_LAMBDA {
-		String fileType = context->GetVar(String("fileType")).ToString();
+		String fileType = ARG("fileType").ToString();
 		// Note: This would need a byte array type in MiniScript to be fully useful
 		// For now, we'll skip implementing this
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("LoadMusicStreamFromMemory", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "LoadMusicStreamFromMemory", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("music");
 	i->code = INTRINSIC_LAMBDA {
-		Music music = ValueToMusic(context->GetVar(String("music")));
+		Music music = ValueToMusic(ARG("music"));
 		return IntrinsicResult(IsMusicValid(music));
 	};
-	raylibModule.SetValue("IsMusicValid", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "IsMusicValid", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("music");
 	i->code = INTRINSIC_LAMBDA {
-		Music music = ValueToMusic(context->GetVar(String("music")));
+		Music music = ValueToMusic(ARG("music"));
 		UnloadMusicStream(music);
-		// Also delete the heap-allocated Music
-		ValueDict map = context->GetVar(String("music")).GetDict();
-		Value handleVal = map.Lookup(String("_handle"), Value::zero);
-		Music* musicPtr = (Music*)(long)handleVal.IntValue();
-		if (musicPtr != nullptr) {
-			delete musicPtr;
-		}
+		ReleaseMusic(ARG("music"));
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("UnloadMusicStream", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "UnloadMusicStream", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("music");
 	i->code = INTRINSIC_LAMBDA {
-		Music music = ValueToMusic(context->GetVar(String("music")));
+		Music music = ValueToMusic(ARG("music"));
 		PlayMusicStream(music);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("PlayMusicStream", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "PlayMusicStream", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("music");
 	i->code = INTRINSIC_LAMBDA {
-		Music music = ValueToMusic(context->GetVar(String("music")));
+		Music music = ValueToMusic(ARG("music"));
 		return IntrinsicResult(IsMusicStreamPlaying(music));
 	};
-	raylibModule.SetValue("IsMusicStreamPlaying", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "IsMusicStreamPlaying", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("music");
 	i->code = INTRINSIC_LAMBDA {
-		Music music = ValueToMusic(context->GetVar(String("music")));
+		Music music = ValueToMusic(ARG("music"));
 		UpdateMusicStream(music);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("UpdateMusicStream", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "UpdateMusicStream", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("music");
 	i->code = INTRINSIC_LAMBDA {
-		Music music = ValueToMusic(context->GetVar(String("music")));
+		Music music = ValueToMusic(ARG("music"));
 		StopMusicStream(music);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("StopMusicStream", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "StopMusicStream", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("music");
 	i->code = INTRINSIC_LAMBDA {
-		Music music = ValueToMusic(context->GetVar(String("music")));
+		Music music = ValueToMusic(ARG("music"));
 		PauseMusicStream(music);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("PauseMusicStream", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "PauseMusicStream", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("music");
 	i->code = INTRINSIC_LAMBDA {
-		Music music = ValueToMusic(context->GetVar(String("music")));
+		Music music = ValueToMusic(ARG("music"));
 		ResumeMusicStream(music);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ResumeMusicStream", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ResumeMusicStream", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("music");
 	i->AddParam("position", Value::zero);
 	i->code = INTRINSIC_LAMBDA {
-		Music music = ValueToMusic(context->GetVar(String("music")));
-		float position = context->GetVar(String("position")).FloatValue();
+		Music music = ValueToMusic(ARG("music"));
+		float position = ARG("position").FloatValue();
 		SeekMusicStream(music, position);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("SeekMusicStream", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "SeekMusicStream", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("music");
 	i->AddParam("volume", Value(1.0));
 	i->code = INTRINSIC_LAMBDA {
-		Music music = ValueToMusic(context->GetVar(String("music")));
-		float volume = context->GetVar(String("volume")).FloatValue();
+		Music music = ValueToMusic(ARG("music"));
+		float volume = ARG("volume").FloatValue();
 		SetMusicVolume(music, volume);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("SetMusicVolume", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "SetMusicVolume", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("music");
 	i->AddParam("pitch", Value(1.0));
 	i->code = INTRINSIC_LAMBDA {
-		Music music = ValueToMusic(context->GetVar(String("music")));
-		float pitch = context->GetVar(String("pitch")).FloatValue();
+		Music music = ValueToMusic(ARG("music"));
+		float pitch = ARG("pitch").FloatValue();
 		SetMusicPitch(music, pitch);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("SetMusicPitch", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "SetMusicPitch", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("music");
 	i->AddParam("pan", Value(0.5));
 	i->code = INTRINSIC_LAMBDA {
-		Music music = ValueToMusic(context->GetVar(String("music")));
-		float pan = context->GetVar(String("pan")).FloatValue();
+		Music music = ValueToMusic(ARG("music"));
+		float pan = ARG("pan").FloatValue();
 		SetMusicPan(music, pan);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("SetMusicPan", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "SetMusicPan", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("music");
 	i->code = INTRINSIC_LAMBDA {
-		Music music = ValueToMusic(context->GetVar(String("music")));
+		Music music = ValueToMusic(ARG("music"));
 		float length = GetMusicTimeLength(music);
 		return IntrinsicResult(Value(length));
 	};
-	raylibModule.SetValue("GetMusicTimeLength", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetMusicTimeLength", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("music");
 	i->code = INTRINSIC_LAMBDA {
-		Music music = ValueToMusic(context->GetVar(String("music")));
+		Music music = ValueToMusic(ARG("music"));
 		float timePlayed = GetMusicTimePlayed(music);
 		return IntrinsicResult(Value(timePlayed));
 	};
-	raylibModule.SetValue("GetMusicTimePlayed", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetMusicTimePlayed", i);
 
 	// Sound loading and control
 
 	i = Intrinsic::Create("");
 	i->AddParam("fileName");
 	i->code = INTRINSIC_LAMBDA {
-		String path = context->GetVar(String("fileName")).ToString();
-		Sound sound = LoadSound(path.c_str());
+		String path = ARG("fileName").ToString();
+		if (!WaitForFile(path, partialResult)) return partialResult;
+		Sound sound;
+		int size;
+		if (GetPreloadedFile(path.c_str(), &size)) {
+			Wave wave = LoadWavePreloaded(path.c_str());
+			sound = LoadSoundFromWave(wave);
+			UnloadWave(wave);
+		} else {
+			sound = LoadSound(path.c_str());
+		}
 		if (!IsSoundValid(sound)) return IntrinsicResult::Null;
 		return IntrinsicResult(SoundToValue(sound));
 	};
-	raylibModule.SetValue("LoadSound", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "LoadSound", i);
+
+	i = Intrinsic::Create("");
+	i->AddParam("fileName");
+	i->code = INTRINSIC_LAMBDA {
+		String path = ARG("fileName").ToString();
+		const char *ext = GetFileExtension(path.c_str());
+		String fileType = ext ? ext : "";
+		long handle = StartAsyncLoad(path.c_str(), [fileType](const unsigned char *data, int size) -> Value {
+			Wave wave = LoadWaveFromMemory(fileType.c_str(), data, size);
+			if (!IsWaveValid(wave)) return Value::null;
+			Sound sound = LoadSoundFromWave(wave);
+			UnloadWave(wave);
+			if (!IsSoundValid(sound)) return Value::null;
+			return SoundToValue(sound);
+		});
+		return IntrinsicResult(Value((double)handle));
+	};
+	RegisterIntrinsic(raylibModule, "LoadSoundAsync", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("wave");
 	i->code = INTRINSIC_LAMBDA {
-		Wave wave = ValueToWave(context->GetVar(String("wave")));
+		Wave wave = ValueToWave(ARG("wave"));
 		Sound sound = LoadSoundFromWave(wave);
 		return IntrinsicResult(SoundToValue(sound));
 	};
-	raylibModule.SetValue("LoadSoundFromWave", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "LoadSoundFromWave", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("source");
 	i->code = INTRINSIC_LAMBDA {
-		Sound source = ValueToSound(context->GetVar(String("source")));
+		Sound source = ValueToSound(ARG("source"));
 		Sound alias = LoadSoundAlias(source);
-		return IntrinsicResult(SoundToValue(alias));
+		Value result = SoundToValue(alias, true);
+		// Keep the source (whose data the alias uses) loaded as long as the alias
+		result.GetDict().SetValue(String("_source"), ARG("source"));
+		return IntrinsicResult(result);
 	};
-	raylibModule.SetValue("LoadSoundAlias", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "LoadSoundAlias", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("sound");
 	i->code = INTRINSIC_LAMBDA {
-		Sound sound = ValueToSound(context->GetVar(String("sound")));
+		Sound sound = ValueToSound(ARG("sound"));
 		return IntrinsicResult(IsSoundValid(sound));
 	};
-	raylibModule.SetValue("IsSoundValid", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "IsSoundValid", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("sound");
 	i->code = INTRINSIC_LAMBDA {
-		Sound sound = ValueToSound(context->GetVar(String("sound")));
+		Sound sound = ValueToSound(ARG("sound"));
 		UnloadSound(sound);
-		// Also delete the heap-allocated Sound
-		ValueDict map = context->GetVar(String("sound")).GetDict();
-		Value handleVal = map.Lookup(String("_handle"), Value::zero);
-		Sound* soundPtr = (Sound*)(long)handleVal.IntValue();
-		if (soundPtr != nullptr) {
-			delete soundPtr;
-		}
+		ReleaseSound(ARG("sound"));
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("UnloadSound", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "UnloadSound", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("alias");
 	i->code = INTRINSIC_LAMBDA {
-		Sound alias = ValueToSound(context->GetVar(String("alias")));
+		Sound alias = ValueToSound(ARG("alias"));
 		UnloadSoundAlias(alias);
-		// Also delete the heap-allocated Sound
-		ValueDict map = context->GetVar(String("alias")).GetDict();
-		Value handleVal = map.Lookup(String("_handle"), Value::zero);
-		Sound* soundPtr = (Sound*)(long)handleVal.IntValue();
-		if (soundPtr != nullptr) {
-			delete soundPtr;
-		}
+		ReleaseSound(ARG("alias"));
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("UnloadSoundAlias", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "UnloadSoundAlias", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("sound");
 	i->code = INTRINSIC_LAMBDA {
-		Sound sound = ValueToSound(context->GetVar(String("sound")));
+		Sound sound = ValueToSound(ARG("sound"));
 		PlaySound(sound);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("PlaySound", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "PlaySound", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("sound");
 	i->code = INTRINSIC_LAMBDA {
-		Sound sound = ValueToSound(context->GetVar(String("sound")));
+		Sound sound = ValueToSound(ARG("sound"));
 		StopSound(sound);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("StopSound", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "StopSound", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("sound");
 	i->code = INTRINSIC_LAMBDA {
-		Sound sound = ValueToSound(context->GetVar(String("sound")));
+		Sound sound = ValueToSound(ARG("sound"));
 		PauseSound(sound);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("PauseSound", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "PauseSound", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("sound");
 	i->code = INTRINSIC_LAMBDA {
-		Sound sound = ValueToSound(context->GetVar(String("sound")));
+		Sound sound = ValueToSound(ARG("sound"));
 		ResumeSound(sound);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ResumeSound", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ResumeSound", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("sound");
 	i->code = INTRINSIC_LAMBDA {
-		Sound sound = ValueToSound(context->GetVar(String("sound")));
+		Sound sound = ValueToSound(ARG("sound"));
 		return IntrinsicResult(IsSoundPlaying(sound));
 	};
-	raylibModule.SetValue("IsSoundPlaying", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "IsSoundPlaying", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("sound");
 	i->AddParam("data");
 	i->AddParam("sampleCount");
 	i->code = INTRINSIC_LAMBDA {
-		Sound sound = ValueToSound(context->GetVar(String("sound")));
-		BinaryData* data = ValueToRawData(context->GetVar(String("data")));
-		int sampleCount = context->GetVar(String("sampleCount")).IntValue();
+		Sound sound = ValueToSound(ARG("sound"));
+		BinaryData* data = ValueToRawData(ARG("data"));
+		int sampleCount = ARG("sampleCount").IntValue();
 
 		if (data == nullptr || data->bytes == nullptr) {
 			RuntimeException("UpdateSound: RawData required for data parameter").raise();
@@ -564,40 +607,40 @@ void AddRAudioMethods(ValueDict raylibModule) {
 
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("UpdateSound", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "UpdateSound", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("sound");
 	i->AddParam("volume", Value(1.0));
 	i->code = INTRINSIC_LAMBDA {
-		Sound sound = ValueToSound(context->GetVar(String("sound")));
-		float volume = context->GetVar(String("volume")).FloatValue();
+		Sound sound = ValueToSound(ARG("sound"));
+		float volume = ARG("volume").FloatValue();
 		SetSoundVolume(sound, volume);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("SetSoundVolume", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "SetSoundVolume", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("sound");
 	i->AddParam("pitch", Value(1.0));
 	i->code = INTRINSIC_LAMBDA {
-		Sound sound = ValueToSound(context->GetVar(String("sound")));
-		float pitch = context->GetVar(String("pitch")).FloatValue();
+		Sound sound = ValueToSound(ARG("sound"));
+		float pitch = ARG("pitch").FloatValue();
 		SetSoundPitch(sound, pitch);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("SetSoundPitch", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "SetSoundPitch", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("sound");
 	i->AddParam("pan", Value(0.5));
 	i->code = INTRINSIC_LAMBDA {
-		Sound sound = ValueToSound(context->GetVar(String("sound")));
-		float pan = context->GetVar(String("pan")).FloatValue();
+		Sound sound = ValueToSound(ARG("sound"));
+		float pan = ARG("pan").FloatValue();
 		SetSoundPan(sound, pan);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("SetSoundPan", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "SetSoundPan", i);
 
 	// AudioStream management
 
@@ -606,41 +649,35 @@ void AddRAudioMethods(ValueDict raylibModule) {
 	i->AddParam("sampleSize", Value(32));
 	i->AddParam("channels", Value(1));
 	i->code = INTRINSIC_LAMBDA {
-		AudioStream stream = LoadAudioStream(context->GetVar(String("sampleRate")).IntValue(), context->GetVar(String("sampleSize")).IntValue(), context->GetVar(String("channels")).IntValue());
+		AudioStream stream = LoadAudioStream(ARG("sampleRate").IntValue(), ARG("sampleSize").IntValue(), ARG("channels").IntValue());
 		return IntrinsicResult(AudioStreamToValue(stream));
 	};
-	raylibModule.SetValue("LoadAudioStream", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "LoadAudioStream", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("stream");
 	i->code = INTRINSIC_LAMBDA {
-		AudioStream stream = ValueToAudioStream(context->GetVar(String("stream")));
+		AudioStream stream = ValueToAudioStream(ARG("stream"));
 		return IntrinsicResult(IsAudioStreamValid(stream));
 	};
-	raylibModule.SetValue("IsAudioStreamValid", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "IsAudioStreamValid", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("stream");
 	i->code = INTRINSIC_LAMBDA {
-		AudioStream stream = ValueToAudioStream(context->GetVar(String("stream")));
+		AudioStream stream = ValueToAudioStream(ARG("stream"));
 		UnloadAudioStream(stream);
-		// Also delete the heap-allocated AudioStream
-		ValueDict map = context->GetVar(String("stream")).GetDict();
-		Value handleVal = map.Lookup(String("_handle"), Value::zero);
-		AudioStream* streamPtr = (AudioStream*)(long)handleVal.IntValue();
-		if (streamPtr != nullptr) {
-			delete streamPtr;
-		}
+		ReleaseAudioStream(ARG("stream"));
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("UnloadAudioStream", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "UnloadAudioStream", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("stream");
 	i->AddParam("data");
 	i->code = INTRINSIC_LAMBDA {
-		AudioStream stream = ValueToAudioStream(context->GetVar(String("stream")));
-		ValueList data = context->GetVar(String("data")).GetList();
+		AudioStream stream = ValueToAudioStream(ARG("stream"));
+		ValueList data = ARG("data").GetList();
 
 #define PROCESS_DATA(TYPE, VALUE) \
 		TYPE *buffer = new TYPE[data.Count()]; \
@@ -661,99 +698,99 @@ void AddRAudioMethods(ValueDict raylibModule) {
 
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("UpdateAudioStream", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "UpdateAudioStream", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("stream");
 	i->code = INTRINSIC_LAMBDA {
-		AudioStream stream = ValueToAudioStream(context->GetVar(String("stream")));
+		AudioStream stream = ValueToAudioStream(ARG("stream"));
 		return IntrinsicResult(IsAudioStreamProcessed(stream));
 	};
-	raylibModule.SetValue("IsAudioStreamProcessed", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "IsAudioStreamProcessed", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("stream");
 	i->code = INTRINSIC_LAMBDA {
-		AudioStream stream = ValueToAudioStream(context->GetVar(String("stream")));
+		AudioStream stream = ValueToAudioStream(ARG("stream"));
 		PlayAudioStream(stream);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("PlayAudioStream", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "PlayAudioStream", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("stream");
 	i->code = INTRINSIC_LAMBDA {
-		AudioStream stream = ValueToAudioStream(context->GetVar(String("stream")));
+		AudioStream stream = ValueToAudioStream(ARG("stream"));
 		PauseAudioStream(stream);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("PauseAudioStream", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "PauseAudioStream", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("stream");
 	i->code = INTRINSIC_LAMBDA {
-		AudioStream stream = ValueToAudioStream(context->GetVar(String("stream")));
+		AudioStream stream = ValueToAudioStream(ARG("stream"));
 		ResumeAudioStream(stream);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ResumeAudioStream", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ResumeAudioStream", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("stream");
 	i->code = INTRINSIC_LAMBDA {
-		AudioStream stream = ValueToAudioStream(context->GetVar(String("stream")));
+		AudioStream stream = ValueToAudioStream(ARG("stream"));
 		return IntrinsicResult(IsAudioStreamPlaying(stream));
 	};
-	raylibModule.SetValue("IsAudioStreamPlaying", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "IsAudioStreamPlaying", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("stream");
 	i->code = INTRINSIC_LAMBDA {
-		AudioStream stream = ValueToAudioStream(context->GetVar(String("stream")));
+		AudioStream stream = ValueToAudioStream(ARG("stream"));
 		StopAudioStream(stream);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("StopAudioStream", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "StopAudioStream", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("stream");
 	i->AddParam("volume", Value(1.0));
 	i->code = INTRINSIC_LAMBDA {
-		AudioStream stream = ValueToAudioStream(context->GetVar(String("stream")));
-		float volume = context->GetVar(String("volume")).FloatValue();
+		AudioStream stream = ValueToAudioStream(ARG("stream"));
+		float volume = ARG("volume").FloatValue();
 		SetAudioStreamVolume(stream, volume);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("SetAudioStreamVolume", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "SetAudioStreamVolume", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("stream");
 	i->AddParam("pitch", Value(1.0));
 	i->code = INTRINSIC_LAMBDA {
-		AudioStream stream = ValueToAudioStream(context->GetVar(String("stream")));
-		float pitch = context->GetVar(String("pitch")).FloatValue();
+		AudioStream stream = ValueToAudioStream(ARG("stream"));
+		float pitch = ARG("pitch").FloatValue();
 		SetAudioStreamPitch(stream, pitch);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("SetAudioStreamPitch", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "SetAudioStreamPitch", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("stream");
 	i->AddParam("pan", Value(0.5));
 	i->code = INTRINSIC_LAMBDA {
-		AudioStream stream = ValueToAudioStream(context->GetVar(String("stream")));
-		float pan = context->GetVar(String("pan")).FloatValue();
+		AudioStream stream = ValueToAudioStream(ARG("stream"));
+		float pan = ARG("pan").FloatValue();
 		SetAudioStreamPan(stream, pan);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("SetAudioStreamPan", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "SetAudioStreamPan", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("size", Value(4096));
 	i->code = INTRINSIC_LAMBDA {
-		int size = context->GetVar(String("size")).IntValue();
+		int size = ARG("size").IntValue();
 		SetAudioStreamBufferSizeDefault(size);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("SetAudioStreamBufferSizeDefault", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "SetAudioStreamBufferSizeDefault", i);
 }
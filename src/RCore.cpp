@@ -8,14 +8,27 @@
 #include "RaylibIntrinsics.h"
 #include "RaylibTypes.h"
 #include "RawData.h"
+#include "scheduler.h"
+#include "framestats.h"
+#include "profiler.h"
+#include "trace.h"
+#include "hud.h"
+#include "benchmark.h"
+#include "loadfile.h"
+#include "asyncload.h"
 #include "raylib.h"
 #include "MiniscriptInterpreter.h"
 #include "MiniscriptTypes.h"
-#include <emscripten.h>
 #include "macros.h"
 
+#ifdef PLATFORM_WEB
+#include <emscripten.h>
+#endif
+
 using namespace MiniScript;
 
+#ifdef PLATFORM_WEB
+
 // Helper: Set window title
 EM_JS(void, _SetWindowTitle, (const char *title), {
 	const _title = UTF8ToString(title);
@@ -24,29 +37,60 @@ EM_JS(void, _SetWindowTitle, (const char *title), {
 });
 
 // Helper: Set window icon
-// We need to free the buffer after we're done with it so this function won't
-// return until after it's done.
-EM_ASYNC_JS(void, _SetWindowIcon, (unsigned char *data, long size), {
-	await new Promise((resolve, reject)=>{
-		const _data = new Uint8Array(HEAP8.buffer, data, size);
-		const blob = new Blob([_data], {type:"image/png"});
-		const reader = new FileReader();
-		reader.onloadend = () => {
-			const dataURL = reader.result;
-			let link = document.querySelector('link[rel="icon"]');
-			if (link===null) {
-				link = document.createElement("link");
-				link.setAttribute("rel", "icon");
-				document.head.appendChild(link);
-			}
-			link.href = dataURL;
-			resolve();
-		};
-		reader.onerror = reject;
-		reader.readAsDataURL(blob);
-	});
+// We copy the image data before returning, so the caller can free the buffer
+// right away (the rest happens asynchronously).
+EM_JS(void, _SetWindowIcon, (unsigned char *data, long size), {
+	const blob = new Blob([HEAPU8.slice(data, data + size)], {type:"image/png"});
+	const reader = new FileReader();
+	reader.onloadend = () => {
+		const dataURL = reader.result;
+		let link = document.querySelector('link[rel="icon"]');
+		if (link===null) {
+			link = document.createElement("link");
+			link.setAttribute("rel", "icon");
+			document.head.appendChild(link);
+		}
+		link.href = dataURL;
+	};
+	reader.readAsDataURL(blob);
 });
 
+#else
+
+// Native build: the window has a real title bar and icon
+static void _SetWindowTitle(const char *title) {
+	SetWindowTitle(title);
+}
+
+static void _SetWindowIcon(unsigned char *data, long size) {
+	Image icon = LoadImageFromMemory(".png", data, (int)size);
+	SetWindowIcon(icon);
+	UnloadImage(icon);
+}
+
+#endif // PLATFORM_WEB
+
+// When the script called BeginDrawing (for tracing), and whether it has
+// called EndDrawing since
+static double drawingStartTime = 0;
+static bool drawingFrame = false;
+static long framesDrawn = 0;		// (ids for the "draw" trace events)
+
+// The current blend mode.  rlgl draws the render batch only when the mode
+// actually changes, and can't tell us what it is, so we keep track.
+static int blendMode = BLEND_ALPHA;
+
+// Change the blend mode, counting the batch first if that will draw it
+static void ChangeBlendMode(int mode) {
+	if (mode == blendMode) return;
+	NoteRenderBatch();
+	blendMode = mode;
+}
+
+bool IsDrawingFrame() {
+	return drawingFrame;
+}
+
 void AddRCoreMethods(ValueDict raylibModule) {
 	Intrinsic *i;
 
@@ -55,197 +99,236 @@ void AddRCoreMethods(ValueDict raylibModule) {
 	i = Intrinsic::Create("");
 	i->code = INTRINSIC_LAMBDA {
 		BeginDrawing();
+		drawingStartTime = GetTime();
+		drawingFrame = true;
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("BeginDrawing", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "BeginDrawing", i);
 
 	i = Intrinsic::Create("");
 	i->code = INTRINSIC_LAMBDA {
+		NoteRenderBatch();
+		DrawPerfHUD();		// (after counting the batch, so the HUD isn't in its own counts)
+		double startTime = GetTime();
 		EndDrawing();
+		double endTime = GetTime();
+		NoteRenderTime(endTime - startTime);
+		drawingFrame = false;
+		UnloadDroppedResources();	// (now that the batch is drawn)
+		framesDrawn++;
+		if (tracing) {
+			// (BeginDrawing may have been in an earlier VM slice, so this can
+			// overlap "vm" events without nesting in them; hence an async pair.)
+			TraceAsyncBegin("draw", "frame", framesDrawn, drawingStartTime);
+			TraceAsyncEnd("draw", "frame", framesDrawn, endTime);
+			TraceComplete("EndDrawing", "frame", startTime, endTime);
+		}
+		SchedulerNoteFrameDrawn(context->vm);
+		StartupStats& startup = GetStartupStats();
+		if (startup.firstFrameTime == 0) startup.firstFrameTime = GetTime();
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("EndDrawing", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "EndDrawing", i);
 
 	i = Intrinsic::Create("");
-	i->AddParam("color", ColorToValue(BLACK));
+	i->AddParam("color", DefaultColorValue(BLACK));
 	i->code = INTRINSIC_LAMBDA {
-		Value colorVal = context->GetVar(String("color"));
+		Value colorVal = ARG("color");
 		Color color = ValueToColor(colorVal);
 		ClearBackground(color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ClearBackground", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ClearBackground", i);
 
 	// Timing functions
 
 	i = Intrinsic::Create("");
 	i->AddParam("fps");
 	i->code = INTRINSIC_LAMBDA {
-		SetTargetFPS(context->GetVar(String("fps")).IntValue());
+		int fps = ARG("fps").IntValue();
+		if (!IsBenchmarking()) SetTargetFPS(fps);	// (benchmarks run flat out)
+		SchedulerSetTargetFPS(fps);
+		return IntrinsicResult::Null;
+	};
+	RegisterIntrinsic(raylibModule, "SetTargetFPS", i);
+
+	// MSRLWeb extension: choose whether EndDrawing also ends the script's frame
+	i = Intrinsic::Create("");
+	i->AddParam("mode", FRAME_PACING_END_DRAWING);
+	i->code = INTRINSIC_LAMBDA {
+		SchedulerSetFramePacing(ARG("mode").IntValue());
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("SetTargetFPS", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "SetFramePacing", i);
 
 	i = Intrinsic::Create("");
 	i->code = INTRINSIC_LAMBDA {
+		return IntrinsicResult(SchedulerGetFramePacing());
+	};
+	RegisterIntrinsic(raylibModule, "GetFramePacing", i);
+
+	i = Intrinsic::Create("");
+	i->code = INTRINSIC_LAMBDA {
+		// (In benchmark mode, every frame is the same length.)
+		if (IsBenchmarking()) return IntrinsicResult(GetBenchmarkTimestep());
 		return IntrinsicResult(GetFrameTime());
 	};
-	raylibModule.SetValue("GetFrameTime", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetFrameTime", i);
 
 	i = Intrinsic::Create("");
 	i->code = INTRINSIC_LAMBDA {
 		return IntrinsicResult(GetTime());
 	};
-	raylibModule.SetValue("GetTime", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetTime", i);
 
 	i = Intrinsic::Create("");
 	i->code = INTRINSIC_LAMBDA {
 		return IntrinsicResult(GetFPS());
 	};
-	raylibModule.SetValue("GetFPS", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetFPS", i);
 
 	// Input-related functions: keyboard
 
 	i = Intrinsic::Create("");
 	i->AddParam("key");
 	i->code = INTRINSIC_LAMBDA {
-		return IntrinsicResult(IsKeyPressed(context->GetVar(String("key")).IntValue()));
+		return IntrinsicResult(IsKeyPressed(ARG("key").IntValue()));
 	};
-	raylibModule.SetValue("IsKeyPressed", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "IsKeyPressed", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("key");
 	i->code = INTRINSIC_LAMBDA {
-		return IntrinsicResult(IsKeyPressedRepeat(context->GetVar(String("key")).IntValue()));
+		return IntrinsicResult(IsKeyPressedRepeat(ARG("key").IntValue()));
 	};
-	raylibModule.SetValue("IsKeyPressedRepeat", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "IsKeyPressedRepeat", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("key");
 	i->code = INTRINSIC_LAMBDA {
-		return IntrinsicResult(IsKeyDown(context->GetVar(String("key")).IntValue()));
+		return IntrinsicResult(IsKeyDown(ARG("key").IntValue()));
 	};
-	raylibModule.SetValue("IsKeyDown", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "IsKeyDown", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("key");
 	i->code = INTRINSIC_LAMBDA {
-		return IntrinsicResult(IsKeyReleased(context->GetVar(String("key")).IntValue()));
+		return IntrinsicResult(IsKeyReleased(ARG("key").IntValue()));
 	};
-	raylibModule.SetValue("IsKeyReleased", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "IsKeyReleased", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("key");
 	i->code = INTRINSIC_LAMBDA {
-		return IntrinsicResult(IsKeyUp(context->GetVar(String("key")).IntValue()));
+		return IntrinsicResult(IsKeyUp(ARG("key").IntValue()));
 	};
-	raylibModule.SetValue("IsKeyUp", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "IsKeyUp", i);
 
 	i = Intrinsic::Create("");
 	i->code = INTRINSIC_LAMBDA {
 		return IntrinsicResult(GetKeyPressed());
 	};
-	raylibModule.SetValue("GetKeyPressed", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetKeyPressed", i);
 
 	i = Intrinsic::Create("");
 	i->code = INTRINSIC_LAMBDA {
 		return IntrinsicResult(GetCharPressed());
 	};
-	raylibModule.SetValue("GetCharPressed", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetCharPressed", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("key");
 	i->code = INTRINSIC_LAMBDA {
-		SetExitKey(context->GetVar(String("key")).IntValue());
+		SetExitKey(ARG("key").IntValue());
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("SetExitKey", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "SetExitKey", i);
 
 	// Input-related functions: gamepad
 
 	i = Intrinsic::Create("");
 	i->AddParam("gamepad", 0);
 	i->code = INTRINSIC_LAMBDA {
-		return IntrinsicResult(IsGamepadAvailable(context->GetVar(String("gamepad")).IntValue()));
+		return IntrinsicResult(IsGamepadAvailable(ARG("gamepad").IntValue()));
 	};
-	raylibModule.SetValue("IsGamepadAvailable", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "IsGamepadAvailable", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("gamepad", 0);
 	i->code = INTRINSIC_LAMBDA {
-		return IntrinsicResult(GetGamepadName(context->GetVar(String("gamepad")).IntValue()));
+		return IntrinsicResult(GetGamepadName(ARG("gamepad").IntValue()));
 	};
-	raylibModule.SetValue("GetGamepadName", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetGamepadName", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("gamepad", 0);
 	i->AddParam("button");
 	i->code = INTRINSIC_LAMBDA {
 		return IntrinsicResult(IsGamepadButtonPressed(
-			context->GetVar(String("gamepad")).IntValue(),
-			context->GetVar(String("button")).IntValue()));
+			ARG("gamepad").IntValue(),
+			ARG("button").IntValue()));
 	};
-	raylibModule.SetValue("IsGamepadButtonPressed", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "IsGamepadButtonPressed", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("gamepad", 0);
 	i->AddParam("button");
 	i->code = INTRINSIC_LAMBDA {
 		return IntrinsicResult(IsGamepadButtonDown(
-			context->GetVar(String("gamepad")).IntValue(),
-			context->GetVar(String("button")).IntValue()));
+			ARG("gamepad").IntValue(),
+			ARG("button").IntValue()));
 	};
-	raylibModule.SetValue("IsGamepadButtonDown", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "IsGamepadButtonDown", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("gamepad", 0);
 	i->AddParam("button");
 	i->code = INTRINSIC_LAMBDA {
 		return IntrinsicResult(IsGamepadButtonReleased(
-			context->GetVar(String("gamepad")).IntValue(),
-			context->GetVar(String("button")).IntValue()));
+			ARG("gamepad").IntValue(),
+			ARG("button").IntValue()));
 	};
-	raylibModule.SetValue("IsGamepadButtonReleased", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "IsGamepadButtonReleased", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("gamepad", 0);
 	i->AddParam("button");
 	i->code = INTRINSIC_LAMBDA {
 		return IntrinsicResult(IsGamepadButtonUp(
-			context->GetVar(String("gamepad")).IntValue(),
-			context->GetVar(String("button")).IntValue()));
+			ARG("gamepad").IntValue(),
+			ARG("button").IntValue()));
 	};
-	raylibModule.SetValue("IsGamepadButtonUp", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "IsGamepadButtonUp", i);
 
 	i = Intrinsic::Create("");
 	i->code = INTRINSIC_LAMBDA {
 		return IntrinsicResult(GetGamepadButtonPressed());
 	};
-	raylibModule.SetValue("GetGamepadButtonPressed", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetGamepadButtonPressed", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("gamepad", 0);
 	i->code = INTRINSIC_LAMBDA {
-		return IntrinsicResult(GetGamepadAxisCount(context->GetVar(String("gamepad")).IntValue()));
+		return IntrinsicResult(GetGamepadAxisCount(ARG("gamepad").IntValue()));
 	};
-	raylibModule.SetValue("GetGamepadAxisCount", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetGamepadAxisCount", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("gamepad", 0);
 	i->AddParam("axis");
 	i->code = INTRINSIC_LAMBDA {
 		return IntrinsicResult(GetGamepadAxisMovement(
-			context->GetVar(String("gamepad")).IntValue(),
-			context->GetVar(String("axis")).IntValue()));
+			ARG("gamepad").IntValue(),
+			ARG("axis").IntValue()));
 	};
-	raylibModule.SetValue("GetGamepadAxisMovement", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetGamepadAxisMovement", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("mappings");
 	i->code = INTRINSIC_LAMBDA {
-		return IntrinsicResult(SetGamepadMappings(context->GetVar(String("mappings")).ToString().c_str()));
+		return IntrinsicResult(SetGamepadMappings(ARG("mappings").ToString().c_str()));
 	};
-	raylibModule.SetValue("SetGamepadMappings", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "SetGamepadMappings", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("gamepad", 0);
@@ -254,137 +337,133 @@ void AddRCoreMethods(ValueDict raylibModule) {
 	i->AddParam("duration", 0.0);
 	i->code = INTRINSIC_LAMBDA {
 		SetGamepadVibration(
-			context->GetVar(String("gamepad")).IntValue(),
-			context->GetVar(String("leftMotor")).FloatValue(),
-			context->GetVar(String("rightMotor")).FloatValue(),
-			context->GetVar(String("duration")).FloatValue());
+			ARG("gamepad").IntValue(),
+			ARG("leftMotor").FloatValue(),
+			ARG("rightMotor").FloatValue(),
+			ARG("duration").FloatValue());
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("SetGamepadVibration", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "SetGamepadVibration", i);
 
 	// Input-related functions: mouse
 
 	i = Intrinsic::Create("");
 	i->AddParam("button");
 	i->code = INTRINSIC_LAMBDA {
-		return IntrinsicResult(IsMouseButtonPressed(context->GetVar(String("button")).IntValue()));
+		return IntrinsicResult(IsMouseButtonPressed(ARG("button").IntValue()));
 	};
-	raylibModule.SetValue("IsMouseButtonPressed", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "IsMouseButtonPressed", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("button");
 	i->code = INTRINSIC_LAMBDA {
-		return IntrinsicResult(IsMouseButtonDown(context->GetVar(String("button")).IntValue()));
+		return IntrinsicResult(IsMouseButtonDown(ARG("button").IntValue()));
 	};
-	raylibModule.SetValue("IsMouseButtonDown", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "IsMouseButtonDown", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("button");
 	i->code = INTRINSIC_LAMBDA {
-		return IntrinsicResult(IsMouseButtonReleased(context->GetVar(String("button")).IntValue()));
+		return IntrinsicResult(IsMouseButtonReleased(ARG("button").IntValue()));
 	};
-	raylibModule.SetValue("IsMouseButtonReleased", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "IsMouseButtonReleased", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("button");
 	i->code = INTRINSIC_LAMBDA {
-		return IntrinsicResult(IsMouseButtonUp(context->GetVar(String("button")).IntValue()));
+		return IntrinsicResult(IsMouseButtonUp(ARG("button").IntValue()));
 	};
-	raylibModule.SetValue("IsMouseButtonUp", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "IsMouseButtonUp", i);
 
 	i = Intrinsic::Create("");
 	i->code = INTRINSIC_LAMBDA {
 		return IntrinsicResult(GetMouseX());
 	};
-	raylibModule.SetValue("GetMouseX", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetMouseX", i);
 
 	i = Intrinsic::Create("");
 	i->code = INTRINSIC_LAMBDA {
 		return IntrinsicResult(GetMouseY());
 	};
-	raylibModule.SetValue("GetMouseY", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetMouseY", i);
 
 	i = Intrinsic::Create("");
+	i->AddParam("into");
 	i->code = INTRINSIC_LAMBDA {
 		Vector2 pos = GetMousePosition();
-		ValueDict posMap;
-		posMap.SetValue(String("x"), Value(pos.x));
-		posMap.SetValue(String("y"), Value(pos.y));
-		return IntrinsicResult(posMap);
+		return IntrinsicResult(Vector2ToValue(pos, ARG("into")));
 	};
-	raylibModule.SetValue("GetMousePosition", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetMousePosition", i);
 
 	i = Intrinsic::Create("");
+	i->AddParam("into");
 	i->code = INTRINSIC_LAMBDA {
 		Vector2 delta = GetMouseDelta();
-		ValueDict deltaMap;
-		deltaMap.SetValue(String("x"), Value(delta.x));
-		deltaMap.SetValue(String("y"), Value(delta.y));
-		return IntrinsicResult(deltaMap);
+		return IntrinsicResult(Vector2ToValue(delta, ARG("into")));
 	};
-	raylibModule.SetValue("GetMouseDelta", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetMouseDelta", i);
 
 	i = Intrinsic::Create("");
 	i->code = INTRINSIC_LAMBDA {
 		return IntrinsicResult(GetMouseWheelMove());
 	};
-	raylibModule.SetValue("GetMouseWheelMove", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetMouseWheelMove", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("cursor");
 	i->code = INTRINSIC_LAMBDA {
-		SetMouseCursor(context->GetVar(String("cursor")).IntValue());
+		SetMouseCursor(ARG("cursor").IntValue());
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("SetMouseCursor", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "SetMouseCursor", i);
 
 	i = Intrinsic::Create("");
 	i->code = INTRINSIC_LAMBDA {
 		ShowCursor();
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ShowCursor", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ShowCursor", i);
 
 	i = Intrinsic::Create("");
 	i->code = INTRINSIC_LAMBDA {
 		HideCursor();
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("HideCursor", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "HideCursor", i);
 
 	i = Intrinsic::Create("");
 	i->code = INTRINSIC_LAMBDA {
 		return IntrinsicResult(IsCursorHidden());
 	};
-	raylibModule.SetValue("IsCursorHidden", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "IsCursorHidden", i);
 
 	i = Intrinsic::Create("");
 	i->code = INTRINSIC_LAMBDA {
 		return IntrinsicResult(IsCursorOnScreen());
 	};
-	raylibModule.SetValue("IsCursorOnScreen", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "IsCursorOnScreen", i);
 
 	// Set window title/icon
 	i = Intrinsic::Create("");
 	i->AddParam("caption", "MSRLWeb - MiniScript + Raylib");
 	i->code = INTRINSIC_LAMBDA {
-		String caption = context->GetVar(String("caption")).GetString();
+		String caption = ARG("caption").GetString();
 		_SetWindowTitle(caption.c_str());
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("SetWindowTitle", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "SetWindowTitle", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("image");
 	i->code = INTRINSIC_LAMBDA {
-		Image image = ValueToImage(context->GetVar(String("image")));
+		Image image = ValueToImage(ARG("image"));
 		int size;
 		unsigned char *data = ExportImageToMemory(image, ".png", &size);
 		_SetWindowIcon(data, size);
 		free(data);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("SetWindowIcon", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "SetWindowIcon", i);
 
 	// Screen dimension functions
 
@@ -392,25 +471,25 @@ void AddRCoreMethods(ValueDict raylibModule) {
 	i->code = INTRINSIC_LAMBDA {
 		return IntrinsicResult(GetScreenWidth());
 	};
-	raylibModule.SetValue("GetScreenWidth", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetScreenWidth", i);
 
 	i = Intrinsic::Create("");
 	i->code = INTRINSIC_LAMBDA {
 		return IntrinsicResult(GetScreenHeight());
 	};
-	raylibModule.SetValue("GetScreenHeight", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetScreenHeight", i);
 
 	i = Intrinsic::Create("");
 	i->code = INTRINSIC_LAMBDA {
 		return IntrinsicResult(GetRenderWidth());
 	};
-	raylibModule.SetValue("GetRenderWidth", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetRenderWidth", i);
 
 	i = Intrinsic::Create("");
 	i->code = INTRINSIC_LAMBDA {
 		return IntrinsicResult(GetRenderHeight());
 	};
-	raylibModule.SetValue("GetRenderHeight", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetRenderHeight", i);
 
 	// Window state functions
 
@@ -418,72 +497,70 @@ void AddRCoreMethods(ValueDict raylibModule) {
 	i->code = INTRINSIC_LAMBDA {
 		return IntrinsicResult(IsWindowFocused());
 	};
-	raylibModule.SetValue("IsWindowFocused", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "IsWindowFocused", i);
 
 	i = Intrinsic::Create("");
 	i->code = INTRINSIC_LAMBDA {
 		return IntrinsicResult(IsWindowReady());
 	};
-	raylibModule.SetValue("IsWindowReady", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "IsWindowReady", i);
 
 	// Additional mouse functions
 
 	i = Intrinsic::Create("");
+	i->AddParam("into");
 	i->code = INTRINSIC_LAMBDA {
 		Vector2 wheelMove = GetMouseWheelMoveV();
-		ValueDict wheelMap;
-		wheelMap.SetValue(String("x"), Value(wheelMove.x));
-		wheelMap.SetValue(String("y"), Value(wheelMove.y));
-		return IntrinsicResult(wheelMap);
+		return IntrinsicResult(Vector2ToValue(wheelMove, ARG("into")));
 	};
-	raylibModule.SetValue("GetMouseWheelMoveV", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetMouseWheelMoveV", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("x");
 	i->AddParam("y");
 	i->code = INTRINSIC_LAMBDA {
-		int x = context->GetVar(String("x")).IntValue();
-		int y = context->GetVar(String("y")).IntValue();
+		int x = ARG("x").IntValue();
+		int y = ARG("y").IntValue();
 		SetMousePosition(x, y);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("SetMousePosition", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "SetMousePosition", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("offsetX");
 	i->AddParam("offsetY");
 	i->code = INTRINSIC_LAMBDA {
-		int offsetX = context->GetVar(String("offsetX")).IntValue();
-		int offsetY = context->GetVar(String("offsetY")).IntValue();
+		int offsetX = ARG("offsetX").IntValue();
+		int offsetY = ARG("offsetY").IntValue();
 		SetMouseOffset(offsetX, offsetY);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("SetMouseOffset", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "SetMouseOffset", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("scaleX");
 	i->AddParam("scaleY");
 	i->code = INTRINSIC_LAMBDA {
-		float scaleX = context->GetVar(String("scaleX")).FloatValue();
-		float scaleY = context->GetVar(String("scaleY")).FloatValue();
+		float scaleX = ARG("scaleX").FloatValue();
+		float scaleY = ARG("scaleY").FloatValue();
 		SetMouseScale(scaleX, scaleY);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("SetMouseScale", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "SetMouseScale", i);
 
 	i = Intrinsic::Create("");
 	i->code = INTRINSIC_LAMBDA {
 		EnableCursor();
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("EnableCursor", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "EnableCursor", i);
 
 	i = Intrinsic::Create("");
 	i->code = INTRINSIC_LAMBDA {
 		DisableCursor();
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DisableCursor", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DisableCursor", i);
 
 	// Touch input functions
 
@@ -491,109 +568,103 @@ void AddRCoreMethods(ValueDict raylibModule) {
 	i->code = INTRINSIC_LAMBDA {
 		return IntrinsicResult(GetTouchX());
 	};
-	raylibModule.SetValue("GetTouchX", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetTouchX", i);
 
 	i = Intrinsic::Create("");
 	i->code = INTRINSIC_LAMBDA {
 		return IntrinsicResult(GetTouchY());
 	};
-	raylibModule.SetValue("GetTouchY", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetTouchY", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("index", 0);
+	i->AddParam("into");
 	i->code = INTRINSIC_LAMBDA {
-		int index = context->GetVar(String("index")).IntValue();
+		int index = ARG("index").IntValue();
 		Vector2 pos = GetTouchPosition(index);
-		ValueDict posMap;
-		posMap.SetValue(String("x"), Value(pos.x));
-		posMap.SetValue(String("y"), Value(pos.y));
-		return IntrinsicResult(posMap);
+		return IntrinsicResult(Vector2ToValue(pos, ARG("into")));
 	};
-	raylibModule.SetValue("GetTouchPosition", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetTouchPosition", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("index", 0);
 	i->code = INTRINSIC_LAMBDA {
-		int index = context->GetVar(String("index")).IntValue();
+		int index = ARG("index").IntValue();
 		return IntrinsicResult(GetTouchPointId(index));
 	};
-	raylibModule.SetValue("GetTouchPointId", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetTouchPointId", i);
 
 	i = Intrinsic::Create("");
 	i->code = INTRINSIC_LAMBDA {
 		return IntrinsicResult(GetTouchPointCount());
 	};
-	raylibModule.SetValue("GetTouchPointCount", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetTouchPointCount", i);
 
 	// Gesture functions
 
 	i = Intrinsic::Create("");
 	i->AddParam("flags");
 	i->code = INTRINSIC_LAMBDA {
-		unsigned int flags = (unsigned int)context->GetVar(String("flags")).IntValue();
+		unsigned int flags = (unsigned int)ARG("flags").IntValue();
 		SetGesturesEnabled(flags);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("SetGesturesEnabled", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "SetGesturesEnabled", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("gesture");
 	i->code = INTRINSIC_LAMBDA {
-		int gesture = context->GetVar(String("gesture")).IntValue();
+		int gesture = ARG("gesture").IntValue();
 		return IntrinsicResult(IsGestureDetected(gesture));
 	};
-	raylibModule.SetValue("IsGestureDetected", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "IsGestureDetected", i);
 
 	i = Intrinsic::Create("");
 	i->code = INTRINSIC_LAMBDA {
 		return IntrinsicResult(GetGestureDetected());
 	};
-	raylibModule.SetValue("GetGestureDetected", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetGestureDetected", i);
 
 	i = Intrinsic::Create("");
 	i->code = INTRINSIC_LAMBDA {
 		return IntrinsicResult(GetGestureHoldDuration());
 	};
-	raylibModule.SetValue("GetGestureHoldDuration", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetGestureHoldDuration", i);
 
 	i = Intrinsic::Create("");
+	i->AddParam("into");
 	i->code = INTRINSIC_LAMBDA {
 		Vector2 dragVector = GetGestureDragVector();
-		ValueDict dragMap;
-		dragMap.SetValue(String("x"), Value(dragVector.x));
-		dragMap.SetValue(String("y"), Value(dragVector.y));
-		return IntrinsicResult(dragMap);
+		return IntrinsicResult(Vector2ToValue(dragVector, ARG("into")));
 	};
-	raylibModule.SetValue("GetGestureDragVector", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetGestureDragVector", i);
 
 	i = Intrinsic::Create("");
 	i->code = INTRINSIC_LAMBDA {
 		return IntrinsicResult(GetGestureDragAngle());
 	};
-	raylibModule.SetValue("GetGestureDragAngle", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetGestureDragAngle", i);
 
 	i = Intrinsic::Create("");
+	i->AddParam("into");
 	i->code = INTRINSIC_LAMBDA {
 		Vector2 pinchVector = GetGesturePinchVector();
-		ValueDict pinchMap;
-		pinchMap.SetValue(String("x"), Value(pinchVector.x));
-		pinchMap.SetValue(String("y"), Value(pinchVector.y));
-		return IntrinsicResult(pinchMap);
+		return IntrinsicResult(Vector2ToValue(pinchVector, ARG("into")));
 	};
-	raylibModule.SetValue("GetGesturePinchVector", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetGesturePinchVector", i);
 
 	i = Intrinsic::Create("");
 	i->code = INTRINSIC_LAMBDA {
 		return IntrinsicResult(GetGesturePinchAngle());
 	};
-	raylibModule.SetValue("GetGesturePinchAngle", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetGesturePinchAngle", i);
 
 	// 2D rendering mode functions
 
 	i = Intrinsic::Create("");
 	i->AddParam("camera");
 	i->code = INTRINSIC_LAMBDA {
-		ValueDict cameraMap = context->GetVar(String("camera")).GetDict();
+		ValueDict cameraMap = ARG("camera").GetDict();
 		Camera2D camera;
 		camera.offset.x = cameraMap.Lookup(String("offsetX"), Value::zero).FloatValue();
 		camera.offset.y = cameraMap.Lookup(String("offsetY"), Value::zero).FloatValue();
@@ -601,22 +672,24 @@ void AddRCoreMethods(ValueDict raylibModule) {
 		camera.target.y = cameraMap.Lookup(String("targetY"), Value::zero).FloatValue();
 		camera.rotation = cameraMap.Lookup(String("rotation"), Value::zero).FloatValue();
 		camera.zoom = cameraMap.Lookup(String("zoom"), Value::one).FloatValue();
+		NoteRenderBatch();
 		BeginMode2D(camera);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("BeginMode2D", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "BeginMode2D", i);
 
 	i = Intrinsic::Create("");
 	i->code = INTRINSIC_LAMBDA {
+		NoteRenderBatch();
 		EndMode2D();
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("EndMode2D", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "EndMode2D", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("camera");
 	i->code = INTRINSIC_LAMBDA {
-		ValueDict cameraMap = context->GetVar(String("camera")).GetDict();
+		ValueDict cameraMap = ARG("camera").GetDict();
 		Camera2D camera;
 		camera.offset.x = cameraMap.Lookup(String("offsetX"), Value::zero).FloatValue();
 		camera.offset.y = cameraMap.Lookup(String("offsetY"), Value::zero).FloatValue();
@@ -645,14 +718,15 @@ void AddRCoreMethods(ValueDict raylibModule) {
 		result.SetValue(String("m15"), Value(mat.m15));
 		return IntrinsicResult(result);
 	};
-	raylibModule.SetValue("GetCameraMatrix2D", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetCameraMatrix2D", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("position");
 	i->AddParam("camera");
+	i->AddParam("into");
 	i->code = INTRINSIC_LAMBDA {
-		Vector2 position = ValueToVector2(context->GetVar(String("position")));
-		ValueDict cameraMap = context->GetVar(String("camera")).GetDict();
+		Vector2 position = ValueToVector2(ARG("position"));
+		ValueDict cameraMap = ARG("camera").GetDict();
 		Camera2D camera;
 		camera.offset.x = cameraMap.Lookup(String("offsetX"), Value::zero).FloatValue();
 		camera.offset.y = cameraMap.Lookup(String("offsetY"), Value::zero).FloatValue();
@@ -662,19 +736,17 @@ void AddRCoreMethods(ValueDict raylibModule) {
 		camera.zoom = cameraMap.Lookup(String("zoom"), Value::one).FloatValue();
 
 		Vector2 result = GetWorldToScreen2D(position, camera);
-		ValueDict resultMap;
-		resultMap.SetValue(String("x"), Value(result.x));
-		resultMap.SetValue(String("y"), Value(result.y));
-		return IntrinsicResult(resultMap);
+		return IntrinsicResult(Vector2ToValue(result, ARG("into")));
 	};
-	raylibModule.SetValue("GetWorldToScreen2D", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetWorldToScreen2D", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("position");
 	i->AddParam("camera");
+	i->AddParam("into");
 	i->code = INTRINSIC_LAMBDA {
-		Vector2 position = ValueToVector2(context->GetVar(String("position")));
-		ValueDict cameraMap = context->GetVar(String("camera")).GetDict();
+		Vector2 position = ValueToVector2(ARG("position"));
+		ValueDict cameraMap = ARG("camera").GetDict();
 		Camera2D camera;
 		camera.offset.x = cameraMap.Lookup(String("offsetX"), Value::zero).FloatValue();
 		camera.offset.y = cameraMap.Lookup(String("offsetY"), Value::zero).FloatValue();
@@ -684,30 +756,29 @@ void AddRCoreMethods(ValueDict raylibModule) {
 		camera.zoom = cameraMap.Lookup(String("zoom"), Value::one).FloatValue();
 
 		Vector2 result = GetScreenToWorld2D(position, camera);
-		ValueDict resultMap;
-		resultMap.SetValue(String("x"), Value(result.x));
-		resultMap.SetValue(String("y"), Value(result.y));
-		return IntrinsicResult(resultMap);
+		return IntrinsicResult(Vector2ToValue(result, ARG("into")));
 	};
-	raylibModule.SetValue("GetScreenToWorld2D", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetScreenToWorld2D", i);
 
 	// Blend mode functions
 
 	i = Intrinsic::Create("");
 	i->AddParam("mode");
 	i->code = INTRINSIC_LAMBDA {
-		int mode = context->GetVar(String("mode")).IntValue();
+		int mode = ARG("mode").IntValue();
+		ChangeBlendMode(mode);
 		BeginBlendMode(mode);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("BeginBlendMode", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "BeginBlendMode", i);
 
 	i = Intrinsic::Create("");
 	i->code = INTRINSIC_LAMBDA {
+		ChangeBlendMode(BLEND_ALPHA);	// (what EndBlendMode sets)
 		EndBlendMode();
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("EndBlendMode", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "EndBlendMode", i);
 
 	// Scissor mode functions
 
@@ -717,41 +788,43 @@ void AddRCoreMethods(ValueDict raylibModule) {
 	i->AddParam("width");
 	i->AddParam("height");
 	i->code = INTRINSIC_LAMBDA {
-		int x = context->GetVar(String("x")).IntValue();
-		int y = context->GetVar(String("y")).IntValue();
-		int width = context->GetVar(String("width")).IntValue();
-		int height = context->GetVar(String("height")).IntValue();
+		int x = ARG("x").IntValue();
+		int y = ARG("y").IntValue();
+		int width = ARG("width").IntValue();
+		int height = ARG("height").IntValue();
+		NoteRenderBatch();
 		BeginScissorMode(x, y, width, height);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("BeginScissorMode", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "BeginScissorMode", i);
 
 	i = Intrinsic::Create("");
 	i->code = INTRINSIC_LAMBDA {
+		NoteRenderBatch();
 		EndScissorMode();
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("EndScissorMode", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "EndScissorMode", i);
 
 	// Utility functions
 
 	i = Intrinsic::Create("");
 	i->AddParam("url");
 	i->code = INTRINSIC_LAMBDA {
-		String url = context->GetVar(String("url")).ToString();
+		String url = ARG("url").ToString();
 		OpenURL(url.c_str());
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("OpenURL", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "OpenURL", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("text");
 	i->code = INTRINSIC_LAMBDA {
-		String text = context->GetVar(String("text")).ToString();
+		String text = ARG("text").ToString();
 		SetClipboardText(text.c_str());
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("SetClipboardText", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "SetClipboardText", i);
 
 #if RAYLIB_VERSION_GT(5, 5) || !defined(PLATFORM_WEB) // raylib 5.5 doesn't support GetClipboardImage on web
 	i = Intrinsic::Create("");
@@ -759,35 +832,35 @@ void AddRCoreMethods(ValueDict raylibModule) {
 		Image image = GetClipboardImage();
 		return IntrinsicResult(ImageToValue(image));
 	};
-	raylibModule.SetValue("GetClipboardImage", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetClipboardImage", i);
 #endif /* RAYLIB_VERSION_GT(5, 5) || !defined(PLATFORM_WEB) */
 
 	i = Intrinsic::Create("");
 	i->AddParam("fileName");
 	i->AddParam("ext");
 	i->code = INTRINSIC_LAMBDA {
-		String fileName = context->GetVar(String("fileName")).ToString();
-		String ext = context->GetVar(String("ext")).ToString();
+		String fileName = ARG("fileName").ToString();
+		String ext = ARG("ext").ToString();
 		return IntrinsicResult(IsFileExtension(fileName.c_str(), ext.c_str()));
 	};
-	raylibModule.SetValue("IsFileExtension", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "IsFileExtension", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("fileName");
 	i->code = INTRINSIC_LAMBDA {
-		String fileName = context->GetVar(String("fileName")).ToString();
+		String fileName = ARG("fileName").ToString();
 		TakeScreenshot(fileName.c_str());
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("TakeScreenshot", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "TakeScreenshot", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("data");
 	i->AddParam("dataSize");
 	i->code = INTRINSIC_LAMBDA {
 		// Get the data - could be a string or RawData
-		Value dataVal = context->GetVar(String("data"));
-		int dataSize = context->GetVar(String("dataSize")).IntValue();
+		Value dataVal = ARG("data");
+		int dataSize = ARG("dataSize").IntValue();
 
 		const unsigned char* bytes = nullptr;
 		String tempStr;
@@ -814,57 +887,192 @@ void AddRCoreMethods(ValueDict raylibModule) {
 		free(encoded);
 		return IntrinsicResult(result);
 	};
-	raylibModule.SetValue("EncodeDataBase64", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "EncodeDataBase64", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("seconds", 1.0);
 	i->code = INTRINSIC_LAMBDA {
-		double seconds = context->GetVar(String("seconds")).DoubleValue();
+		double seconds = ARG("seconds").DoubleValue();
 		WaitTime(seconds);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("WaitTime", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "WaitTime", i);
 
 	// Load text files
 	i = Intrinsic::Create("");
 	i->AddParam("fileName");
 	i->code = INTRINSIC_LAMBDA {
-		const char *fileName = context->GetVar("fileName").GetString().c_str();
-		char *text = LoadFileText(fileName);
+		String fileName = ARG("fileName").GetString();
+		if (!WaitForFile(fileName, partialResult)) return partialResult;
+		int size;
+		const unsigned char *preloaded = GetPreloadedFile(fileName.c_str(), &size);
+		if (preloaded) return IntrinsicResult(String((const char*)preloaded, size));
+		char *text = LoadFileText(fileName.c_str());
 		String ret(text);
 		UnloadFileText(text);
 		return IntrinsicResult(ret);
 	};
-	raylibModule.SetValue("LoadFileText", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "LoadFileText", i);
+
+	// File cache (fetched files kept in memory for reuse)
+	i = Intrinsic::Create("");
+	i->code = INTRINSIC_LAMBDA {
+		const FileCacheStats& stats = GetFileCacheStats();
+		ValueDict result;
+		result.SetValue(String("hits"), Value((double)stats.hits));
+		result.SetValue(String("misses"), Value((double)stats.misses));
+		result.SetValue(String("packHits"), Value((double)stats.packHits));
+		result.SetValue(String("evictions"), Value((double)stats.evictions));
+		result.SetValue(String("files"), Value((double)stats.files));
+		result.SetValue(String("bytes"), Value((double)stats.bytes));
+		result.SetValue(String("budget"), Value((double)stats.budget));
+		return IntrinsicResult(result);
+	};
+	RegisterIntrinsic(raylibModule, "GetFileCacheStats", i);
+
+	i = Intrinsic::Create("");
+	i->AddParam("bytes", Value(16 * 1024 * 1024));
+	i->code = INTRINSIC_LAMBDA {
+		SetFileCacheBudget((long)ARG("bytes").DoubleValue());
+		return IntrinsicResult::Null;
+	};
+	RegisterIntrinsic(raylibModule, "SetFileCacheBudget", i);
+
+	// Startup timing
+	i = Intrinsic::Create("");
+	i->code = INTRINSIC_LAMBDA {
+		const StartupStats& stats = GetStartupStats();
+		ValueDict result;
+		result.SetValue(String("moduleBuildTime"), Value(stats.moduleBuildTime));
+		result.SetValue(String("moduleEntries"), Value(stats.moduleEntries));
+		result.SetValue(String("scriptStartTime"), Value(stats.scriptStartTime));
+		result.SetValue(String("firstFrameTime"), Value(stats.firstFrameTime));
+		return IntrinsicResult(result);
+	};
+	RegisterIntrinsic(raylibModule, "GetStartupStats", i);
+
+	// Counters for the last frame: what was drawn, and where the time went
+	i = Intrinsic::Create("");
+	i->code = INTRINSIC_LAMBDA {
+		const FrameStats& stats = GetFrameStats();
+		ValueDict result;
+		result.SetValue(String("drawCalls"), Value((double)stats.drawCalls));
+		result.SetValue(String("vertices"), Value((double)stats.vertices));
+		result.SetValue(String("textureSwitches"), Value((double)stats.textureSwitches));
+		result.SetValue(String("intrinsicCalls"), Value((double)stats.intrinsicCalls));
+		result.SetValue(String("vmTime"), Value(stats.vmTime));
+		result.SetValue(String("renderTime"), Value(stats.renderTime));
+		result.SetValue(String("frameTime"), Value(GetSchedulerStats().frameTime));
+		return IntrinsicResult(result);
+	};
+	RegisterIntrinsic(raylibModule, "GetFrameStats", i);
+
+	// Calls and time spent in each intrinsic (when turned on)
+	i = Intrinsic::Create("");
+	i->AddParam("enabled", Value::one);
+	i->AddParam("reportFrames", Value::zero);
+	i->code = INTRINSIC_LAMBDA {
+		SetIntrinsicProfiling(ARG("enabled").BoolValue(), ARG("reportFrames").IntValue());
+		return IntrinsicResult::Null;
+	};
+	RegisterIntrinsic(raylibModule, "SetIntrinsicProfiling", i);
+
+	i = Intrinsic::Create("");
+	i->code = INTRINSIC_LAMBDA {
+		return IntrinsicResult(GetIntrinsicProfile());
+	};
+	RegisterIntrinsic(raylibModule, "GetIntrinsicProfile", i);
+
+	// Sampling of the script's call stack, for flame graphs
+	i = Intrinsic::Create("");
+	i->AddParam("enabled", Value::one);
+	i->AddParam("interval", Value(0.001));
+	i->code = INTRINSIC_LAMBDA {
+		SetScriptSampling(ARG("enabled").BoolValue(), ARG("interval").DoubleValue());
+		return IntrinsicResult::Null;
+	};
+	RegisterIntrinsic(raylibModule, "SetScriptSampling", i);
+
+	i = Intrinsic::Create("");
+	i->code = INTRINSIC_LAMBDA {
+		return IntrinsicResult(GetScriptProfile());
+	};
+	RegisterIntrinsic(raylibModule, "GetScriptProfile", i);
+
+	// Timeline of frame phases, fetches and texture uploads
+	i = Intrinsic::Create("");
+	i->AddParam("enabled", Value::one);
+	i->AddParam("capacity", Value(kDefaultTraceCapacity));
+	i->code = INTRINSIC_LAMBDA {
+		SetTracing(ARG("enabled").BoolValue(), ARG("capacity").IntValue());
+		return IntrinsicResult::Null;
+	};
+	RegisterIntrinsic(raylibModule, "SetTracing", i);
+
+	i = Intrinsic::Create("");
+	i->code = INTRINSIC_LAMBDA {
+		return IntrinsicResult(GetTraceJSON());
+	};
+	RegisterIntrinsic(raylibModule, "GetTraceJSON", i);
+
+	// Performance overlay (also toggled with F3)
+	i = Intrinsic::Create("");
+	i->AddParam("visible", Value::one);
+	i->code = INTRINSIC_LAMBDA {
+		SetPerfHUDVisible(ARG("visible").BoolValue());
+		return IntrinsicResult::Null;
+	};
+	RegisterIntrinsic(raylibModule, "SetPerfHUDVisible", i);
+
+	i = Intrinsic::Create("");
+	i->code = INTRINSIC_LAMBDA {
+		return IntrinsicResult(IsPerfHUDVisible());
+	};
+	RegisterIntrinsic(raylibModule, "IsPerfHUDVisible", i);
+
+	// Loaded resources (textures, sounds, etc.), for finding leaks
+	i = Intrinsic::Create("");
+	i->code = INTRINSIC_LAMBDA {
+		return IntrinsicResult(GetResourceReport());
+	};
+	RegisterIntrinsic(raylibModule, "GetResourceReport", i);
+
+	i = Intrinsic::Create("");
+	i->AddParam("enabled", Value::one);
+	i->code = INTRINSIC_LAMBDA {
+		SetResourceTracking(ARG("enabled").BoolValue());
+		return IntrinsicResult::Null;
+	};
+	RegisterIntrinsic(raylibModule, "SetResourceTracking", i);
 
 	// Random number generation
 	i = Intrinsic::Create("");
 	i->AddParam("seed");
 	i->code = INTRINSIC_LAMBDA {
-		unsigned int seed = (unsigned int)context->GetVar(String("seed")).IntValue();
+		unsigned int seed = (unsigned int)ARG("seed").IntValue();
 		SetRandomSeed(seed);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("SetRandomSeed", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "SetRandomSeed", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("min");
 	i->AddParam("max");
 	i->code = INTRINSIC_LAMBDA {
-		int min = context->GetVar(String("min")).IntValue();
-		int max = context->GetVar(String("max")).IntValue();
+		int min = ARG("min").IntValue();
+		int max = ARG("max").IntValue();
 		return IntrinsicResult(GetRandomValue(min, max));
 	};
-	raylibModule.SetValue("GetRandomValue", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetRandomValue", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("count");
 	i->AddParam("min");
 	i->AddParam("max");
 	i->code = INTRINSIC_LAMBDA {
-		unsigned int count = (unsigned int)context->GetVar(String("count")).IntValue();
-		int min = context->GetVar(String("min")).IntValue();
-		int max = context->GetVar(String("max")).IntValue();
+		unsigned int count = (unsigned int)ARG("count").IntValue();
+		int min = ARG("min").IntValue();
+		int max = ARG("max").IntValue();
 
 		int* sequence = LoadRandomSequence(count, min, max);
 		if (sequence == nullptr) return IntrinsicResult(Value::null);
@@ -876,15 +1084,15 @@ void AddRCoreMethods(ValueDict raylibModule) {
 		UnloadRandomSequence(sequence);
 		return IntrinsicResult(result);
 	};
-	raylibModule.SetValue("LoadRandomSequence", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "LoadRandomSequence", i);
 
 	// Logging and tracing
 	i = Intrinsic::Create("");
 	i->AddParam("logLevel");
 	i->code = INTRINSIC_LAMBDA {
-		int logLevel = context->GetVar(String("logLevel")).IntValue();
+		int logLevel = ARG("logLevel").IntValue();
 		SetTraceLogLevel(logLevel);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("SetTraceLogLevel", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "SetTraceLogLevel", i);
 }
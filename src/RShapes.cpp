@@ -7,6 +7,7 @@
 
 #include "RaylibIntrinsics.h"
 #include "RaylibTypes.h"
+#include "RawData.h"
 #include "raylib.h"
 #include "MiniscriptInterpreter.h"
 #include "MiniscriptTypes.h"
@@ -22,26 +23,26 @@ void AddRShapesMethods(ValueDict raylibModule) {
 	i = Intrinsic::Create("");
 	i->AddParam("posX", Value::zero);
 	i->AddParam("posY", Value::zero);
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		int posX = context->GetVar(String("posX")).IntValue();
-		int posY = context->GetVar(String("posY")).IntValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+		int posX = ARG("posX").IntValue();
+		int posY = ARG("posY").IntValue();
+		Color color = ValueToColor(ARG("color"));
 		DrawPixel(posX, posY, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawPixel", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawPixel", i);
 
 	i = Intrinsic::Create("");
-	i->AddParam("position", Vector2ToValue(Vector2{0, 0}));
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("position", DefaultVector2Value(Vector2{0, 0}));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		Vector2 position = ValueToVector2(context->GetVar(String("position")));
-		Color color = ValueToColor(context->GetVar(String("color")));
+		Vector2 position = ValueToVector2(ARG("position"));
+		Color color = ValueToColor(ARG("color"));
 		DrawPixelV(position, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawPixelV", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawPixelV", i);
 
 	// Line drawing
 
@@ -50,45 +51,45 @@ void AddRShapesMethods(ValueDict raylibModule) {
 	i->AddParam("startPosY", Value::zero);
 	i->AddParam("endPosX", Value::zero);
 	i->AddParam("endPosY", Value::zero);
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		int startPosX = context->GetVar(String("startPosX")).IntValue();
-		int startPosY = context->GetVar(String("startPosY")).IntValue();
-		int endPosX = context->GetVar(String("endPosX")).IntValue();
-		int endPosY = context->GetVar(String("endPosY")).IntValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+		int startPosX = ARG("startPosX").IntValue();
+		int startPosY = ARG("startPosY").IntValue();
+		int endPosX = ARG("endPosX").IntValue();
+		int endPosY = ARG("endPosY").IntValue();
+		Color color = ValueToColor(ARG("color"));
 		DrawLine(startPosX, startPosY, endPosX, endPosY, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawLine", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawLine", i);
 
 	i = Intrinsic::Create("");
-	i->AddParam("startPos", Vector2ToValue(Vector2{0, 0}));
-	i->AddParam("endPos", Vector2ToValue(Vector2{0, 0}));
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("startPos", DefaultVector2Value(Vector2{0, 0}));
+	i->AddParam("endPos", DefaultVector2Value(Vector2{0, 0}));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		Vector2 startPos = ValueToVector2(context->GetVar(String("startPos")));
-		Vector2 endPos = ValueToVector2(context->GetVar(String("endPos")));
-		Color color = ValueToColor(context->GetVar(String("color")));
+		Vector2 startPos = ValueToVector2(ARG("startPos"));
+		Vector2 endPos = ValueToVector2(ARG("endPos"));
+		Color color = ValueToColor(ARG("color"));
 		DrawLineV(startPos, endPos, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawLineV", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawLineV", i);
 
 	i = Intrinsic::Create("");
-	i->AddParam("startPos", Vector2ToValue(Vector2{0, 0}));
-	i->AddParam("endPos", Vector2ToValue(Vector2{0, 0}));
+	i->AddParam("startPos", DefaultVector2Value(Vector2{0, 0}));
+	i->AddParam("endPos", DefaultVector2Value(Vector2{0, 0}));
 	i->AddParam("thick", Value(1));
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		Vector2 startPos = ValueToVector2(context->GetVar(String("startPos")));
-		Vector2 endPos = ValueToVector2(context->GetVar(String("endPos")));
-		float thick = context->GetVar(String("thick")).FloatValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+		Vector2 startPos = ValueToVector2(ARG("startPos"));
+		Vector2 endPos = ValueToVector2(ARG("endPos"));
+		float thick = ARG("thick").FloatValue();
+		Color color = ValueToColor(ARG("color"));
 		DrawLineEx(startPos, endPos, thick, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawLineEx", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawLineEx", i);
 
 	// Circle drawing
 
@@ -96,44 +97,44 @@ void AddRShapesMethods(ValueDict raylibModule) {
 	i->AddParam("centerX", Value(100));
 	i->AddParam("centerY", Value(100));
 	i->AddParam("radius", Value(32));
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		int centerX = context->GetVar(String("centerX")).IntValue();
-		int centerY = context->GetVar(String("centerY")).IntValue();
-		float radius = context->GetVar(String("radius")).FloatValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+		int centerX = ARG("centerX").IntValue();
+		int centerY = ARG("centerY").IntValue();
+		float radius = ARG("radius").FloatValue();
+		Color color = ValueToColor(ARG("color"));
 		DrawCircle(centerX, centerY, radius, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawCircle", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawCircle", i);
 
 	i = Intrinsic::Create("");
-	i->AddParam("center", Vector2ToValue(Vector2{100, 100}));
+	i->AddParam("center", DefaultVector2Value(Vector2{100, 100}));
 	i->AddParam("radius", Value(32));
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		Vector2 center = ValueToVector2(context->GetVar(String("center")));
-		float radius = context->GetVar(String("radius")).FloatValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+		Vector2 center = ValueToVector2(ARG("center"));
+		float radius = ARG("radius").FloatValue();
+		Color color = ValueToColor(ARG("color"));
 		DrawCircleV(center, radius, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawCircleV", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawCircleV", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("centerX", Value(100));
 	i->AddParam("centerY", Value(100));
 	i->AddParam("radius", Value(32));
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		int centerX = context->GetVar(String("centerX")).IntValue();
-		int centerY = context->GetVar(String("centerY")).IntValue();
-		float radius = context->GetVar(String("radius")).FloatValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+		int centerX = ARG("centerX").IntValue();
+		int centerY = ARG("centerY").IntValue();
+		float radius = ARG("radius").FloatValue();
+		Color color = ValueToColor(ARG("color"));
 		DrawCircleLines(centerX, centerY, radius, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawCircleLines", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawCircleLines", i);
 
 	// Ellipse drawing
 
@@ -142,78 +143,78 @@ void AddRShapesMethods(ValueDict raylibModule) {
 	i->AddParam("centerY", Value(100));
 	i->AddParam("radiusH", Value(32));
 	i->AddParam("radiusV", Value(32));
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		int centerX = context->GetVar(String("centerX")).IntValue();
-		int centerY = context->GetVar(String("centerY")).IntValue();
-		float radiusH = context->GetVar(String("radiusH")).FloatValue();
-		float radiusV = context->GetVar(String("radiusV")).FloatValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+		int centerX = ARG("centerX").IntValue();
+		int centerY = ARG("centerY").IntValue();
+		float radiusH = ARG("radiusH").FloatValue();
+		float radiusV = ARG("radiusV").FloatValue();
+		Color color = ValueToColor(ARG("color"));
 		DrawEllipse(centerX, centerY, radiusH, radiusV, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawEllipse", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawEllipse", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("centerX", Value(100));
 	i->AddParam("centerY", Value(100));
 	i->AddParam("radiusH", Value(32));
 	i->AddParam("radiusV", Value(32));
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		int centerX = context->GetVar(String("centerX")).IntValue();
-		int centerY = context->GetVar(String("centerY")).IntValue();
-		float radiusH = context->GetVar(String("radiusH")).FloatValue();
-		float radiusV = context->GetVar(String("radiusV")).FloatValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+		int centerX = ARG("centerX").IntValue();
+		int centerY = ARG("centerY").IntValue();
+		float radiusH = ARG("radiusH").FloatValue();
+		float radiusV = ARG("radiusV").FloatValue();
+		Color color = ValueToColor(ARG("color"));
 		DrawEllipseLines(centerX, centerY, radiusH, radiusV, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawEllipseLines", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawEllipseLines", i);
 
 	// Ring drawing
 
 	i = Intrinsic::Create("");
-	i->AddParam("center", Vector2ToValue(Vector2{100, 100}));
+	i->AddParam("center", DefaultVector2Value(Vector2{100, 100}));
 	i->AddParam("innerRadius", Value(20));
 	i->AddParam("outerRadius", Value(32));
 	i->AddParam("startAngle", Value::zero);
 	i->AddParam("endAngle", Value(360));
 	i->AddParam("segments", Value(36));
-	i->AddParam("color", ColorToValue(WHITE));
-	i->code = INTRINSIC_LAMBDA {
-		Vector2 center = ValueToVector2(context->GetVar(String("center")));
-		float innerRadius = context->GetVar(String("innerRadius")).FloatValue();
-		float outerRadius = context->GetVar(String("outerRadius")).FloatValue();
-		float startAngle = context->GetVar(String("startAngle")).FloatValue();
-		float endAngle = context->GetVar(String("endAngle")).FloatValue();
-		int segments = context->GetVar(String("segments")).IntValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+	i->AddParam("color", DefaultColorValue(WHITE));
+	i->code = INTRINSIC_LAMBDA {
+		Vector2 center = ValueToVector2(ARG("center"));
+		float innerRadius = ARG("innerRadius").FloatValue();
+		float outerRadius = ARG("outerRadius").FloatValue();
+		float startAngle = ARG("startAngle").FloatValue();
+		float endAngle = ARG("endAngle").FloatValue();
+		int segments = ARG("segments").IntValue();
+		Color color = ValueToColor(ARG("color"));
 		DrawRing(center, innerRadius, outerRadius, startAngle, endAngle, segments, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawRing", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawRing", i);
 
 	i = Intrinsic::Create("");
-	i->AddParam("center", Vector2ToValue(Vector2{100, 100}));
+	i->AddParam("center", DefaultVector2Value(Vector2{100, 100}));
 	i->AddParam("innerRadius", Value(20));
 	i->AddParam("outerRadius", Value(32));
 	i->AddParam("startAngle", Value::zero);
 	i->AddParam("endAngle", Value(360));
 	i->AddParam("segments", Value(36));
-	i->AddParam("color", ColorToValue(WHITE));
-	i->code = INTRINSIC_LAMBDA {
-		Vector2 center = ValueToVector2(context->GetVar(String("center")));
-		float innerRadius = context->GetVar(String("innerRadius")).FloatValue();
-		float outerRadius = context->GetVar(String("outerRadius")).FloatValue();
-		float startAngle = context->GetVar(String("startAngle")).FloatValue();
-		float endAngle = context->GetVar(String("endAngle")).FloatValue();
-		int segments = context->GetVar(String("segments")).IntValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+	i->AddParam("color", DefaultColorValue(WHITE));
+	i->code = INTRINSIC_LAMBDA {
+		Vector2 center = ValueToVector2(ARG("center"));
+		float innerRadius = ARG("innerRadius").FloatValue();
+		float outerRadius = ARG("outerRadius").FloatValue();
+		float startAngle = ARG("startAngle").FloatValue();
+		float endAngle = ARG("endAngle").FloatValue();
+		int segments = ARG("segments").IntValue();
+		Color color = ValueToColor(ARG("color"));
 		DrawRingLines(center, innerRadius, outerRadius, startAngle, endAngle, segments, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawRingLines", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawRingLines", i);
 
 	// Rectangle drawing
 
@@ -222,148 +223,148 @@ void AddRShapesMethods(ValueDict raylibModule) {
 	i->AddParam("y", Value::zero);
 	i->AddParam("width", Value(256));
 	i->AddParam("height", Value(256));
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		int x = context->GetVar(String("x")).IntValue();
-		int y = context->GetVar(String("y")).IntValue();
-		int width = context->GetVar(String("width")).IntValue();
-		int height = context->GetVar(String("height")).IntValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+		int x = ARG("x").IntValue();
+		int y = ARG("y").IntValue();
+		int width = ARG("width").IntValue();
+		int height = ARG("height").IntValue();
+		Color color = ValueToColor(ARG("color"));
 		DrawRectangle(x, y, width, height, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawRectangle", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawRectangle", i);
 
 	i = Intrinsic::Create("");
-	i->AddParam("position", Vector2ToValue(Vector2{0, 0}));
-	i->AddParam("size", Vector2ToValue(Vector2{256, 256}));
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("position", DefaultVector2Value(Vector2{0, 0}));
+	i->AddParam("size", DefaultVector2Value(Vector2{256, 256}));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		Vector2 position = ValueToVector2(context->GetVar(String("position")));
-		Vector2 size = ValueToVector2(context->GetVar(String("size")));
-		Color color = ValueToColor(context->GetVar(String("color")));
+		Vector2 position = ValueToVector2(ARG("position"));
+		Vector2 size = ValueToVector2(ARG("size"));
+		Color color = ValueToColor(ARG("color"));
 		DrawRectangleV(position, size, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawRectangleV", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawRectangleV", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("rec");
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		Rectangle rec = ValueToRectangle(context->GetVar(String("rec")));
-		Color color = ValueToColor(context->GetVar(String("color")));
+		Rectangle rec = ValueToRectangle(ARG("rec"));
+		Color color = ValueToColor(ARG("color"));
 		DrawRectangleRec(rec, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawRectangleRec", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawRectangleRec", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("rec");
-	i->AddParam("origin", Vector2ToValue(Vector2{0, 0}));
+	i->AddParam("origin", DefaultVector2Value(Vector2{0, 0}));
 	i->AddParam("rotation", Value::zero);
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		Rectangle rec = ValueToRectangle(context->GetVar(String("rec")));
-		Vector2 origin = ValueToVector2(context->GetVar(String("origin")));
-		float rotation = context->GetVar(String("rotation")).FloatValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+		Rectangle rec = ValueToRectangle(ARG("rec"));
+		Vector2 origin = ValueToVector2(ARG("origin"));
+		float rotation = ARG("rotation").FloatValue();
+		Color color = ValueToColor(ARG("color"));
 		DrawRectanglePro(rec, origin, rotation, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawRectanglePro", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawRectanglePro", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("rec");
 	i->AddParam("color");
 	i->code = INTRINSIC_LAMBDA {
-		Rectangle rec = ValueToRectangle(context->GetVar(String("rec")));
-		Color color = ValueToColor(context->GetVar(String("color")));
+		Rectangle rec = ValueToRectangle(ARG("rec"));
+		Color color = ValueToColor(ARG("color"));
 		DrawRectangleLines(rec.x, rec.y, rec.width, rec.height, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawRectangleLines", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawRectangleLines", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("rec");
 	i->AddParam("lineThick", Value(1));
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		Rectangle rec = ValueToRectangle(context->GetVar(String("rec")));
-		float lineThick = context->GetVar(String("lineThick")).FloatValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+		Rectangle rec = ValueToRectangle(ARG("rec"));
+		float lineThick = ARG("lineThick").FloatValue();
+		Color color = ValueToColor(ARG("color"));
 		DrawRectangleLinesEx(rec, lineThick, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawRectangleLinesEx", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawRectangleLinesEx", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("rec");
 	i->AddParam("roundness", Value(0.5));
 	i->AddParam("segments", Value(36));
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		Rectangle rec = ValueToRectangle(context->GetVar(String("rec")));
-		float roundness = context->GetVar(String("roundness")).FloatValue();
-		int segments = context->GetVar(String("segments")).IntValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+		Rectangle rec = ValueToRectangle(ARG("rec"));
+		float roundness = ARG("roundness").FloatValue();
+		int segments = ARG("segments").IntValue();
+		Color color = ValueToColor(ARG("color"));
 		DrawRectangleRounded(rec, roundness, segments, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawRectangleRounded", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawRectangleRounded", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("rec");
 	i->AddParam("roundness", Value(0.5));
 	i->AddParam("segments", Value(36));
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		Rectangle rec = ValueToRectangle(context->GetVar(String("rec")));
-		float roundness = context->GetVar(String("roundness")).FloatValue();
-		int segments = context->GetVar(String("segments")).IntValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+		Rectangle rec = ValueToRectangle(ARG("rec"));
+		float roundness = ARG("roundness").FloatValue();
+		int segments = ARG("segments").IntValue();
+		Color color = ValueToColor(ARG("color"));
 		DrawRectangleRoundedLines(rec, roundness, segments, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawRectangleRoundedLines", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawRectangleRoundedLines", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("posX", Value::zero);
 	i->AddParam("posY", Value::zero);
 	i->AddParam("width", Value(256));
 	i->AddParam("height", Value(256));
-	i->AddParam("color1", ColorToValue(WHITE));
-	i->AddParam("color2", ColorToValue(BLACK));
-	i->code = INTRINSIC_LAMBDA {
-		int posX = context->GetVar(String("posX")).IntValue();
-		int posY = context->GetVar(String("posY")).IntValue();
-		int width = context->GetVar(String("width")).IntValue();
-		int height = context->GetVar(String("height")).IntValue();
-		Color color1 = ValueToColor(context->GetVar(String("color1")));
-		Color color2 = ValueToColor(context->GetVar(String("color2")));
+	i->AddParam("color1", DefaultColorValue(WHITE));
+	i->AddParam("color2", DefaultColorValue(BLACK));
+	i->code = INTRINSIC_LAMBDA {
+		int posX = ARG("posX").IntValue();
+		int posY = ARG("posY").IntValue();
+		int width = ARG("width").IntValue();
+		int height = ARG("height").IntValue();
+		Color color1 = ValueToColor(ARG("color1"));
+		Color color2 = ValueToColor(ARG("color2"));
 		DrawRectangleGradientV(posX, posY, width, height, color1, color2);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawRectangleGradientV", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawRectangleGradientV", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("posX", Value::zero);
 	i->AddParam("posY", Value::zero);
 	i->AddParam("width", Value(256));
 	i->AddParam("height", Value(256));
-	i->AddParam("color1", ColorToValue(WHITE));
-	i->AddParam("color2", ColorToValue(BLACK));
-	i->code = INTRINSIC_LAMBDA {
-		int posX = context->GetVar(String("posX")).IntValue();
-		int posY = context->GetVar(String("posY")).IntValue();
-		int width = context->GetVar(String("width")).IntValue();
-		int height = context->GetVar(String("height")).IntValue();
-		Color color1 = ValueToColor(context->GetVar(String("color1")));
-		Color color2 = ValueToColor(context->GetVar(String("color2")));
+	i->AddParam("color1", DefaultColorValue(WHITE));
+	i->AddParam("color2", DefaultColorValue(BLACK));
+	i->code = INTRINSIC_LAMBDA {
+		int posX = ARG("posX").IntValue();
+		int posY = ARG("posY").IntValue();
+		int width = ARG("width").IntValue();
+		int height = ARG("height").IntValue();
+		Color color1 = ValueToColor(ARG("color1"));
+		Color color2 = ValueToColor(ARG("color2"));
 		DrawRectangleGradientH(posX, posY, width, height, color1, color2);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawRectangleGradientH", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawRectangleGradientH", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("rec");
@@ -372,15 +373,15 @@ void AddRShapesMethods(ValueDict raylibModule) {
 	i->AddParam("col3");
 	i->AddParam("col4");
 	i->code = INTRINSIC_LAMBDA {
-		Rectangle rec = ValueToRectangle(context->GetVar(String("rec")));
-		Color col1 = ValueToColor(context->GetVar(String("col1")));
-		Color col2 = ValueToColor(context->GetVar(String("col2")));
-		Color col3 = ValueToColor(context->GetVar(String("col3")));
-		Color col4 = ValueToColor(context->GetVar(String("col4")));
+		Rectangle rec = ValueToRectangle(ARG("rec"));
+		Color col1 = ValueToColor(ARG("col1"));
+		Color col2 = ValueToColor(ARG("col2"));
+		Color col3 = ValueToColor(ARG("col3"));
+		Color col4 = ValueToColor(ARG("col4"));
 		DrawRectangleGradientEx(rec, col1, col2, col3, col4);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawRectangleGradientEx", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawRectangleGradientEx", i);
 
 	// Triangle drawing
 
@@ -388,12 +389,12 @@ void AddRShapesMethods(ValueDict raylibModule) {
 	i->AddParam("v1");
 	i->AddParam("v2");
 	i->AddParam("v3");
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		Vector2 v1 = ValueToVector2(context->GetVar(String("v1")));
-		Vector2 v2 = ValueToVector2(context->GetVar(String("v2")));
-		Vector2 v3 = ValueToVector2(context->GetVar(String("v3")));
-		Color color = ValueToColor(context->GetVar(String("color")));
+		Vector2 v1 = ValueToVector2(ARG("v1"));
+		Vector2 v2 = ValueToVector2(ARG("v2"));
+		Vector2 v3 = ValueToVector2(ARG("v3"));
+		Color color = ValueToColor(ARG("color"));
 		// Check winding order and ensure counter-clockwise (in screen coords where Y is down)
 		float det = (v2.x - v1.x) * (v3.y - v1.y) - (v2.y - v1.y) * (v3.x - v1.x);
 		if (det > 0) {
@@ -404,77 +405,77 @@ void AddRShapesMethods(ValueDict raylibModule) {
 		}
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawTriangle", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawTriangle", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("v1");
 	i->AddParam("v2");
 	i->AddParam("v3");
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		Vector2 v1 = ValueToVector2(context->GetVar(String("v1")));
-		Vector2 v2 = ValueToVector2(context->GetVar(String("v2")));
-		Vector2 v3 = ValueToVector2(context->GetVar(String("v3")));
-		Color color = ValueToColor(context->GetVar(String("color")));
+		Vector2 v1 = ValueToVector2(ARG("v1"));
+		Vector2 v2 = ValueToVector2(ARG("v2"));
+		Vector2 v3 = ValueToVector2(ARG("v3"));
+		Color color = ValueToColor(ARG("color"));
 		DrawTriangleLines(v1, v2, v3, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawTriangleLines", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawTriangleLines", i);
 
 	// Polygon drawing
 
 	i = Intrinsic::Create("");
-	i->AddParam("center", Vector2ToValue(Vector2{100, 100}));
+	i->AddParam("center", DefaultVector2Value(Vector2{100, 100}));
 	i->AddParam("sides", Value(6));
 	i->AddParam("radius", Value(32));
 	i->AddParam("rotation", Value::zero);
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		Vector2 center = ValueToVector2(context->GetVar(String("center")));
-		int sides = context->GetVar(String("sides")).IntValue();
-		float radius = context->GetVar(String("radius")).FloatValue();
-		float rotation = context->GetVar(String("rotation")).FloatValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+		Vector2 center = ValueToVector2(ARG("center"));
+		int sides = ARG("sides").IntValue();
+		float radius = ARG("radius").FloatValue();
+		float rotation = ARG("rotation").FloatValue();
+		Color color = ValueToColor(ARG("color"));
 		DrawPoly(center, sides, radius, rotation, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawPoly", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawPoly", i);
 
 	i = Intrinsic::Create("");
-	i->AddParam("center", Vector2ToValue(Vector2{100, 100}));
+	i->AddParam("center", DefaultVector2Value(Vector2{100, 100}));
 	i->AddParam("sides", Value(6));
 	i->AddParam("radius", Value(32));
 	i->AddParam("rotation", Value::zero);
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		Vector2 center = ValueToVector2(context->GetVar(String("center")));
-		int sides = context->GetVar(String("sides")).IntValue();
-		float radius = context->GetVar(String("radius")).FloatValue();
-		float rotation = context->GetVar(String("rotation")).FloatValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+		Vector2 center = ValueToVector2(ARG("center"));
+		int sides = ARG("sides").IntValue();
+		float radius = ARG("radius").FloatValue();
+		float rotation = ARG("rotation").FloatValue();
+		Color color = ValueToColor(ARG("color"));
 		DrawPolyLines(center, sides, radius, rotation, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawPolyLines", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawPolyLines", i);
 
 	i = Intrinsic::Create("");
-	i->AddParam("center", Vector2ToValue(Vector2{100, 100}));
+	i->AddParam("center", DefaultVector2Value(Vector2{100, 100}));
 	i->AddParam("sides", Value(6));
 	i->AddParam("radius", Value(32));
 	i->AddParam("rotation", Value::zero);
 	i->AddParam("lineThick", Value(1));
-	i->AddParam("color", ColorToValue(WHITE));
-	i->code = INTRINSIC_LAMBDA {
-		Vector2 center = ValueToVector2(context->GetVar(String("center")));
-		int sides = context->GetVar(String("sides")).IntValue();
-		float radius = context->GetVar(String("radius")).FloatValue();
-		float rotation = context->GetVar(String("rotation")).FloatValue();
-		float lineThick = context->GetVar(String("lineThick")).FloatValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+	i->AddParam("color", DefaultColorValue(WHITE));
+	i->code = INTRINSIC_LAMBDA {
+		Vector2 center = ValueToVector2(ARG("center"));
+		int sides = ARG("sides").IntValue();
+		float radius = ARG("radius").FloatValue();
+		float rotation = ARG("rotation").FloatValue();
+		float lineThick = ARG("lineThick").FloatValue();
+		Color color = ValueToColor(ARG("color"));
 		DrawPolyLinesEx(center, sides, radius, rotation, lineThick, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawPolyLinesEx", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawPolyLinesEx", i);
 
 	// Collision detection
 
@@ -482,11 +483,11 @@ void AddRShapesMethods(ValueDict raylibModule) {
 	i->AddParam("rec1");
 	i->AddParam("rec2");
 	i->code = INTRINSIC_LAMBDA {
-		Rectangle rec1 = ValueToRectangle(context->GetVar(String("rec1")));
-		Rectangle rec2 = ValueToRectangle(context->GetVar(String("rec2")));
+		Rectangle rec1 = ValueToRectangle(ARG("rec1"));
+		Rectangle rec2 = ValueToRectangle(ARG("rec2"));
 		return IntrinsicResult(CheckCollisionRecs(rec1, rec2));
 	};
-	raylibModule.SetValue("CheckCollisionRecs", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "CheckCollisionRecs", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("center1");
@@ -494,47 +495,47 @@ void AddRShapesMethods(ValueDict raylibModule) {
 	i->AddParam("center2");
 	i->AddParam("radius2");
 	i->code = INTRINSIC_LAMBDA {
-		Vector2 center1 = ValueToVector2(context->GetVar(String("center1")));
-		float radius1 = context->GetVar(String("radius1")).FloatValue();
-		Vector2 center2 = ValueToVector2(context->GetVar(String("center2")));
-		float radius2 = context->GetVar(String("radius2")).FloatValue();
+		Vector2 center1 = ValueToVector2(ARG("center1"));
+		float radius1 = ARG("radius1").FloatValue();
+		Vector2 center2 = ValueToVector2(ARG("center2"));
+		float radius2 = ARG("radius2").FloatValue();
 		return IntrinsicResult(CheckCollisionCircles(center1, radius1, center2, radius2));
 	};
-	raylibModule.SetValue("CheckCollisionCircles", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "CheckCollisionCircles", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("center");
 	i->AddParam("radius");
 	i->AddParam("rec");
 	i->code = INTRINSIC_LAMBDA {
-		Vector2 center = ValueToVector2(context->GetVar(String("center")));
-		float radius = context->GetVar(String("radius")).FloatValue();
-		Rectangle rec = ValueToRectangle(context->GetVar(String("rec")));
+		Vector2 center = ValueToVector2(ARG("center"));
+		float radius = ARG("radius").FloatValue();
+		Rectangle rec = ValueToRectangle(ARG("rec"));
 		return IntrinsicResult(CheckCollisionCircleRec(center, radius, rec));
 	};
-	raylibModule.SetValue("CheckCollisionCircleRec", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "CheckCollisionCircleRec", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("point");
 	i->AddParam("rec");
 	i->code = INTRINSIC_LAMBDA {
-		Vector2 point = ValueToVector2(context->GetVar(String("point")));
-		Rectangle rec = ValueToRectangle(context->GetVar(String("rec")));
+		Vector2 point = ValueToVector2(ARG("point"));
+		Rectangle rec = ValueToRectangle(ARG("rec"));
 		return IntrinsicResult(CheckCollisionPointRec(point, rec));
 	};
-	raylibModule.SetValue("CheckCollisionPointRec", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "CheckCollisionPointRec", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("point");
 	i->AddParam("center");
 	i->AddParam("radius");
 	i->code = INTRINSIC_LAMBDA {
-		Vector2 point = ValueToVector2(context->GetVar(String("point")));
-		Vector2 center = ValueToVector2(context->GetVar(String("center")));
-		float radius = context->GetVar(String("radius")).FloatValue();
+		Vector2 point = ValueToVector2(ARG("point"));
+		Vector2 center = ValueToVector2(ARG("center"));
+		float radius = ARG("radius").FloatValue();
 		return IntrinsicResult(CheckCollisionPointCircle(point, center, radius));
 	};
-	raylibModule.SetValue("CheckCollisionPointCircle", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "CheckCollisionPointCircle", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("point");
@@ -542,24 +543,25 @@ void AddRShapesMethods(ValueDict raylibModule) {
 	i->AddParam("p2");
 	i->AddParam("p3");
 	i->code = INTRINSIC_LAMBDA {
-		Vector2 point = ValueToVector2(context->GetVar(String("point")));
-		Vector2 p1 = ValueToVector2(context->GetVar(String("p1")));
-		Vector2 p2 = ValueToVector2(context->GetVar(String("p2")));
-		Vector2 p3 = ValueToVector2(context->GetVar(String("p3")));
+		Vector2 point = ValueToVector2(ARG("point"));
+		Vector2 p1 = ValueToVector2(ARG("p1"));
+		Vector2 p2 = ValueToVector2(ARG("p2"));
+		Vector2 p3 = ValueToVector2(ARG("p3"));
 		return IntrinsicResult(CheckCollisionPointTriangle(point, p1, p2, p3));
 	};
-	raylibModule.SetValue("CheckCollisionPointTriangle", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "CheckCollisionPointTriangle", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("rec1");
 	i->AddParam("rec2");
+	i->AddParam("into");
 	i->code = INTRINSIC_LAMBDA {
-		Rectangle rec1 = ValueToRectangle(context->GetVar(String("rec1")));
-		Rectangle rec2 = ValueToRectangle(context->GetVar(String("rec2")));
+		Rectangle rec1 = ValueToRectangle(ARG("rec1"));
+		Rectangle rec2 = ValueToRectangle(ARG("rec2"));
 		Rectangle result = GetCollisionRec(rec1, rec2);
-		return IntrinsicResult(RectangleToValue(result));
+		return IntrinsicResult(RectangleToValue(result, ARG("into")));
 	};
-	raylibModule.SetValue("GetCollisionRec", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetCollisionRec", i);
 
 	// Additional collision detection
 
@@ -569,30 +571,31 @@ void AddRShapesMethods(ValueDict raylibModule) {
 	i->AddParam("p1");
 	i->AddParam("p2");
 	i->code = INTRINSIC_LAMBDA {
-		Vector2 center = ValueToVector2(context->GetVar(String("center")));
-		float radius = context->GetVar(String("radius")).FloatValue();
-		Vector2 p1 = ValueToVector2(context->GetVar(String("p1")));
-		Vector2 p2 = ValueToVector2(context->GetVar(String("p2")));
+		Vector2 center = ValueToVector2(ARG("center"));
+		float radius = ARG("radius").FloatValue();
+		Vector2 p1 = ValueToVector2(ARG("p1"));
+		Vector2 p2 = ValueToVector2(ARG("p2"));
 		return IntrinsicResult(CheckCollisionCircleLine(center, radius, p1, p2));
 	};
-	raylibModule.SetValue("CheckCollisionCircleLine", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "CheckCollisionCircleLine", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("startPos1");
 	i->AddParam("endPos1");
 	i->AddParam("startPos2");
 	i->AddParam("endPos2");
+	i->AddParam("into");
 	i->code = INTRINSIC_LAMBDA {
-		Vector2 startPos1 = ValueToVector2(context->GetVar(String("startPos1")));
-		Vector2 endPos1 = ValueToVector2(context->GetVar(String("endPos1")));
-		Vector2 startPos2 = ValueToVector2(context->GetVar(String("startPos2")));
-		Vector2 endPos2 = ValueToVector2(context->GetVar(String("endPos2")));
+		Vector2 startPos1 = ValueToVector2(ARG("startPos1"));
+		Vector2 endPos1 = ValueToVector2(ARG("endPos1"));
+		Vector2 startPos2 = ValueToVector2(ARG("startPos2"));
+		Vector2 endPos2 = ValueToVector2(ARG("endPos2"));
 		Vector2 collisionPoint;
 		bool result = CheckCollisionLines(startPos1, endPos1, startPos2, endPos2, &collisionPoint);
 		if (!result) return IntrinsicResult::Null;
-		return IntrinsicResult(Vector2ToValue(collisionPoint));
+		return IntrinsicResult(Vector2ToValue(collisionPoint, ARG("into")));
 	};
-	raylibModule.SetValue("CheckCollisionLines", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "CheckCollisionLines", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("point");
@@ -600,33 +603,27 @@ void AddRShapesMethods(ValueDict raylibModule) {
 	i->AddParam("p2");
 	i->AddParam("threshold");
 	i->code = INTRINSIC_LAMBDA {
-		Vector2 point = ValueToVector2(context->GetVar(String("point")));
-		Vector2 p1 = ValueToVector2(context->GetVar(String("p1")));
-		Vector2 p2 = ValueToVector2(context->GetVar(String("p2")));
-		int threshold = context->GetVar(String("threshold")).IntValue();
+		Vector2 point = ValueToVector2(ARG("point"));
+		Vector2 p1 = ValueToVector2(ARG("p1"));
+		Vector2 p2 = ValueToVector2(ARG("p2"));
+		int threshold = ARG("threshold").IntValue();
 		return IntrinsicResult(CheckCollisionPointLine(point, p1, p2, threshold));
 	};
-	raylibModule.SetValue("CheckCollisionPointLine", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "CheckCollisionPointLine", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("point");
 	i->AddParam("points");
 	i->code = INTRINSIC_LAMBDA {
-		Vector2 point = ValueToVector2(context->GetVar(String("point")));
-		ValueList pointsList = context->GetVar(String("points")).GetList();
-		int pointCount = pointsList.Count();
+		Vector2 point = ValueToVector2(ARG("point"));
+		PointArray points(ARG("points"));
+		int pointCount = points.count;
 		if (pointCount < 3) return IntrinsicResult(Value::zero);
 
-		Vector2* points = new Vector2[pointCount];
-		for (int i = 0; i < pointCount; i++) {
-			points[i] = ValueToVector2(pointsList[i]);
-		}
-
-		bool result = CheckCollisionPointPoly(point, points, pointCount);
-		delete[] points;
+		bool result = CheckCollisionPointPoly(point, points.data, pointCount);
 		return IntrinsicResult(result);
 	};
-	raylibModule.SetValue("CheckCollisionPointPoly", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "CheckCollisionPointPoly", i);
 
 	// Additional circle drawing
 
@@ -634,31 +631,31 @@ void AddRShapesMethods(ValueDict raylibModule) {
 	i->AddParam("centerX", Value::zero);
 	i->AddParam("centerY", Value::zero);
 	i->AddParam("radius", Value(10.0));
-	i->AddParam("colorInner", ColorToValue(WHITE));
-	i->AddParam("colorOuter", ColorToValue(BLACK));
-	i->code = INTRINSIC_LAMBDA {
-		int centerX = context->GetVar(String("centerX")).IntValue();
-		int centerY = context->GetVar(String("centerY")).IntValue();
-		float radius = context->GetVar(String("radius")).FloatValue();
-		Color colorInner = ValueToColor(context->GetVar(String("colorInner")));
-		Color colorOuter = ValueToColor(context->GetVar(String("colorOuter")));
+	i->AddParam("colorInner", DefaultColorValue(WHITE));
+	i->AddParam("colorOuter", DefaultColorValue(BLACK));
+	i->code = INTRINSIC_LAMBDA {
+		int centerX = ARG("centerX").IntValue();
+		int centerY = ARG("centerY").IntValue();
+		float radius = ARG("radius").FloatValue();
+		Color colorInner = ValueToColor(ARG("colorInner"));
+		Color colorOuter = ValueToColor(ARG("colorOuter"));
 		DrawCircleGradient(centerX, centerY, radius, colorInner, colorOuter);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawCircleGradient", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawCircleGradient", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("center");
 	i->AddParam("radius", Value(10.0));
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		Vector2 center = ValueToVector2(context->GetVar(String("center")));
-		float radius = context->GetVar(String("radius")).FloatValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+		Vector2 center = ValueToVector2(ARG("center"));
+		float radius = ARG("radius").FloatValue();
+		Color color = ValueToColor(ARG("color"));
 		DrawCircleLinesV(center, radius, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawCircleLinesV", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawCircleLinesV", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("center");
@@ -666,18 +663,18 @@ void AddRShapesMethods(ValueDict raylibModule) {
 	i->AddParam("startAngle", Value::zero);
 	i->AddParam("endAngle", Value(90.0));
 	i->AddParam("segments", Value(36));
-	i->AddParam("color", ColorToValue(WHITE));
-	i->code = INTRINSIC_LAMBDA {
-		Vector2 center = ValueToVector2(context->GetVar(String("center")));
-		float radius = context->GetVar(String("radius")).FloatValue();
-		float startAngle = context->GetVar(String("startAngle")).FloatValue();
-		float endAngle = context->GetVar(String("endAngle")).FloatValue();
-		int segments = context->GetVar(String("segments")).IntValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+	i->AddParam("color", DefaultColorValue(WHITE));
+	i->code = INTRINSIC_LAMBDA {
+		Vector2 center = ValueToVector2(ARG("center"));
+		float radius = ARG("radius").FloatValue();
+		float startAngle = ARG("startAngle").FloatValue();
+		float endAngle = ARG("endAngle").FloatValue();
+		int segments = ARG("segments").IntValue();
+		Color color = ValueToColor(ARG("color"));
 		DrawCircleSector(center, radius, startAngle, endAngle, segments, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawCircleSector", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawCircleSector", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("center");
@@ -685,18 +682,18 @@ void AddRShapesMethods(ValueDict raylibModule) {
 	i->AddParam("startAngle", Value::zero);
 	i->AddParam("endAngle", Value(90.0));
 	i->AddParam("segments", Value(36));
-	i->AddParam("color", ColorToValue(WHITE));
-	i->code = INTRINSIC_LAMBDA {
-		Vector2 center = ValueToVector2(context->GetVar(String("center")));
-		float radius = context->GetVar(String("radius")).FloatValue();
-		float startAngle = context->GetVar(String("startAngle")).FloatValue();
-		float endAngle = context->GetVar(String("endAngle")).FloatValue();
-		int segments = context->GetVar(String("segments")).IntValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+	i->AddParam("color", DefaultColorValue(WHITE));
+	i->code = INTRINSIC_LAMBDA {
+		Vector2 center = ValueToVector2(ARG("center"));
+		float radius = ARG("radius").FloatValue();
+		float startAngle = ARG("startAngle").FloatValue();
+		float endAngle = ARG("endAngle").FloatValue();
+		int segments = ARG("segments").IntValue();
+		Color color = ValueToColor(ARG("color"));
 		DrawCircleSectorLines(center, radius, startAngle, endAngle, segments, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawCircleSectorLines", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawCircleSectorLines", i);
 
 #if RAYLIB_VERSION_GT(5, 5)
 	// Additional ellipse drawing
@@ -705,31 +702,31 @@ void AddRShapesMethods(ValueDict raylibModule) {
 	i->AddParam("center");
 	i->AddParam("radiusH", Value(10.0));
 	i->AddParam("radiusV", Value(5.0));
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		Vector2 center = ValueToVector2(context->GetVar(String("center")));
-		float radiusH = context->GetVar(String("radiusH")).FloatValue();
-		float radiusV = context->GetVar(String("radiusV")).FloatValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+		Vector2 center = ValueToVector2(ARG("center"));
+		float radiusH = ARG("radiusH").FloatValue();
+		float radiusV = ARG("radiusV").FloatValue();
+		Color color = ValueToColor(ARG("color"));
 		DrawEllipseV(center, radiusH, radiusV, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawEllipseV", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawEllipseV", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("center");
 	i->AddParam("radiusH", Value(10.0));
 	i->AddParam("radiusV", Value(5.0));
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		Vector2 center = ValueToVector2(context->GetVar(String("center")));
-		float radiusH = context->GetVar(String("radiusH")).FloatValue();
-		float radiusV = context->GetVar(String("radiusV")).FloatValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+		Vector2 center = ValueToVector2(ARG("center"));
+		float radiusH = ARG("radiusH").FloatValue();
+		float radiusV = ARG("radiusV").FloatValue();
+		Color color = ValueToColor(ARG("color"));
 		DrawEllipseLinesV(center, radiusH, radiusV, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawEllipseLinesV", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawEllipseLinesV", i);
 #endif /* RAYLIB_VERSION_GT(5, 5) */
 
 	// Additional line drawing
@@ -738,16 +735,16 @@ void AddRShapesMethods(ValueDict raylibModule) {
 	i->AddParam("startPos");
 	i->AddParam("endPos");
 	i->AddParam("thick", Value(1.0));
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		Vector2 startPos = ValueToVector2(context->GetVar(String("startPos")));
-		Vector2 endPos = ValueToVector2(context->GetVar(String("endPos")));
-		float thick = context->GetVar(String("thick")).FloatValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+		Vector2 startPos = ValueToVector2(ARG("startPos"));
+		Vector2 endPos = ValueToVector2(ARG("endPos"));
+		float thick = ARG("thick").FloatValue();
+		Color color = ValueToColor(ARG("color"));
 		DrawLineBezier(startPos, endPos, thick, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawLineBezier", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawLineBezier", i);
 
 #if RAYLIB_VERSION_GT(5, 5)
 	i = Intrinsic::Create("");
@@ -755,38 +752,32 @@ void AddRShapesMethods(ValueDict raylibModule) {
 	i->AddParam("endPos");
 	i->AddParam("dashSize");
 	i->AddParam("spaceSize");
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		Vector2 startPos = ValueToVector2(context->GetVar(String("startPos")));
-		Vector2 endPos = ValueToVector2(context->GetVar(String("endPos")));
-		int dashSize = context->GetVar(String("dashSize")).IntValue();
-		int spaceSize = context->GetVar(String("spaceSize")).IntValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+		Vector2 startPos = ValueToVector2(ARG("startPos"));
+		Vector2 endPos = ValueToVector2(ARG("endPos"));
+		int dashSize = ARG("dashSize").IntValue();
+		int spaceSize = ARG("spaceSize").IntValue();
+		Color color = ValueToColor(ARG("color"));
 		DrawLineDashed(startPos, endPos, dashSize, spaceSize, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawLineDashed", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawLineDashed", i);
 #endif /* RAYLIB_VERSION_GT(5, 5) */
 
 	i = Intrinsic::Create("");
 	i->AddParam("points");
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		ValueList pointsList = context->GetVar(String("points")).GetList();
-		int pointCount = pointsList.Count();
+		PointArray points(ARG("points"));
+		int pointCount = points.count;
 		if (pointCount < 2) return IntrinsicResult::Null;
 
-		Vector2* points = new Vector2[pointCount];
-		for (int i = 0; i < pointCount; i++) {
-			points[i] = ValueToVector2(pointsList[i]);
-		}
-
-		Color color = ValueToColor(context->GetVar(String("color")));
-		DrawLineStrip(points, pointCount, color);
-		delete[] points;
+		Color color = ValueToColor(ARG("color"));
+		DrawLineStrip(points.data, pointCount, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawLineStrip", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawLineStrip", i);
 
 	// Additional rectangle drawing
 
@@ -795,129 +786,99 @@ void AddRShapesMethods(ValueDict raylibModule) {
 	i->AddParam("roundness", Value(0.0));
 	i->AddParam("segments", Value::zero);
 	i->AddParam("lineThick", Value(1.0));
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		Rectangle rec = ValueToRectangle(context->GetVar(String("rec")));
-		float roundness = context->GetVar(String("roundness")).FloatValue();
-		int segments = context->GetVar(String("segments")).IntValue();
-		float lineThick = context->GetVar(String("lineThick")).FloatValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+		Rectangle rec = ValueToRectangle(ARG("rec"));
+		float roundness = ARG("roundness").FloatValue();
+		int segments = ARG("segments").IntValue();
+		float lineThick = ARG("lineThick").FloatValue();
+		Color color = ValueToColor(ARG("color"));
 		DrawRectangleRoundedLinesEx(rec, roundness, segments, lineThick, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawRectangleRoundedLinesEx", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawRectangleRoundedLinesEx", i);
 
 	// Spline drawing
 
 	i = Intrinsic::Create("");
 	i->AddParam("points");
 	i->AddParam("thick", Value(1.0));
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		ValueList pointsList = context->GetVar(String("points")).GetList();
-		int pointCount = pointsList.Count();
+		PointArray points(ARG("points"));
+		int pointCount = points.count;
 		if (pointCount < 2) return IntrinsicResult::Null;
 
-		Vector2* points = new Vector2[pointCount];
-		for (int i = 0; i < pointCount; i++) {
-			points[i] = ValueToVector2(pointsList[i]);
-		}
-
-		float thick = context->GetVar(String("thick")).FloatValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
-		DrawSplineLinear(points, pointCount, thick, color);
-		delete[] points;
+		float thick = ARG("thick").FloatValue();
+		Color color = ValueToColor(ARG("color"));
+		DrawSplineLinear(points.data, pointCount, thick, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawSplineLinear", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawSplineLinear", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("points");
 	i->AddParam("thick", Value(1.0));
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		ValueList pointsList = context->GetVar(String("points")).GetList();
-		int pointCount = pointsList.Count();
+		PointArray points(ARG("points"));
+		int pointCount = points.count;
 		if (pointCount < 4) return IntrinsicResult::Null;
 
-		Vector2* points = new Vector2[pointCount];
-		for (int i = 0; i < pointCount; i++) {
-			points[i] = ValueToVector2(pointsList[i]);
-		}
-
-		float thick = context->GetVar(String("thick")).FloatValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
-		DrawSplineBasis(points, pointCount, thick, color);
-		delete[] points;
+		float thick = ARG("thick").FloatValue();
+		Color color = ValueToColor(ARG("color"));
+		DrawSplineBasis(points.data, pointCount, thick, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawSplineBasis", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawSplineBasis", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("points");
 	i->AddParam("thick", Value(1.0));
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		ValueList pointsList = context->GetVar(String("points")).GetList();
-		int pointCount = pointsList.Count();
+		PointArray points(ARG("points"));
+		int pointCount = points.count;
 		if (pointCount < 2) return IntrinsicResult::Null;
 
-		Vector2* points = new Vector2[pointCount];
-		for (int i = 0; i < pointCount; i++) {
-			points[i] = ValueToVector2(pointsList[i]);
-		}
-
-		float thick = context->GetVar(String("thick")).FloatValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
-		DrawSplineCatmullRom(points, pointCount, thick, color);
-		delete[] points;
+		float thick = ARG("thick").FloatValue();
+		Color color = ValueToColor(ARG("color"));
+		DrawSplineCatmullRom(points.data, pointCount, thick, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawSplineCatmullRom", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawSplineCatmullRom", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("points");
 	i->AddParam("thick", Value(1.0));
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		ValueList pointsList = context->GetVar(String("points")).GetList();
-		int pointCount = pointsList.Count();
+		PointArray points(ARG("points"));
+		int pointCount = points.count;
 		if (pointCount < 3) return IntrinsicResult::Null;
 
-		Vector2* points = new Vector2[pointCount];
-		for (int i = 0; i < pointCount; i++) {
-			points[i] = ValueToVector2(pointsList[i]);
-		}
-
-		float thick = context->GetVar(String("thick")).FloatValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
-		DrawSplineBezierQuadratic(points, pointCount, thick, color);
-		delete[] points;
+		float thick = ARG("thick").FloatValue();
+		Color color = ValueToColor(ARG("color"));
+		DrawSplineBezierQuadratic(points.data, pointCount, thick, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawSplineBezierQuadratic", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawSplineBezierQuadratic", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("points");
 	i->AddParam("thick", Value(1.0));
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		ValueList pointsList = context->GetVar(String("points")).GetList();
-		int pointCount = pointsList.Count();
+		PointArray points(ARG("points"));
+		int pointCount = points.count;
 		if (pointCount < 4) return IntrinsicResult::Null;
 
-		Vector2* points = new Vector2[pointCount];
-		for (int i = 0; i < pointCount; i++) {
-			points[i] = ValueToVector2(pointsList[i]);
-		}
-
-		float thick = context->GetVar(String("thick")).FloatValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
-		DrawSplineBezierCubic(points, pointCount, thick, color);
-		delete[] points;
+		float thick = ARG("thick").FloatValue();
+		Color color = ValueToColor(ARG("color"));
+		DrawSplineBezierCubic(points.data, pointCount, thick, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawSplineBezierCubic", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawSplineBezierCubic", i);
 
 	// Spline segment drawing
 
@@ -925,16 +886,16 @@ void AddRShapesMethods(ValueDict raylibModule) {
 	i->AddParam("p1");
 	i->AddParam("p2");
 	i->AddParam("thick", Value(1.0));
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		Vector2 p1 = ValueToVector2(context->GetVar(String("p1")));
-		Vector2 p2 = ValueToVector2(context->GetVar(String("p2")));
-		float thick = context->GetVar(String("thick")).FloatValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+		Vector2 p1 = ValueToVector2(ARG("p1"));
+		Vector2 p2 = ValueToVector2(ARG("p2"));
+		float thick = ARG("thick").FloatValue();
+		Color color = ValueToColor(ARG("color"));
 		DrawSplineSegmentLinear(p1, p2, thick, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawSplineSegmentLinear", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawSplineSegmentLinear", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("p1");
@@ -942,18 +903,18 @@ void AddRShapesMethods(ValueDict raylibModule) {
 	i->AddParam("p3");
 	i->AddParam("p4");
 	i->AddParam("thick", Value(1.0));
-	i->AddParam("color", ColorToValue(WHITE));
-	i->code = INTRINSIC_LAMBDA {
-		Vector2 p1 = ValueToVector2(context->GetVar(String("p1")));
-		Vector2 p2 = ValueToVector2(context->GetVar(String("p2")));
-		Vector2 p3 = ValueToVector2(context->GetVar(String("p3")));
-		Vector2 p4 = ValueToVector2(context->GetVar(String("p4")));
-		float thick = context->GetVar(String("thick")).FloatValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+	i->AddParam("color", DefaultColorValue(WHITE));
+	i->code = INTRINSIC_LAMBDA {
+		Vector2 p1 = ValueToVector2(ARG("p1"));
+		Vector2 p2 = ValueToVector2(ARG("p2"));
+		Vector2 p3 = ValueToVector2(ARG("p3"));
+		Vector2 p4 = ValueToVector2(ARG("p4"));
+		float thick = ARG("thick").FloatValue();
+		Color color = ValueToColor(ARG("color"));
 		DrawSplineSegmentBasis(p1, p2, p3, p4, thick, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawSplineSegmentBasis", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawSplineSegmentBasis", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("p1");
@@ -961,35 +922,35 @@ void AddRShapesMethods(ValueDict raylibModule) {
 	i->AddParam("p3");
 	i->AddParam("p4");
 	i->AddParam("thick", Value(1.0));
-	i->AddParam("color", ColorToValue(WHITE));
-	i->code = INTRINSIC_LAMBDA {
-		Vector2 p1 = ValueToVector2(context->GetVar(String("p1")));
-		Vector2 p2 = ValueToVector2(context->GetVar(String("p2")));
-		Vector2 p3 = ValueToVector2(context->GetVar(String("p3")));
-		Vector2 p4 = ValueToVector2(context->GetVar(String("p4")));
-		float thick = context->GetVar(String("thick")).FloatValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+	i->AddParam("color", DefaultColorValue(WHITE));
+	i->code = INTRINSIC_LAMBDA {
+		Vector2 p1 = ValueToVector2(ARG("p1"));
+		Vector2 p2 = ValueToVector2(ARG("p2"));
+		Vector2 p3 = ValueToVector2(ARG("p3"));
+		Vector2 p4 = ValueToVector2(ARG("p4"));
+		float thick = ARG("thick").FloatValue();
+		Color color = ValueToColor(ARG("color"));
 		DrawSplineSegmentCatmullRom(p1, p2, p3, p4, thick, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawSplineSegmentCatmullRom", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawSplineSegmentCatmullRom", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("p1");
 	i->AddParam("p2");
 	i->AddParam("p3");
 	i->AddParam("thick", Value(1.0));
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		Vector2 p1 = ValueToVector2(context->GetVar(String("p1")));
-		Vector2 p2 = ValueToVector2(context->GetVar(String("p2")));
-		Vector2 p3 = ValueToVector2(context->GetVar(String("p3")));
-		float thick = context->GetVar(String("thick")).FloatValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+		Vector2 p1 = ValueToVector2(ARG("p1"));
+		Vector2 p2 = ValueToVector2(ARG("p2"));
+		Vector2 p3 = ValueToVector2(ARG("p3"));
+		float thick = ARG("thick").FloatValue();
+		Color color = ValueToColor(ARG("color"));
 		DrawSplineSegmentBezierQuadratic(p1, p2, p3, thick, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawSplineSegmentBezierQuadratic", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawSplineSegmentBezierQuadratic", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("p1");
@@ -997,18 +958,18 @@ void AddRShapesMethods(ValueDict raylibModule) {
 	i->AddParam("p3");
 	i->AddParam("p4");
 	i->AddParam("thick", Value(1.0));
-	i->AddParam("color", ColorToValue(WHITE));
-	i->code = INTRINSIC_LAMBDA {
-		Vector2 p1 = ValueToVector2(context->GetVar(String("p1")));
-		Vector2 p2 = ValueToVector2(context->GetVar(String("p2")));
-		Vector2 p3 = ValueToVector2(context->GetVar(String("p3")));
-		Vector2 p4 = ValueToVector2(context->GetVar(String("p4")));
-		float thick = context->GetVar(String("thick")).FloatValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+	i->AddParam("color", DefaultColorValue(WHITE));
+	i->code = INTRINSIC_LAMBDA {
+		Vector2 p1 = ValueToVector2(ARG("p1"));
+		Vector2 p2 = ValueToVector2(ARG("p2"));
+		Vector2 p3 = ValueToVector2(ARG("p3"));
+		Vector2 p4 = ValueToVector2(ARG("p4"));
+		float thick = ARG("thick").FloatValue();
+		Color color = ValueToColor(ARG("color"));
 		DrawSplineSegmentBezierCubic(p1, p2, p3, p4, thick, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawSplineSegmentBezierCubic", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawSplineSegmentBezierCubic", i);
 
 	// Spline point evaluation functions
 
@@ -1016,17 +977,15 @@ void AddRShapesMethods(ValueDict raylibModule) {
 	i->AddParam("startPos");
 	i->AddParam("endPos");
 	i->AddParam("t");
+	i->AddParam("into");
 	i->code = INTRINSIC_LAMBDA {
-		Vector2 startPos = ValueToVector2(context->GetVar(String("startPos")));
-		Vector2 endPos = ValueToVector2(context->GetVar(String("endPos")));
-		float t = context->GetVar(String("t")).FloatValue();
+		Vector2 startPos = ValueToVector2(ARG("startPos"));
+		Vector2 endPos = ValueToVector2(ARG("endPos"));
+		float t = ARG("t").FloatValue();
 		Vector2 result = GetSplinePointLinear(startPos, endPos, t);
-		ValueDict resultMap;
-		resultMap.SetValue(String("x"), Value(result.x));
-		resultMap.SetValue(String("y"), Value(result.y));
-		return IntrinsicResult(resultMap);
+		return IntrinsicResult(Vector2ToValue(result, ARG("into")));
 	};
-	raylibModule.SetValue("GetSplinePointLinear", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetSplinePointLinear", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("p1");
@@ -1034,19 +993,17 @@ void AddRShapesMethods(ValueDict raylibModule) {
 	i->AddParam("p3");
 	i->AddParam("p4");
 	i->AddParam("t");
+	i->AddParam("into");
 	i->code = INTRINSIC_LAMBDA {
-		Vector2 p1 = ValueToVector2(context->GetVar(String("p1")));
-		Vector2 p2 = ValueToVector2(context->GetVar(String("p2")));
-		Vector2 p3 = ValueToVector2(context->GetVar(String("p3")));
-		Vector2 p4 = ValueToVector2(context->GetVar(String("p4")));
-		float t = context->GetVar(String("t")).FloatValue();
+		Vector2 p1 = ValueToVector2(ARG("p1"));
+		Vector2 p2 = ValueToVector2(ARG("p2"));
+		Vector2 p3 = ValueToVector2(ARG("p3"));
+		Vector2 p4 = ValueToVector2(ARG("p4"));
+		float t = ARG("t").FloatValue();
 		Vector2 result = GetSplinePointBasis(p1, p2, p3, p4, t);
-		ValueDict resultMap;
-		resultMap.SetValue(String("x"), Value(result.x));
-		resultMap.SetValue(String("y"), Value(result.y));
-		return IntrinsicResult(resultMap);
+		return IntrinsicResult(Vector2ToValue(result, ARG("into")));
 	};
-	raylibModule.SetValue("GetSplinePointBasis", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetSplinePointBasis", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("p1");
@@ -1054,37 +1011,33 @@ void AddRShapesMethods(ValueDict raylibModule) {
 	i->AddParam("p3");
 	i->AddParam("p4");
 	i->AddParam("t");
+	i->AddParam("into");
 	i->code = INTRINSIC_LAMBDA {
-		Vector2 p1 = ValueToVector2(context->GetVar(String("p1")));
-		Vector2 p2 = ValueToVector2(context->GetVar(String("p2")));
-		Vector2 p3 = ValueToVector2(context->GetVar(String("p3")));
-		Vector2 p4 = ValueToVector2(context->GetVar(String("p4")));
-		float t = context->GetVar(String("t")).FloatValue();
+		Vector2 p1 = ValueToVector2(ARG("p1"));
+		Vector2 p2 = ValueToVector2(ARG("p2"));
+		Vector2 p3 = ValueToVector2(ARG("p3"));
+		Vector2 p4 = ValueToVector2(ARG("p4"));
+		float t = ARG("t").FloatValue();
 		Vector2 result = GetSplinePointCatmullRom(p1, p2, p3, p4, t);
-		ValueDict resultMap;
-		resultMap.SetValue(String("x"), Value(result.x));
-		resultMap.SetValue(String("y"), Value(result.y));
-		return IntrinsicResult(resultMap);
+		return IntrinsicResult(Vector2ToValue(result, ARG("into")));
 	};
-	raylibModule.SetValue("GetSplinePointCatmullRom", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetSplinePointCatmullRom", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("p1");
 	i->AddParam("c2");
 	i->AddParam("p3");
 	i->AddParam("t");
+	i->AddParam("into");
 	i->code = INTRINSIC_LAMBDA {
-		Vector2 p1 = ValueToVector2(context->GetVar(String("p1")));
-		Vector2 c2 = ValueToVector2(context->GetVar(String("c2")));
-		Vector2 p3 = ValueToVector2(context->GetVar(String("p3")));
-		float t = context->GetVar(String("t")).FloatValue();
+		Vector2 p1 = ValueToVector2(ARG("p1"));
+		Vector2 c2 = ValueToVector2(ARG("c2"));
+		Vector2 p3 = ValueToVector2(ARG("p3"));
+		float t = ARG("t").FloatValue();
 		Vector2 result = GetSplinePointBezierQuad(p1, c2, p3, t);
-		ValueDict resultMap;
-		resultMap.SetValue(String("x"), Value(result.x));
-		resultMap.SetValue(String("y"), Value(result.y));
-		return IntrinsicResult(resultMap);
+		return IntrinsicResult(Vector2ToValue(result, ARG("into")));
 	};
-	raylibModule.SetValue("GetSplinePointBezierQuad", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetSplinePointBezierQuad", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("p1");
@@ -1092,61 +1045,47 @@ void AddRShapesMethods(ValueDict raylibModule) {
 	i->AddParam("c3");
 	i->AddParam("p4");
 	i->AddParam("t");
+	i->AddParam("into");
 	i->code = INTRINSIC_LAMBDA {
-		Vector2 p1 = ValueToVector2(context->GetVar(String("p1")));
-		Vector2 c2 = ValueToVector2(context->GetVar(String("c2")));
-		Vector2 c3 = ValueToVector2(context->GetVar(String("c3")));
-		Vector2 p4 = ValueToVector2(context->GetVar(String("p4")));
-		float t = context->GetVar(String("t")).FloatValue();
+		Vector2 p1 = ValueToVector2(ARG("p1"));
+		Vector2 c2 = ValueToVector2(ARG("c2"));
+		Vector2 c3 = ValueToVector2(ARG("c3"));
+		Vector2 p4 = ValueToVector2(ARG("p4"));
+		float t = ARG("t").FloatValue();
 		Vector2 result = GetSplinePointBezierCubic(p1, c2, c3, p4, t);
-		ValueDict resultMap;
-		resultMap.SetValue(String("x"), Value(result.x));
-		resultMap.SetValue(String("y"), Value(result.y));
-		return IntrinsicResult(resultMap);
+		return IntrinsicResult(Vector2ToValue(result, ARG("into")));
 	};
-	raylibModule.SetValue("GetSplinePointBezierCubic", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetSplinePointBezierCubic", i);
 
 	// Additional triangle drawing
 
 	i = Intrinsic::Create("");
 	i->AddParam("points");
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		ValueList pointsList = context->GetVar(String("points")).GetList();
-		int pointCount = pointsList.Count();
+		PointArray points(ARG("points"));
+		int pointCount = points.count;
 		if (pointCount < 3) return IntrinsicResult::Null;
 
-		Vector2* points = new Vector2[pointCount];
-		for (int i = 0; i < pointCount; i++) {
-			points[i] = ValueToVector2(pointsList[i]);
-		}
-
-		Color color = ValueToColor(context->GetVar(String("color")));
-		DrawTriangleFan(points, pointCount, color);
-		delete[] points;
+		Color color = ValueToColor(ARG("color"));
+		DrawTriangleFan(points.data, pointCount, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawTriangleFan", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawTriangleFan", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("points");
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		ValueList pointsList = context->GetVar(String("points")).GetList();
-		int pointCount = pointsList.Count();
+		PointArray points(ARG("points"));
+		int pointCount = points.count;
 		if (pointCount < 3) return IntrinsicResult::Null;
 
-		Vector2* points = new Vector2[pointCount];
-		for (int i = 0; i < pointCount; i++) {
-			points[i] = ValueToVector2(pointsList[i]);
-		}
-
-		Color color = ValueToColor(context->GetVar(String("color")));
-		DrawTriangleStrip(points, pointCount, color);
-		delete[] points;
+		Color color = ValueToColor(ARG("color"));
+		DrawTriangleStrip(points.data, pointCount, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawTriangleStrip", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawTriangleStrip", i);
 
 	// Texture setup
 
@@ -1154,24 +1093,104 @@ void AddRShapesMethods(ValueDict raylibModule) {
 	i->AddParam("texture");
 	i->AddParam("source");
 	i->code = INTRINSIC_LAMBDA {
-		Texture texture = ValueToTexture(context->GetVar(String("texture")));
-		Rectangle source = ValueToRectangle(context->GetVar(String("source")));
+		Texture texture = ValueToTexture(ARG("texture"));
+		Rectangle source = ValueToRectangle(ARG("source"));
 		SetShapesTexture(texture, source);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("SetShapesTexture", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "SetShapesTexture", i);
 
 	i = Intrinsic::Create("");
 	i->code = INTRINSIC_LAMBDA {
 		Texture2D texture = GetShapesTexture();
-		return IntrinsicResult(TextureToValue(texture));
+		return IntrinsicResult(TextureToValue(texture, false));
 	};
-	raylibModule.SetValue("GetShapesTexture", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetShapesTexture", i);
 
 	i = Intrinsic::Create("");
+	i->AddParam("into");
 	i->code = INTRINSIC_LAMBDA {
 		Rectangle rect = GetShapesTextureRectangle();
-		return IntrinsicResult(RectangleToValue(rect));
+		return IntrinsicResult(RectangleToValue(rect, ARG("into")));
+	};
+	RegisterIntrinsic(raylibModule, "GetShapesTextureRectangle", i);
+
+	// Batch drawing (MSRLWeb extension): draw many shapes at once, from packed
+	// records in a RawData.  Positions and sizes are floats; colors are uints
+	// (0xRRGGBBAA).
+
+	// Pixel records (12 bytes): x, y, color
+	i = Intrinsic::Create("");
+	i->AddParam("data");
+	i->AddParam("count", -1);
+	i->AddParam("stride", 12);
+	i->code = INTRINSIC_LAMBDA {
+		int count = ARG("count").IntValue();
+		int stride = ARG("stride").IntValue();
+		BinaryData* data = ValueToRecordBuffer(ARG("data"), count, stride, 12, "DrawPixelBatch");
+		for (int n = 0, offset = 0; n < count; n++, offset += stride) {
+			Vector2 position = { data->GetFloat(offset), data->GetFloat(offset + 4) };
+			DrawPixelV(position, UnpackColor(data->GetUInt32(offset + 8)));
+		}
+		return IntrinsicResult::Null;
+	};
+	RegisterIntrinsic(raylibModule, "DrawPixelBatch", i);
+
+	// Line records (20 bytes): startX, startY, endX, endY, color
+	i = Intrinsic::Create("");
+	i->AddParam("data");
+	i->AddParam("count", -1);
+	i->AddParam("stride", 20);
+	i->AddParam("thick", 1);
+	i->code = INTRINSIC_LAMBDA {
+		int count = ARG("count").IntValue();
+		int stride = ARG("stride").IntValue();
+		float thick = ARG("thick").FloatValue();
+		BinaryData* data = ValueToRecordBuffer(ARG("data"), count, stride, 20, "DrawLineBatch");
+		for (int n = 0, offset = 0; n < count; n++, offset += stride) {
+			Vector2 startPos = { data->GetFloat(offset), data->GetFloat(offset + 4) };
+			Vector2 endPos = { data->GetFloat(offset + 8), data->GetFloat(offset + 12) };
+			Color color = UnpackColor(data->GetUInt32(offset + 16));
+			if (thick == 1) DrawLineV(startPos, endPos, color);
+			else DrawLineEx(startPos, endPos, thick, color);
+		}
+		return IntrinsicResult::Null;
+	};
+	RegisterIntrinsic(raylibModule, "DrawLineBatch", i);
+
+	// Circle records (16 bytes): centerX, centerY, radius, color
+	i = Intrinsic::Create("");
+	i->AddParam("data");
+	i->AddParam("count", -1);
+	i->AddParam("stride", 16);
+	i->code = INTRINSIC_LAMBDA {
+		int count = ARG("count").IntValue();
+		int stride = ARG("stride").IntValue();
+		BinaryData* data = ValueToRecordBuffer(ARG("data"), count, stride, 16, "DrawCircleBatch");
+		for (int n = 0, offset = 0; n < count; n++, offset += stride) {
+			Vector2 center = { data->GetFloat(offset), data->GetFloat(offset + 4) };
+			float radius = data->GetFloat(offset + 8);
+			DrawCircleV(center, radius, UnpackColor(data->GetUInt32(offset + 12)));
+		}
+		return IntrinsicResult::Null;
+	};
+	RegisterIntrinsic(raylibModule, "DrawCircleBatch", i);
+
+	// Rectangle records (20 bytes): x, y, width, height, color
+	i = Intrinsic::Create("");
+	i->AddParam("data");
+	i->AddParam("count", -1);
+	i->AddParam("stride", 20);
+	i->code = INTRINSIC_LAMBDA {
+		int count = ARG("count").IntValue();
+		int stride = ARG("stride").IntValue();
+		BinaryData* data = ValueToRecordBuffer(ARG("data"), count, stride, 20, "DrawRectangleBatch");
+		for (int n = 0, offset = 0; n < count; n++, offset += stride) {
+			Rectangle rec = { data->GetFloat(offset), data->GetFloat(offset + 4),
+				data->GetFloat(offset + 8), data->GetFloat(offset + 12) };
+			DrawRectangleRec(rec, UnpackColor(data->GetUInt32(offset + 16)));
+		}
+		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("GetShapesTextureRectangle", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawRectangleBatch", i);
 }
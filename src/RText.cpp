@@ -12,10 +12,21 @@
 #include "MiniscriptInterpreter.h"
 #include "MiniscriptTypes.h"
 #include "UnicodeUtil.h"
+#include "loadfile.h"
+#include "asyncload.h"
+#include <vector>
 #include "macros.h"
 
 using namespace MiniScript;
 
+// Helper: get a preloaded TrueType/OpenType font file, so it can be loaded
+// straight from there with LoadFontFromMemory (other font formats are
+// left to LoadFont/LoadFontEx); returns nullptr if not applicable
+static const unsigned char *GetPreloadedFontFile(const char *fileName, int *size) {
+	if (!IsFileExtension(fileName, ".ttf;.otf")) return nullptr;
+	return GetPreloadedFile(fileName, size);
+}
+
 // Helper function to extract codepoints from either a list of ints or a UTF-8 string
 // Returns allocated int array of codepoints, or nullptr if value is null
 // Sets codepointCount to the number of codepoints
@@ -82,12 +93,16 @@ void AddRTextMethods(ValueDict raylibModule) {
 	i = Intrinsic::Create("");
 	i->AddParam("fileName");
 	i->code = INTRINSIC_LAMBDA {
-		String path = context->GetVar(String("fileName")).ToString();
-		Font font = LoadFont(path.c_str());
+		String path = ARG("fileName").ToString();
+		if (!WaitForFile(path, partialResult)) return partialResult;
+		int size;
+		const unsigned char *data = GetPreloadedFontFile(path.c_str(), &size);
+		Font font = data ? LoadFontFromMemory(GetFileExtension(path.c_str()), data, size, 32, nullptr, 0)	// (32 = raylib's default TTF size)
+			: LoadFont(path.c_str());
 		if (!IsFontValid(font)) return IntrinsicResult::Null;
 		return IntrinsicResult(FontToValue(font));
 	};
-	raylibModule.SetValue("LoadFont", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "LoadFont", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("fileName");
@@ -95,31 +110,74 @@ void AddRTextMethods(ValueDict raylibModule) {
 	i->AddParam("codepoints", Value::null);
 	i->AddParam("codepointCount", Value::zero);
 	i->code = INTRINSIC_LAMBDA {
-		String path = context->GetVar(String("fileName")).ToString();
-		int fontSize = context->GetVar(String("fontSize")).IntValue();
-		Value codepointsVal = context->GetVar(String("codepoints"));
+		String path = ARG("fileName").ToString();
+		if (!WaitForFile(path, partialResult)) return partialResult;
+		int fontSize = ARG("fontSize").IntValue();
+		Value codepointsVal = ARG("codepoints");
 
 		// Support both list of ints and UTF-8 string for codepoints
 		int codepointCount = 0;
 		int* codepoints = GetCodepointsFromValue(codepointsVal, &codepointCount);
 
-		Font font = LoadFontEx(path.c_str(), fontSize, codepoints, codepointCount);
+		int size;
+		const unsigned char *data = GetPreloadedFontFile(path.c_str(), &size);
+		Font font = data ? LoadFontFromMemory(GetFileExtension(path.c_str()), data, size, fontSize, codepoints, codepointCount)
+			: LoadFontEx(path.c_str(), fontSize, codepoints, codepointCount);
 
 		if (codepoints) delete[] codepoints;
 
 		if (!IsFontValid(font)) return IntrinsicResult::Null;
 		return IntrinsicResult(FontToValue(font));
 	};
-	raylibModule.SetValue("LoadFontEx", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "LoadFontEx", i);
+
+	i = Intrinsic::Create("");
+	i->AddParam("fileName");
+	i->AddParam("fontSize", Value(32));
+	i->AddParam("codepoints", Value::null);
+	i->code = INTRINSIC_LAMBDA {
+		String path = ARG("fileName").ToString();
+		int fontSize = ARG("fontSize").IntValue();
+		bool isTTF = IsFileExtension(path.c_str(), ".ttf;.otf");
+		if (!isTTF && !IsFileExtension(path.c_str(), ".png;.bmp;.qoi")) {
+			RuntimeException("LoadFontAsync: only TTF/OTF and image fonts can be loaded asynchronously").raise();
+		}
+		const char *ext = GetFileExtension(path.c_str());
+		String fileType = ext ? ext : "";
+
+		int codepointCount = 0;
+		int* codepointArray = GetCodepointsFromValue(ARG("codepoints"), &codepointCount);
+		std::vector<int> codepoints(codepointArray, codepointArray + codepointCount);
+		if (codepointArray) delete[] codepointArray;
+
+		long handle = StartAsyncLoad(path.c_str(), [fileType, isTTF, fontSize, codepoints](const unsigned char *data, int size) -> Value {
+			Font font;
+			if (isTTF) {
+				std::vector<int> cps(codepoints);
+				font = LoadFontFromMemory(fileType.c_str(), data, size, fontSize,
+					cps.empty() ? nullptr : cps.data(), (int)cps.size());
+			} else {
+				// Image font, as raylib's LoadFont does it
+				Image img = LoadImageFromMemory(fileType.c_str(), data, size);
+				if (!IsImageValid(img)) return Value::null;
+				font = LoadFontFromImage(img, MAGENTA, 32);
+				UnloadImage(img);
+			}
+			if (!IsFontValid(font)) return Value::null;
+			return FontToValue(font);
+		});
+		return IntrinsicResult(Value((double)handle));
+	};
+	RegisterIntrinsic(raylibModule, "LoadFontAsync", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("image");
-	i->AddParam("key", ColorToValue(Color{255, 0, 255, 255}));
+	i->AddParam("key", DefaultColorValue(Color{255, 0, 255, 255}));
 	i->AddParam("firstChar", Value(32));
 	i->code = INTRINSIC_LAMBDA {
-		Image image = ValueToImage(context->GetVar(String("image")));
-		Color key = ValueToColor(context->GetVar(String("key")));
-		Value firstCharVal = context->GetVar(String("firstChar"));
+		Image image = ValueToImage(ARG("image"));
+		Color key = ValueToColor(ARG("key"));
+		Value firstCharVal = ARG("firstChar");
 		int firstChar;
 		if (firstCharVal.type == ValueType::String) {
 			String s = firstCharVal.ToString();
@@ -130,29 +188,25 @@ void AddRTextMethods(ValueDict raylibModule) {
 		Font font = LoadFontFromImage(image, key, firstChar);
 		return IntrinsicResult(FontToValue(font));
 	};
-	raylibModule.SetValue("LoadFontFromImage", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "LoadFontFromImage", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("font");
 	i->code = INTRINSIC_LAMBDA {
-		Font font = ValueToFont(context->GetVar(String("font")));
+		Font font = ValueToFont(ARG("font"));
 		return IntrinsicResult(IsFontValid(font));
 	};
-	raylibModule.SetValue("IsFontValid", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "IsFontValid", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("font");
 	i->code = INTRINSIC_LAMBDA {
-		Font font = ValueToFont(context->GetVar(String("font")));
+		Font font = ValueToFont(ARG("font"));
 		UnloadFont(font);
-		// Free the heap-allocated Font struct
-		ValueDict map = context->GetVar(String("font")).GetDict();
-		Value handleVal = map.Lookup(String("_handle"), Value::zero);
-		Font* fontPtr = (Font*)(long)handleVal.IntValue();
-		delete fontPtr;
+		ReleaseFont(ARG("font"));
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("UnloadFont", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "UnloadFont", i);
 
 	// Text drawing
 
@@ -160,88 +214,88 @@ void AddRTextMethods(ValueDict raylibModule) {
 	i->AddParam("posX", Value::zero);
 	i->AddParam("posY", Value::zero);
 	i->code = INTRINSIC_LAMBDA {
-		int posX = context->GetVar(String("posX")).IntValue();
-		int posY = context->GetVar(String("posY")).IntValue();
+		int posX = ARG("posX").IntValue();
+		int posY = ARG("posY").IntValue();
 		DrawFPS(posX, posY);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawFPS", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawFPS", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("text");
 	i->AddParam("posX", Value::zero);
 	i->AddParam("posY", Value::zero);
 	i->AddParam("fontSize", Value(20));
-	i->AddParam("color", ColorToValue(BLACK));
+	i->AddParam("color", DefaultColorValue(BLACK));
 	i->code = INTRINSIC_LAMBDA {
-		String text = context->GetVar(String("text")).ToString();
-		int posX = context->GetVar(String("posX")).IntValue();
-		int posY = context->GetVar(String("posY")).IntValue();
-		int fontSize = context->GetVar(String("fontSize")).IntValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+		String text = ARG("text").ToString();
+		int posX = ARG("posX").IntValue();
+		int posY = ARG("posY").IntValue();
+		int fontSize = ARG("fontSize").IntValue();
+		Color color = ValueToColor(ARG("color"));
 		DrawText(text.c_str(), posX, posY, fontSize, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawText", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawText", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("font");
 	i->AddParam("text");
-	i->AddParam("position", Vector2ToValue(Vector2{0, 0}));
+	i->AddParam("position", DefaultVector2Value(Vector2{0, 0}));
 	i->AddParam("fontSize", Value(20));
 	i->AddParam("spacing", Value::zero);
-	i->AddParam("tint", ColorToValue(BLACK));
-	i->code = INTRINSIC_LAMBDA {
-		Font font = ValueToFont(context->GetVar(String("font")));
-		String text = context->GetVar(String("text")).ToString();
-		Vector2 position = ValueToVector2(context->GetVar(String("position")));
-		float fontSize = context->GetVar(String("fontSize")).FloatValue();
-		float spacing = context->GetVar(String("spacing")).FloatValue();
-		Color tint = ValueToColor(context->GetVar(String("tint")));
+	i->AddParam("tint", DefaultColorValue(BLACK));
+	i->code = INTRINSIC_LAMBDA {
+		Font font = ValueToFont(ARG("font"));
+		String text = ARG("text").ToString();
+		Vector2 position = ValueToVector2(ARG("position"));
+		float fontSize = ARG("fontSize").FloatValue();
+		float spacing = ARG("spacing").FloatValue();
+		Color tint = ValueToColor(ARG("tint"));
 		DrawTextEx(font, text.c_str(), position, fontSize, spacing, tint);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawTextEx", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawTextEx", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("font");
 	i->AddParam("text");
-	i->AddParam("position", Vector2ToValue(Vector2{0, 0}));
-	i->AddParam("origin", Vector2ToValue(Vector2{0, 0}));
+	i->AddParam("position", DefaultVector2Value(Vector2{0, 0}));
+	i->AddParam("origin", DefaultVector2Value(Vector2{0, 0}));
 	i->AddParam("rotation", Value::zero);
 	i->AddParam("fontSize", Value(20));
 	i->AddParam("spacing", Value::zero);
-	i->AddParam("tint", ColorToValue(BLACK));
-	i->code = INTRINSIC_LAMBDA {
-		Font font = ValueToFont(context->GetVar(String("font")));
-		String text = context->GetVar(String("text")).ToString();
-		Vector2 position = ValueToVector2(context->GetVar(String("position")));
-		Vector2 origin = ValueToVector2(context->GetVar(String("origin")));
-		float rotation = context->GetVar(String("rotation")).FloatValue();
-		float fontSize = context->GetVar(String("fontSize")).FloatValue();
-		float spacing = context->GetVar(String("spacing")).FloatValue();
-		Color tint = ValueToColor(context->GetVar(String("tint")));
+	i->AddParam("tint", DefaultColorValue(BLACK));
+	i->code = INTRINSIC_LAMBDA {
+		Font font = ValueToFont(ARG("font"));
+		String text = ARG("text").ToString();
+		Vector2 position = ValueToVector2(ARG("position"));
+		Vector2 origin = ValueToVector2(ARG("origin"));
+		float rotation = ARG("rotation").FloatValue();
+		float fontSize = ARG("fontSize").FloatValue();
+		float spacing = ARG("spacing").FloatValue();
+		Color tint = ValueToColor(ARG("tint"));
 		DrawTextPro(font, text.c_str(), position, origin, rotation, fontSize, spacing, tint);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawTextPro", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawTextPro", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("font");
 	i->AddParam("codepoint");
-	i->AddParam("position", Vector2ToValue(Vector2{0, 0}));
+	i->AddParam("position", DefaultVector2Value(Vector2{0, 0}));
 	i->AddParam("fontSize", Value(20));
-	i->AddParam("tint", ColorToValue(BLACK));
+	i->AddParam("tint", DefaultColorValue(BLACK));
 	i->code = INTRINSIC_LAMBDA {
-		Font font = ValueToFont(context->GetVar(String("font")));
-		int codepoint = context->GetVar(String("codepoint")).IntValue();
-		Vector2 position = ValueToVector2(context->GetVar(String("position")));
-		float fontSize = context->GetVar(String("fontSize")).FloatValue();
-		Color tint = ValueToColor(context->GetVar(String("tint")));
+		Font font = ValueToFont(ARG("font"));
+		int codepoint = ARG("codepoint").IntValue();
+		Vector2 position = ValueToVector2(ARG("position"));
+		float fontSize = ARG("fontSize").FloatValue();
+		Color tint = ValueToColor(ARG("tint"));
 		DrawTextCodepoint(font, codepoint, position, fontSize, tint);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawTextCodepoint", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawTextCodepoint", i);
 
 	// Text measurement
 
@@ -249,12 +303,12 @@ void AddRTextMethods(ValueDict raylibModule) {
 	i->AddParam("text");
 	i->AddParam("fontSize", Value(20));
 	i->code = INTRINSIC_LAMBDA {
-		String text = context->GetVar(String("text")).ToString();
-		int fontSize = context->GetVar(String("fontSize")).IntValue();
+		String text = ARG("text").ToString();
+		int fontSize = ARG("fontSize").IntValue();
 		int width = MeasureText(text.c_str(), fontSize);
 		return IntrinsicResult(Value(width));
 	};
-	raylibModule.SetValue("MeasureText", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "MeasureText", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("font");
@@ -262,62 +316,63 @@ void AddRTextMethods(ValueDict raylibModule) {
 	i->AddParam("fontSize", Value(20));
 	i->AddParam("spacing", Value::zero);
 	i->code = INTRINSIC_LAMBDA {
-		Font font = ValueToFont(context->GetVar(String("font")));
-		String text = context->GetVar(String("text")).ToString();
-		float fontSize = context->GetVar(String("fontSize")).FloatValue();
-		float spacing = context->GetVar(String("spacing")).FloatValue();
+		Font font = ValueToFont(ARG("font"));
+		String text = ARG("text").ToString();
+		float fontSize = ARG("fontSize").FloatValue();
+		float spacing = ARG("spacing").FloatValue();
 		Vector2 size = MeasureTextEx(font, text.c_str(), fontSize, spacing);
 		Value result = Vector2ToValue(size);
 		return IntrinsicResult(Value(result));
 	};
-	raylibModule.SetValue("MeasureTextEx", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "MeasureTextEx", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("font");
 	i->AddParam("codepoint");
 	i->code = INTRINSIC_LAMBDA {
-		Font font = ValueToFont(context->GetVar(String("font")));
-		int codepoint = context->GetVar(String("codepoint")).IntValue();
+		Font font = ValueToFont(ARG("font"));
+		int codepoint = ARG("codepoint").IntValue();
 		int index = GetGlyphIndex(font, codepoint);
 		return IntrinsicResult(Value(index));
 	};
-	raylibModule.SetValue("GetGlyphIndex", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetGlyphIndex", i);
 
 	// Additional font and text functions
 
 	i = Intrinsic::Create("");
 	i->code = INTRINSIC_LAMBDA {
 		Font font = GetFontDefault();
-		return IntrinsicResult(FontToValue(font));
+		return IntrinsicResult(FontToValue(font, false));
 	};
-	raylibModule.SetValue("GetFontDefault", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetFontDefault", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("spacing");
 	i->code = INTRINSIC_LAMBDA {
-		int spacing = context->GetVar(String("spacing")).IntValue();
+		int spacing = ARG("spacing").IntValue();
 		SetTextLineSpacing(spacing);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("SetTextLineSpacing", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "SetTextLineSpacing", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("font");
 	i->AddParam("codepoint");
+	i->AddParam("into");
 	i->code = INTRINSIC_LAMBDA {
-		Font font = ValueToFont(context->GetVar(String("font")));
-		int codepoint = context->GetVar(String("codepoint")).IntValue();
+		Font font = ValueToFont(ARG("font"));
+		int codepoint = ARG("codepoint").IntValue();
 		Rectangle rec = GetGlyphAtlasRec(font, codepoint);
-		return IntrinsicResult(RectangleToValue(rec));
+		return IntrinsicResult(RectangleToValue(rec, ARG("into")));
 	};
-	raylibModule.SetValue("GetGlyphAtlasRec", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetGlyphAtlasRec", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("font");
 	i->AddParam("codepoint");
 	i->code = INTRINSIC_LAMBDA {
-		Font font = ValueToFont(context->GetVar(String("font")));
-		int codepoint = context->GetVar(String("codepoint")).IntValue();
+		Font font = ValueToFont(ARG("font"));
+		int codepoint = ARG("codepoint").IntValue();
 		GlyphInfo info = GetGlyphInfo(font, codepoint);
 
 		ValueDict result;
@@ -325,27 +380,28 @@ void AddRTextMethods(ValueDict raylibModule) {
 		result.SetValue(String("offsetX"), Value(info.offsetX));
 		result.SetValue(String("offsetY"), Value(info.offsetY));
 		result.SetValue(String("advanceX"), Value(info.advanceX));
-		result.SetValue(String("image"), ImageToValue(info.image));
+		// (The glyph's image belongs to the font, and is unloaded with it.)
+		result.SetValue(String("image"), ImageToValue(info.image, false));
 		return IntrinsicResult(result);
 	};
-	raylibModule.SetValue("GetGlyphInfo", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetGlyphInfo", i);
 
 	// UTF-8 and codepoint functions
 
 	i = Intrinsic::Create("");
 	i->AddParam("text");
 	i->code = INTRINSIC_LAMBDA {
-		String text = context->GetVar(String("text")).ToString();
+		String text = ARG("text").ToString();
 		int count = GetCodepointCount(text.c_str());
 		return IntrinsicResult(Value(count));
 	};
-	raylibModule.SetValue("GetCodepointCount", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetCodepointCount", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("text");
 	i->AddParam("codepointSize", Value::null);
 	i->code = INTRINSIC_LAMBDA {
-		String text = context->GetVar(String("text")).ToString();
+		String text = ARG("text").ToString();
 		int codepointSize = 0;
 		int codepoint = GetCodepoint(text.c_str(), &codepointSize);
 
@@ -354,13 +410,13 @@ void AddRTextMethods(ValueDict raylibModule) {
 		result.SetValue(String("codepointSize"), Value(codepointSize));
 		return IntrinsicResult(result);
 	};
-	raylibModule.SetValue("GetCodepoint", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetCodepoint", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("text");
 	i->AddParam("codepointSize", Value::null);
 	i->code = INTRINSIC_LAMBDA {
-		String text = context->GetVar(String("text")).ToString();
+		String text = ARG("text").ToString();
 		int codepointSize = 0;
 		int codepoint = GetCodepointNext(text.c_str(), &codepointSize);
 
@@ -369,13 +425,13 @@ void AddRTextMethods(ValueDict raylibModule) {
 		result.SetValue(String("codepointSize"), Value(codepointSize));
 		return IntrinsicResult(result);
 	};
-	raylibModule.SetValue("GetCodepointNext", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetCodepointNext", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("text");
 	i->AddParam("codepointSize", Value::null);
 	i->code = INTRINSIC_LAMBDA {
-		String text = context->GetVar(String("text")).ToString();
+		String text = ARG("text").ToString();
 		int codepointSize = 0;
 		int codepoint = GetCodepointPrevious(text.c_str(), &codepointSize);
 
@@ -384,48 +440,48 @@ void AddRTextMethods(ValueDict raylibModule) {
 		result.SetValue(String("codepointSize"), Value(codepointSize));
 		return IntrinsicResult(result);
 	};
-	raylibModule.SetValue("GetCodepointPrevious", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetCodepointPrevious", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("codepoint");
 	i->code = INTRINSIC_LAMBDA {
-		int codepoint = context->GetVar(String("codepoint")).IntValue();
+		int codepoint = ARG("codepoint").IntValue();
 		int utf8Size = 0;
 		const char* utf8 = CodepointToUTF8(codepoint, &utf8Size);
 		return IntrinsicResult(Value(String(utf8, utf8Size)));
 	};
-	raylibModule.SetValue("CodepointToUTF8", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "CodepointToUTF8", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("text1");
 	i->AddParam("text2");
 	i->code = INTRINSIC_LAMBDA {
-		String text1 = context->GetVar(String("text1")).ToString();
-		String text2 = context->GetVar(String("text2")).ToString();
+		String text1 = ARG("text1").ToString();
+		String text2 = ARG("text2").ToString();
 		bool equal = TextIsEqual(text1.c_str(), text2.c_str());
 		return IntrinsicResult(Value(equal));
 	};
-	raylibModule.SetValue("TextIsEqual", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "TextIsEqual", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("text");
 	i->code = INTRINSIC_LAMBDA {
-		String text = context->GetVar(String("text")).ToString();
+		String text = ARG("text").ToString();
 		unsigned int length = TextLength(text.c_str());
 		return IntrinsicResult(Value((int)length));
 	};
-	raylibModule.SetValue("TextLength", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "TextLength", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("dst");
 	i->AddParam("src");
 	i->code = INTRINSIC_LAMBDA {
-		String src = context->GetVar(String("src")).ToString();
+		String src = ARG("src").ToString();
 		// MiniScript strings are immutable, so we just return the source string
 		// The actual TextCopy in raylib copies to a pre-allocated buffer
 		return IntrinsicResult(Value(src));
 	};
-	raylibModule.SetValue("TextCopy", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "TextCopy", i);
 
 	// Memory-related functions
 
@@ -436,12 +492,12 @@ void AddRTextMethods(ValueDict raylibModule) {
 	i->AddParam("codepoints", Value::null);
 	i->AddParam("codepointCount", Value::zero);
 	i->code = INTRINSIC_LAMBDA {
-		String fileType = context->GetVar(String("fileType")).ToString();
-		BinaryData* data = ValueToRawData(context->GetVar(String("fileData")));
+		String fileType = ARG("fileType").ToString();
+		BinaryData* data = ValueToRawData(ARG("fileData"));
 		if (!data) return IntrinsicResult::Null;
 
-		int fontSize = context->GetVar(String("fontSize")).IntValue();
-		Value codepointsVal = context->GetVar(String("codepoints"));
+		int fontSize = ARG("fontSize").IntValue();
+		Value codepointsVal = ARG("codepoints");
 		int codepointCount = 0;
 
 		// Support both list of ints and UTF-8 string for codepoints
@@ -454,7 +510,7 @@ void AddRTextMethods(ValueDict raylibModule) {
 		if (!IsFontValid(font)) return IntrinsicResult::Null;
 		return IntrinsicResult(FontToValue(font));
 	};
-	raylibModule.SetValue("LoadFontFromMemory", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "LoadFontFromMemory", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("fileData");
@@ -463,12 +519,12 @@ void AddRTextMethods(ValueDict raylibModule) {
 	i->AddParam("codepointCount", Value::zero);
 	i->AddParam("type", Value::zero);  // FONT_DEFAULT
 	i->code = INTRINSIC_LAMBDA {
-		BinaryData* data = ValueToRawData(context->GetVar(String("fileData")));
+		BinaryData* data = ValueToRawData(ARG("fileData"));
 		if (!data) return IntrinsicResult::Null;
 
-		int fontSize = context->GetVar(String("fontSize")).IntValue();
-		Value codepointsVal = context->GetVar(String("codepoints"));
-		int type = context->GetVar(String("type")).IntValue();
+		int fontSize = ARG("fontSize").IntValue();
+		Value codepointsVal = ARG("codepoints");
+		int type = ARG("type").IntValue();
 
 		// Support both list of ints and UTF-8 string for codepoints
 		int codepointCount = 0;
@@ -484,7 +540,8 @@ void AddRTextMethods(ValueDict raylibModule) {
 
 		if (codepoints) delete[] codepoints;
 
-		// Convert to MiniScript list
+		// Convert to MiniScript list.  Each glyph's image is now owned by its
+		// map, so we free only the array that held them.
 		ValueList result;
 		if (glyphs) {
 			for (int i = 0; i < glyphCount; i++) {
@@ -496,10 +553,11 @@ void AddRTextMethods(ValueDict raylibModule) {
 				glyphDict.SetValue(String("image"), ImageToValue(glyphs[i].image));
 				result.Add(Value(glyphDict));
 			}
+			MemFree(glyphs);
 		}
 		return IntrinsicResult(Value(result));
 	};
-	raylibModule.SetValue("LoadFontData", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "LoadFontData", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("glyphs");
@@ -509,12 +567,12 @@ void AddRTextMethods(ValueDict raylibModule) {
 		// This is a no-op for our purposes
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("UnloadFontData", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "UnloadFontData", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("text");
 	i->code = INTRINSIC_LAMBDA {
-		String text = context->GetVar(String("text")).ToString();
+		String text = ARG("text").ToString();
 		int count = 0;
 		int* codepoints = LoadCodepoints(text.c_str(), &count);
 
@@ -528,7 +586,7 @@ void AddRTextMethods(ValueDict raylibModule) {
 		}
 		return IntrinsicResult(Value(result));
 	};
-	raylibModule.SetValue("LoadCodepoints", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "LoadCodepoints", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("codepoints");
@@ -537,12 +595,12 @@ void AddRTextMethods(ValueDict raylibModule) {
 		// We don't need to explicitly free it as MiniScript manages the memory
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("UnloadCodepoints", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "UnloadCodepoints", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("codepoints");
 	i->code = INTRINSIC_LAMBDA {
-		Value codepointsVal = context->GetVar(String("codepoints"));
+		Value codepointsVal = ARG("codepoints");
 
 		// Support both list of ints and UTF-8 string for codepoints
 		int count = 0;
@@ -556,7 +614,7 @@ void AddRTextMethods(ValueDict raylibModule) {
 
 		return IntrinsicResult(Value(result));
 	};
-	raylibModule.SetValue("LoadUTF8", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "LoadUTF8", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("text");
@@ -565,22 +623,22 @@ void AddRTextMethods(ValueDict raylibModule) {
 		// We don't need to explicitly free it as MiniScript manages the memory
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("UnloadUTF8", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "UnloadUTF8", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("font");
 	i->AddParam("codepoints");
-	i->AddParam("position", Vector2ToValue(Vector2{0, 0}));
+	i->AddParam("position", DefaultVector2Value(Vector2{0, 0}));
 	i->AddParam("fontSize", Value(20));
 	i->AddParam("spacing", Value::zero);
-	i->AddParam("tint", ColorToValue(BLACK));
+	i->AddParam("tint", DefaultColorValue(BLACK));
 	i->code = INTRINSIC_LAMBDA {
-		Font font = ValueToFont(context->GetVar(String("font")));
-		Value codepointsVal = context->GetVar(String("codepoints"));
-		Vector2 position = ValueToVector2(context->GetVar(String("position")));
-		float fontSize = context->GetVar(String("fontSize")).FloatValue();
-		float spacing = context->GetVar(String("spacing")).FloatValue();
-		Color tint = ValueToColor(context->GetVar(String("tint")));
+		Font font = ValueToFont(ARG("font"));
+		Value codepointsVal = ARG("codepoints");
+		Vector2 position = ValueToVector2(ARG("position"));
+		float fontSize = ARG("fontSize").FloatValue();
+		float spacing = ARG("spacing").FloatValue();
+		Color tint = ValueToColor(ARG("tint"));
 
 		// Support both list of ints and UTF-8 string for codepoints
 		int count = 0;
@@ -592,7 +650,7 @@ void AddRTextMethods(ValueDict raylibModule) {
 
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawTextCodepoints", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawTextCodepoints", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("glyphs");
@@ -601,11 +659,11 @@ void AddRTextMethods(ValueDict raylibModule) {
 	i->AddParam("padding");
 	i->AddParam("packMethod");
 	i->code = INTRINSIC_LAMBDA {
-		ValueList glyphsList = context->GetVar(String("glyphs")).GetList();
-		ValueList recsList = context->GetVar(String("glyphRecs")).GetList();
-		int fontSize = context->GetVar(String("fontSize")).IntValue();
-		int padding = context->GetVar(String("padding")).IntValue();
-		int packMethod = context->GetVar(String("packMethod")).IntValue();
+		ValueList glyphsList = ARG("glyphs").GetList();
+		ValueList recsList = ARG("glyphRecs").GetList();
+		int fontSize = ARG("fontSize").IntValue();
+		int padding = ARG("padding").IntValue();
+		int packMethod = ARG("packMethod").IntValue();
 
 		int glyphCount = glyphsList.Count();
 		if (glyphCount == 0 || glyphCount != recsList.Count()) return IntrinsicResult::Null;
@@ -637,14 +695,14 @@ void AddRTextMethods(ValueDict raylibModule) {
 
 		return IntrinsicResult(ImageToValue(atlas));
 	};
-	raylibModule.SetValue("GenImageFontAtlas", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GenImageFontAtlas", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("text");
 	i->AddParam("args", Value(ValueList()));
 	i->code = INTRINSIC_LAMBDA {
-		String text = context->GetVar(String("text")).ToString();
-		ValueList args = context->GetVar(String("args")).GetList();
+		String text = ARG("text").ToString();
+		ValueList args = ARG("args").GetList();
 
 		// Simple implementation: replace %s, %d, %f with args in order
 		std::string result = text.c_str();
@@ -681,7 +739,7 @@ void AddRTextMethods(ValueDict raylibModule) {
 
 		return IntrinsicResult(Value(String(result.c_str())));
 	};
-	raylibModule.SetValue("TextFormat", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "TextFormat", i);
 
 	// Text manipulation functions
 
@@ -689,12 +747,12 @@ void AddRTextMethods(ValueDict raylibModule) {
 	i->AddParam("text");
 	i->AddParam("search");
 	i->code = INTRINSIC_LAMBDA {
-		const char* text = context->GetVar(String("text")).ToString().c_str();
-		const char* search = context->GetVar(String("search")).ToString().c_str();
+		const char* text = ARG("text").ToString().c_str();
+		const char* search = ARG("search").ToString().c_str();
 		int result = TextFindIndex(text, search);
 		return IntrinsicResult(result);
 	};
-	raylibModule.SetValue("TextFindIndex", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "TextFindIndex", i);
 
 #if RAYLIB_VERSION_GT(5, 5)
 	i = Intrinsic::Create("");
@@ -702,15 +760,15 @@ void AddRTextMethods(ValueDict raylibModule) {
 	i->AddParam("begin");
 	i->AddParam("end");
 	i->code = INTRINSIC_LAMBDA {
-		String textStr = context->GetVar(String("text")).ToString();
-		String beginStr = context->GetVar(String("begin")).ToString();
-		String endStr = context->GetVar(String("end")).ToString();
+		String textStr = ARG("text").ToString();
+		String beginStr = ARG("begin").ToString();
+		String endStr = ARG("end").ToString();
 		char* result = GetTextBetween(textStr.c_str(), beginStr.c_str(), endStr.c_str());
 		String ret(result);
 		MemFree(result);
 		return IntrinsicResult(ret);
 	};
-	raylibModule.SetValue("GetTextBetween", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetTextBetween", i);
 #endif /* RAYLIB_VERSION_GT(5, 5) */
 
 	i = Intrinsic::Create("");
@@ -718,15 +776,15 @@ void AddRTextMethods(ValueDict raylibModule) {
 	i->AddParam("search");
 	i->AddParam("replacement");
 	i->code = INTRINSIC_LAMBDA {
-		String textStr = context->GetVar(String("text")).ToString();
-		String searchStr = context->GetVar(String("search")).ToString();
-		String replacementStr = context->GetVar(String("replacement")).ToString();
+		String textStr = ARG("text").ToString();
+		String searchStr = ARG("search").ToString();
+		String replacementStr = ARG("replacement").ToString();
 		char* result = TextReplace(textStr.c_str(), searchStr.c_str(), replacementStr.c_str());
 		String ret(result);
 		MemFree(result);
 		return IntrinsicResult(ret);
 	};
-	raylibModule.SetValue("TextReplace", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "TextReplace", i);
 
 #if RAYLIB_VERSION_GT(5, 5)
 	i = Intrinsic::Create("");
@@ -735,16 +793,16 @@ void AddRTextMethods(ValueDict raylibModule) {
 	i->AddParam("end");
 	i->AddParam("replacement");
 	i->code = INTRINSIC_LAMBDA {
-		String textStr = context->GetVar(String("text")).ToString();
-		String beginStr = context->GetVar(String("begin")).ToString();
-		String endStr = context->GetVar(String("end")).ToString();
-		String replacementStr = context->GetVar(String("replacement")).ToString();
+		String textStr = ARG("text").ToString();
+		String beginStr = ARG("begin").ToString();
+		String endStr = ARG("end").ToString();
+		String replacementStr = ARG("replacement").ToString();
 		char* result = TextReplaceBetween(textStr.c_str(), beginStr.c_str(), endStr.c_str(), replacementStr.c_str());
 		String ret(result);
 		MemFree(result);
 		return IntrinsicResult(ret);
 	};
-	raylibModule.SetValue("TextReplaceBetween", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "TextReplaceBetween", i);
 #endif /* RAYLIB_VERSION_GT(5, 5) */
 
 	i = Intrinsic::Create("");
@@ -752,22 +810,22 @@ void AddRTextMethods(ValueDict raylibModule) {
 	i->AddParam("insert");
 	i->AddParam("position");
 	i->code = INTRINSIC_LAMBDA {
-		String textStr = context->GetVar(String("text")).ToString();
-		String insertStr = context->GetVar(String("insert")).ToString();
-		int position = context->GetVar(String("position")).IntValue();
+		String textStr = ARG("text").ToString();
+		String insertStr = ARG("insert").ToString();
+		int position = ARG("position").IntValue();
 		char* result = TextInsert(textStr.c_str(), insertStr.c_str(), position);
 		String ret(result);
 		MemFree(result);
 		return IntrinsicResult(ret);
 	};
-	raylibModule.SetValue("TextInsert", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "TextInsert", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("text");
 	i->AddParam("delimiter");
 	i->code = INTRINSIC_LAMBDA {
-		String textStr = context->GetVar(String("text")).ToString();
-		String delimiterStr = context->GetVar(String("delimiter")).ToString();
+		String textStr = ARG("text").ToString();
+		String delimiterStr = ARG("delimiter").ToString();
 		if (delimiterStr.LengthB() == 0) return IntrinsicResult(Value::null);
 
 		char delimiter = delimiterStr.data()[0];
@@ -780,14 +838,14 @@ void AddRTextMethods(ValueDict raylibModule) {
 		}
 		return IntrinsicResult(result);
 	};
-	raylibModule.SetValue("TextSplit", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "TextSplit", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("textList");
 	i->AddParam("delimiter", "");
 	i->code = INTRINSIC_LAMBDA {
-		ValueList textList = context->GetVar(String("textList")).GetList();
-		String delimiterStr = context->GetVar(String("delimiter")).ToString();
+		ValueList textList = ARG("textList").GetList();
+		String delimiterStr = ARG("delimiter").ToString();
 
 		int count = textList.Count();
 		if (count == 0) return IntrinsicResult(String());
@@ -802,86 +860,86 @@ void AddRTextMethods(ValueDict raylibModule) {
 		delete[] parts;
 		return IntrinsicResult(ret);
 	};
-	raylibModule.SetValue("TextJoin", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "TextJoin", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("text");
 	i->AddParam("append");
 	i->code = INTRINSIC_LAMBDA {
-		String textStr = context->GetVar(String("text")).ToString();
-		String appendStr = context->GetVar(String("append")).ToString();
+		String textStr = ARG("text").ToString();
+		String appendStr = ARG("append").ToString();
 		// In MiniScript, we just return the concatenated string
 		String result = textStr + appendStr;
 		return IntrinsicResult(result);
 	};
-	raylibModule.SetValue("TextAppend", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "TextAppend", i);
 
 	// Text case conversion functions
 
 	i = Intrinsic::Create("");
 	i->AddParam("text");
 	i->code = INTRINSIC_LAMBDA {
-		String textStr = context->GetVar(String("text")).ToString();
+		String textStr = ARG("text").ToString();
 		String ret(TextToUpper(textStr.c_str()));
 		return IntrinsicResult(ret);
 	};
-	raylibModule.SetValue("TextToUpper", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "TextToUpper", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("text");
 	i->code = INTRINSIC_LAMBDA {
-		String textStr = context->GetVar(String("text")).ToString();
+		String textStr = ARG("text").ToString();
 		String ret(TextToLower(textStr.c_str()));
 		return IntrinsicResult(ret);
 	};
-	raylibModule.SetValue("TextToLower", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "TextToLower", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("text");
 	i->code = INTRINSIC_LAMBDA {
-		String textStr = context->GetVar(String("text")).ToString();
+		String textStr = ARG("text").ToString();
 		String ret(TextToPascal(textStr.c_str()));
 		return IntrinsicResult(ret);
 	};
-	raylibModule.SetValue("TextToPascal", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "TextToPascal", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("text");
 	i->code = INTRINSIC_LAMBDA {
-		String textStr = context->GetVar(String("text")).ToString();
+		String textStr = ARG("text").ToString();
 		String ret(TextToSnake(textStr.c_str()));
 		return IntrinsicResult(ret);
 	};
-	raylibModule.SetValue("TextToSnake", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "TextToSnake", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("text");
 	i->code = INTRINSIC_LAMBDA {
-		String textStr = context->GetVar(String("text")).ToString();
+		String textStr = ARG("text").ToString();
 		String ret(TextToCamel(textStr.c_str()));
 		return IntrinsicResult(ret);
 	};
-	raylibModule.SetValue("TextToCamel", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "TextToCamel", i);
 
 	// Text to value conversion functions
 
 	i = Intrinsic::Create("");
 	i->AddParam("text");
 	i->code = INTRINSIC_LAMBDA {
-		const char* text = context->GetVar(String("text")).ToString().c_str();
+		const char* text = ARG("text").ToString().c_str();
 		int result = TextToInteger(text);
 		return IntrinsicResult(result);
 	};
-	raylibModule.SetValue("TextToInteger", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "TextToInteger", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("text");
 	i->code = INTRINSIC_LAMBDA {
-		const char* text = context->GetVar(String("text")).ToString().c_str();
+		const char* text = ARG("text").ToString().c_str();
 		float result = TextToFloat(text);
 		return IntrinsicResult(result);
 	};
-	raylibModule.SetValue("TextToFloat", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "TextToFloat", i);
 
 #if RAYLIB_VERSION_GT(5, 5)
 	// Text line loading functions
@@ -889,7 +947,7 @@ void AddRTextMethods(ValueDict raylibModule) {
 	i = Intrinsic::Create("");
 	i->AddParam("text");
 	i->code = INTRINSIC_LAMBDA {
-		String textStr = context->GetVar(String("text")).ToString();
+		String textStr = ARG("text").ToString();
 		int count = 0;
 		char** lines = LoadTextLines(textStr.c_str(), &count);
 
@@ -900,6 +958,6 @@ void AddRTextMethods(ValueDict raylibModule) {
 		UnloadTextLines(lines, count);
 		return IntrinsicResult(result);
 	};
-	raylibModule.SetValue("LoadTextLines", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "LoadTextLines", i);
 #endif /* RAYLIB_VERSION_GT(5, 5) */
 }
@@ -11,10 +11,23 @@
 #include "raylib.h"
 #include "MiniscriptInterpreter.h"
 #include "MiniscriptTypes.h"
+#include "loadfile.h"
+#include "asyncload.h"
+#include "framestats.h"
+#include "trace.h"
 #include "macros.h"
 
 using namespace MiniScript;
 
+// Helper: load an image straight from its preloaded data, without copying it
+// (falling back on loading from the file as usual)
+static Image LoadImagePreloaded(const char *fileName) {
+	int size;
+	const unsigned char *data = GetPreloadedFile(fileName, &size);
+	if (!data) return LoadImage(fileName);
+	return LoadImageFromMemory(GetFileExtension(fileName), data, size);
+}
+
 void AddRTexturesMethods(ValueDict raylibModule) {
 	Intrinsic *i;
 
@@ -23,12 +36,28 @@ void AddRTexturesMethods(ValueDict raylibModule) {
 	i = Intrinsic::Create("");
 	i->AddParam("fileName");
 	i->code = INTRINSIC_LAMBDA {
-		String path = context->GetVar(String("fileName")).ToString();
-		Image img = LoadImage(path.c_str());
+		String path = ARG("fileName").ToString();
+		if (!WaitForFile(path, partialResult)) return partialResult;
+		Image img = LoadImagePreloaded(path.c_str());
 		if (!IsImageValid(img)) return IntrinsicResult::Null;
 		return IntrinsicResult(ImageToValue(img));
 	};
-	raylibModule.SetValue("LoadImage", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "LoadImage", i);
+
+	i = Intrinsic::Create("");
+	i->AddParam("fileName");
+	i->code = INTRINSIC_LAMBDA {
+		String path = ARG("fileName").ToString();
+		const char *ext = GetFileExtension(path.c_str());
+		String fileType = ext ? ext : "";
+		long handle = StartAsyncLoad(path.c_str(), [fileType](const unsigned char *data, int size) -> Value {
+			Image img = LoadImageFromMemory(fileType.c_str(), data, size);
+			if (!IsImageValid(img)) return Value::null;
+			return ImageToValue(img);
+		});
+		return IntrinsicResult(Value((double)handle));
+	};
+	RegisterIntrinsic(raylibModule, "LoadImageAsync", i);
 
 	// Image generation
 
@@ -36,69 +65,94 @@ void AddRTexturesMethods(ValueDict raylibModule) {
 	i->AddParam("width", Value(256));
 	i->AddParam("height", Value(256));
 	i->AddParam("direction", Value::zero);
-	i->AddParam("start", ColorToValue(BLACK));
-	i->AddParam("end", ColorToValue(WHITE));
-	i->code = INTRINSIC_LAMBDA {
-		int width = context->GetVar(String("width")).IntValue();
-		int height = context->GetVar(String("height")).IntValue();
-		int direction = context->GetVar(String("direction")).IntValue();
-		Color start = ValueToColor(context->GetVar(String("start")));
-		Color end = ValueToColor(context->GetVar(String("end")));
+	i->AddParam("start", DefaultColorValue(BLACK));
+	i->AddParam("end", DefaultColorValue(WHITE));
+	i->code = INTRINSIC_LAMBDA {
+		int width = ARG("width").IntValue();
+		int height = ARG("height").IntValue();
+		int direction = ARG("direction").IntValue();
+		Color start = ValueToColor(ARG("start"));
+		Color end = ValueToColor(ARG("end"));
 		Image img = GenImageGradientLinear(width, height, direction, start, end);
 		return IntrinsicResult(ImageToValue(img));
 	};
-	raylibModule.SetValue("GenImageGradientLinear", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GenImageGradientLinear", i);
 
 	// Image management
 
 	i = Intrinsic::Create("");
 	i->AddParam("image");
 	i->code = INTRINSIC_LAMBDA {
-		Image img = ValueToImage(context->GetVar(String("image")));
+		Image img = ValueToImage(ARG("image"));
 		UnloadImage(img);
-		// Free the heap-allocated Image struct
-		ValueDict map = context->GetVar(String("image")).GetDict();
-		Value handleVal = map.Lookup(String("_handle"), Value::zero);
-		Image* imgPtr = (Image*)(long)handleVal.IntValue();
-		delete imgPtr;
+		ReleaseImage(ARG("image"));
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("UnloadImage", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "UnloadImage", i);
 
 	// Texture loading
 
 	i = Intrinsic::Create("");
 	i->AddParam("fileName");
 	i->code = INTRINSIC_LAMBDA {
-		String path = context->GetVar(String("fileName")).ToString();
-		Texture tex = LoadTexture(path.c_str());
+		String path = ARG("fileName").ToString();
+		if (!WaitForFile(path, partialResult)) return partialResult;
+		Texture tex;
+		int size;
+		if (GetPreloadedFile(path.c_str(), &size)) {
+			Image img = LoadImagePreloaded(path.c_str());
+			TraceScope trace("texture upload", "upload");
+			tex = LoadTextureFromImage(img);
+			UnloadImage(img);
+		} else {
+			tex = LoadTexture(path.c_str());
+		}
 		if (!IsTextureValid(tex)) return IntrinsicResult::Null;
 		return IntrinsicResult(TextureToValue(tex));
 	};
-	raylibModule.SetValue("LoadTexture", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "LoadTexture", i);
+
+	i = Intrinsic::Create("");
+	i->AddParam("fileName");
+	i->code = INTRINSIC_LAMBDA {
+		String path = ARG("fileName").ToString();
+		const char *ext = GetFileExtension(path.c_str());
+		String fileType = ext ? ext : "";
+		long handle = StartAsyncLoad(path.c_str(), [fileType](const unsigned char *data, int size) -> Value {
+			Image img = LoadImageFromMemory(fileType.c_str(), data, size);
+			if (!IsImageValid(img)) return Value::null;
+			Texture tex;
+			{
+				TraceScope trace("texture upload", "upload");
+				tex = LoadTextureFromImage(img);
+			}
+			UnloadImage(img);
+			if (!IsTextureValid(tex)) return Value::null;
+			return TextureToValue(tex);
+		});
+		return IntrinsicResult(Value((double)handle));
+	};
+	RegisterIntrinsic(raylibModule, "LoadTextureAsync", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("image");
 	i->code = INTRINSIC_LAMBDA {
-		Image img = ValueToImage(context->GetVar(String("image")));
+		Image img = ValueToImage(ARG("image"));
+		TraceScope trace("texture upload", "upload");
 		Texture tex = LoadTextureFromImage(img);
 		return IntrinsicResult(TextureToValue(tex));
 	};
-	raylibModule.SetValue("LoadTextureFromImage", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "LoadTextureFromImage", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("texture");
 	i->code = INTRINSIC_LAMBDA {
-		Texture tex = ValueToTexture(context->GetVar(String("texture")));
+		Texture tex = ValueToTexture(ARG("texture"));
 		UnloadTexture(tex);
-		// Free the heap-allocated Texture struct
-		ValueDict map = context->GetVar(String("texture")).GetDict();
-		Value handleVal = map.Lookup(String("_handle"), Value::zero);
-		Texture* texPtr = (Texture*)(long)handleVal.IntValue();
-		delete texPtr;
+		ReleaseTexture(ARG("texture"));
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("UnloadTexture", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "UnloadTexture", i);
 
 	// Texture drawing
 
@@ -106,350 +160,378 @@ void AddRTexturesMethods(ValueDict raylibModule) {
 	i->AddParam("texture");
 	i->AddParam("posX", Value::zero);
 	i->AddParam("posY", Value::zero);
-	i->AddParam("tint", ColorToValue(WHITE));
+	i->AddParam("tint", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		Texture tex = ValueToTexture(context->GetVar(String("texture")));
-		int posX = context->GetVar(String("posX")).IntValue();
-		int posY = context->GetVar(String("posY")).IntValue();
-		Color tint = ValueToColor(context->GetVar(String("tint")));
+		Texture tex = ValueToTexture(ARG("texture"));
+		int posX = ARG("posX").IntValue();
+		int posY = ARG("posY").IntValue();
+		Color tint = ValueToColor(ARG("tint"));
 		DrawTexture(tex, posX, posY, tint);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawTexture", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawTexture", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("texture");
-	i->AddParam("position", Vector2ToValue(Vector2{0, 0}));
-	i->AddParam("tint", ColorToValue(WHITE));
+	i->AddParam("position", DefaultVector2Value(Vector2{0, 0}));
+	i->AddParam("tint", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		Texture tex = ValueToTexture(context->GetVar(String("texture")));
-		Vector2 position = ValueToVector2(context->GetVar(String("position")));
-		Color tint = ValueToColor(context->GetVar(String("tint")));
+		Texture tex = ValueToTexture(ARG("texture"));
+		Vector2 position = ValueToVector2(ARG("position"));
+		Color tint = ValueToColor(ARG("tint"));
 		DrawTextureV(tex, position, tint);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawTextureV", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawTextureV", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("texture");
-	i->AddParam("position", Vector2ToValue(Vector2{0, 0}));
+	i->AddParam("position", DefaultVector2Value(Vector2{0, 0}));
 	i->AddParam("rotation", Value::zero);
 	i->AddParam("scale", Value(1.0));
-	i->AddParam("tint", ColorToValue(WHITE));
+	i->AddParam("tint", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		Texture tex = ValueToTexture(context->GetVar(String("texture")));
-		Vector2 position = ValueToVector2(context->GetVar(String("position")));
-		float rotation = context->GetVar(String("rotation")).FloatValue();
-		float scale = context->GetVar(String("scale")).FloatValue();
-		Color tint = ValueToColor(context->GetVar(String("tint")));
+		Texture tex = ValueToTexture(ARG("texture"));
+		Vector2 position = ValueToVector2(ARG("position"));
+		float rotation = ARG("rotation").FloatValue();
+		float scale = ARG("scale").FloatValue();
+		Color tint = ValueToColor(ARG("tint"));
 		DrawTextureEx(tex, position, rotation, scale, tint);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawTextureEx", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawTextureEx", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("texture");
 	i->AddParam("source");
-	i->AddParam("position", Vector2ToValue(Vector2{0, 0}));
-	i->AddParam("tint", ColorToValue(WHITE));
+	i->AddParam("position", DefaultVector2Value(Vector2{0, 0}));
+	i->AddParam("tint", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		Texture tex = ValueToTexture(context->GetVar(String("texture")));
-		Rectangle source = ValueToRectangle(context->GetVar(String("source")));
-		Vector2 position = ValueToVector2(context->GetVar(String("position")));
-		Color tint = ValueToColor(context->GetVar(String("tint")));
+		Texture tex = ValueToTexture(ARG("texture"));
+		Rectangle source = ValueToRectangle(ARG("source"));
+		Vector2 position = ValueToVector2(ARG("position"));
+		Color tint = ValueToColor(ARG("tint"));
 		DrawTextureRec(tex, source, position, tint);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawTextureRec", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawTextureRec", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("texture");
 	i->AddParam("source");
 	i->AddParam("dest");
-	i->AddParam("origin", Vector2ToValue(Vector2{0, 0}));
+	i->AddParam("origin", DefaultVector2Value(Vector2{0, 0}));
 	i->AddParam("rotation", Value::zero);
-	i->AddParam("tint", ColorToValue(WHITE));
-	i->code = INTRINSIC_LAMBDA {
-		Texture tex = ValueToTexture(context->GetVar(String("texture")));
-		Rectangle source = ValueToRectangle(context->GetVar(String("source")));
-		Rectangle dest = ValueToRectangle(context->GetVar(String("dest")));
-		Vector2 origin = ValueToVector2(context->GetVar(String("origin")));
-		float rotation = context->GetVar(String("rotation")).FloatValue();
-		Color tint = ValueToColor(context->GetVar(String("tint")));
+	i->AddParam("tint", DefaultColorValue(WHITE));
+	i->code = INTRINSIC_LAMBDA {
+		Texture tex = ValueToTexture(ARG("texture"));
+		Rectangle source = ValueToRectangle(ARG("source"));
+		Rectangle dest = ValueToRectangle(ARG("dest"));
+		Vector2 origin = ValueToVector2(ARG("origin"));
+		float rotation = ARG("rotation").FloatValue();
+		Color tint = ValueToColor(ARG("tint"));
 		DrawTexturePro(tex, source, dest, origin, rotation, tint);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawTexturePro", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawTexturePro", i);
+
+	// Draw many parts of a texture (e.g. sprites) at once, from packed records
+	// in a RawData; each is the arguments to DrawTexturePro (48 bytes):
+	//   source x, y, width, height; dest x, y, width, height; origin x, y;
+	//   rotation (all floats); tint (uint, 0xRRGGBBAA)
+	i = Intrinsic::Create("");
+	i->AddParam("texture");
+	i->AddParam("data");
+	i->AddParam("count", -1);
+	i->AddParam("stride", 48);
+	i->code = INTRINSIC_LAMBDA {
+		Texture tex = ValueToTexture(ARG("texture"));
+		int count = ARG("count").IntValue();
+		int stride = ARG("stride").IntValue();
+		BinaryData* data = ValueToRecordBuffer(ARG("data"), count, stride, 48, "DrawTextureBatch");
+		for (int n = 0, offset = 0; n < count; n++, offset += stride) {
+			Rectangle source = { data->GetFloat(offset), data->GetFloat(offset + 4),
+				data->GetFloat(offset + 8), data->GetFloat(offset + 12) };
+			Rectangle dest = { data->GetFloat(offset + 16), data->GetFloat(offset + 20),
+				data->GetFloat(offset + 24), data->GetFloat(offset + 28) };
+			Vector2 origin = { data->GetFloat(offset + 32), data->GetFloat(offset + 36) };
+			float rotation = data->GetFloat(offset + 40);
+			Color tint = UnpackColor(data->GetUInt32(offset + 44));
+			DrawTexturePro(tex, source, dest, origin, rotation, tint);
+		}
+		return IntrinsicResult::Null;
+	};
+	RegisterIntrinsic(raylibModule, "DrawTextureBatch", i);
 
 	// More image generation functions
 
 	i = Intrinsic::Create("");
 	i->AddParam("width", Value(256));
 	i->AddParam("height", Value(256));
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		int width = context->GetVar(String("width")).IntValue();
-		int height = context->GetVar(String("height")).IntValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+		int width = ARG("width").IntValue();
+		int height = ARG("height").IntValue();
+		Color color = ValueToColor(ARG("color"));
 		Image img = GenImageColor(width, height, color);
 		return IntrinsicResult(ImageToValue(img));
 	};
-	raylibModule.SetValue("GenImageColor", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GenImageColor", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("width", Value(256));
 	i->AddParam("height", Value(256));
 	i->AddParam("density", Value(0.5));
-	i->AddParam("inner", ColorToValue(WHITE));
-	i->AddParam("outer", ColorToValue(BLACK));
-	i->code = INTRINSIC_LAMBDA {
-		int width = context->GetVar(String("width")).IntValue();
-		int height = context->GetVar(String("height")).IntValue();
-		float density = context->GetVar(String("density")).FloatValue();
-		Color inner = ValueToColor(context->GetVar(String("inner")));
-		Color outer = ValueToColor(context->GetVar(String("outer")));
+	i->AddParam("inner", DefaultColorValue(WHITE));
+	i->AddParam("outer", DefaultColorValue(BLACK));
+	i->code = INTRINSIC_LAMBDA {
+		int width = ARG("width").IntValue();
+		int height = ARG("height").IntValue();
+		float density = ARG("density").FloatValue();
+		Color inner = ValueToColor(ARG("inner"));
+		Color outer = ValueToColor(ARG("outer"));
 		Image img = GenImageGradientRadial(width, height, density, inner, outer);
 		return IntrinsicResult(ImageToValue(img));
 	};
-	raylibModule.SetValue("GenImageGradientRadial", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GenImageGradientRadial", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("width", Value(256));
 	i->AddParam("height", Value(256));
 	i->AddParam("density", Value(0.5));
-	i->AddParam("inner", ColorToValue(WHITE));
-	i->AddParam("outer", ColorToValue(BLACK));
-	i->code = INTRINSIC_LAMBDA {
-		int width = context->GetVar(String("width")).IntValue();
-		int height = context->GetVar(String("height")).IntValue();
-		float density = context->GetVar(String("density")).FloatValue();
-		Color inner = ValueToColor(context->GetVar(String("inner")));
-		Color outer = ValueToColor(context->GetVar(String("outer")));
+	i->AddParam("inner", DefaultColorValue(WHITE));
+	i->AddParam("outer", DefaultColorValue(BLACK));
+	i->code = INTRINSIC_LAMBDA {
+		int width = ARG("width").IntValue();
+		int height = ARG("height").IntValue();
+		float density = ARG("density").FloatValue();
+		Color inner = ValueToColor(ARG("inner"));
+		Color outer = ValueToColor(ARG("outer"));
 		Image img = GenImageGradientSquare(width, height, density, inner, outer);
 		return IntrinsicResult(ImageToValue(img));
 	};
-	raylibModule.SetValue("GenImageGradientSquare", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GenImageGradientSquare", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("width", Value(256));
 	i->AddParam("height", Value(256));
 	i->AddParam("checksX", Value(8));
 	i->AddParam("checksY", Value(8));
-	i->AddParam("col1", ColorToValue(WHITE));
-	i->AddParam("col2", ColorToValue(BLACK));
-	i->code = INTRINSIC_LAMBDA {
-		int width = context->GetVar(String("width")).IntValue();
-		int height = context->GetVar(String("height")).IntValue();
-		int checksX = context->GetVar(String("checksX")).IntValue();
-		int checksY = context->GetVar(String("checksY")).IntValue();
-		Color col1 = ValueToColor(context->GetVar(String("col1")));
-		Color col2 = ValueToColor(context->GetVar(String("col2")));
+	i->AddParam("col1", DefaultColorValue(WHITE));
+	i->AddParam("col2", DefaultColorValue(BLACK));
+	i->code = INTRINSIC_LAMBDA {
+		int width = ARG("width").IntValue();
+		int height = ARG("height").IntValue();
+		int checksX = ARG("checksX").IntValue();
+		int checksY = ARG("checksY").IntValue();
+		Color col1 = ValueToColor(ARG("col1"));
+		Color col2 = ValueToColor(ARG("col2"));
 		Image img = GenImageChecked(width, height, checksX, checksY, col1, col2);
 		return IntrinsicResult(ImageToValue(img));
 	};
-	raylibModule.SetValue("GenImageChecked", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GenImageChecked", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("width", Value(256));
 	i->AddParam("height", Value(256));
 	i->AddParam("factor", Value(0.5));
 	i->code = INTRINSIC_LAMBDA {
-		int width = context->GetVar(String("width")).IntValue();
-		int height = context->GetVar(String("height")).IntValue();
-		float factor = context->GetVar(String("factor")).FloatValue();
+		int width = ARG("width").IntValue();
+		int height = ARG("height").IntValue();
+		float factor = ARG("factor").FloatValue();
 		Image img = GenImageWhiteNoise(width, height, factor);
 		return IntrinsicResult(ImageToValue(img));
 	};
-	raylibModule.SetValue("GenImageWhiteNoise", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GenImageWhiteNoise", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("width", Value(256));
 	i->AddParam("height", Value(256));
 	i->AddParam("tileSize", Value(32));
 	i->code = INTRINSIC_LAMBDA {
-		int width = context->GetVar(String("width")).IntValue();
-		int height = context->GetVar(String("height")).IntValue();
-		int tileSize = context->GetVar(String("tileSize")).IntValue();
+		int width = ARG("width").IntValue();
+		int height = ARG("height").IntValue();
+		int tileSize = ARG("tileSize").IntValue();
 		Image img = GenImageCellular(width, height, tileSize);
 		return IntrinsicResult(ImageToValue(img));
 	};
-	raylibModule.SetValue("GenImageCellular", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GenImageCellular", i);
 
 	// Image manipulation
 
 	i = Intrinsic::Create("");
 	i->AddParam("image");
 	i->code = INTRINSIC_LAMBDA {
-		Image img = ValueToImage(context->GetVar(String("image")));
+		Image img = ValueToImage(ARG("image"));
 		Image copy = ImageCopy(img);
 		return IntrinsicResult(ImageToValue(copy));
 	};
-	raylibModule.SetValue("ImageCopy", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageCopy", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("image");
 	i->AddParam("crop");
 	i->code = INTRINSIC_LAMBDA {
-		Image img = ValueToImage(context->GetVar(String("image")));
-		Rectangle crop = ValueToRectangle(context->GetVar(String("crop")));
+		Image img = ValueToImage(ARG("image"));
+		Rectangle crop = ValueToRectangle(ARG("crop"));
 		ImageCrop(&img, crop);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageCrop", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageCrop", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("image");
 	i->AddParam("newWidth");
 	i->AddParam("newHeight");
 	i->code = INTRINSIC_LAMBDA {
-		Image img = ValueToImage(context->GetVar(String("image")));
-		int newWidth = context->GetVar(String("newWidth")).IntValue();
-		int newHeight = context->GetVar(String("newHeight")).IntValue();
+		Image img = ValueToImage(ARG("image"));
+		int newWidth = ARG("newWidth").IntValue();
+		int newHeight = ARG("newHeight").IntValue();
 		ImageResize(&img, newWidth, newHeight);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageResize", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageResize", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("image");
 	i->AddParam("newWidth");
 	i->AddParam("newHeight");
 	i->code = INTRINSIC_LAMBDA {
-		Image img = ValueToImage(context->GetVar(String("image")));
-		int newWidth = context->GetVar(String("newWidth")).IntValue();
-		int newHeight = context->GetVar(String("newHeight")).IntValue();
+		Image img = ValueToImage(ARG("image"));
+		int newWidth = ARG("newWidth").IntValue();
+		int newHeight = ARG("newHeight").IntValue();
 		ImageResizeNN(&img, newWidth, newHeight);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageResizeNN", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageResizeNN", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("image");
 	i->code = INTRINSIC_LAMBDA {
-		Image img = ValueToImage(context->GetVar(String("image")));
+		Image img = ValueToImage(ARG("image"));
 		ImageFlipVertical(&img);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageFlipVertical", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageFlipVertical", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("image");
 	i->code = INTRINSIC_LAMBDA {
-		Image img = ValueToImage(context->GetVar(String("image")));
+		Image img = ValueToImage(ARG("image"));
 		ImageFlipHorizontal(&img);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageFlipHorizontal", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageFlipHorizontal", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("image");
 	i->code = INTRINSIC_LAMBDA {
-		Image img = ValueToImage(context->GetVar(String("image")));
+		Image img = ValueToImage(ARG("image"));
 		ImageRotateCW(&img);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageRotateCW", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageRotateCW", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("image");
 	i->code = INTRINSIC_LAMBDA {
-		Image img = ValueToImage(context->GetVar(String("image")));
+		Image img = ValueToImage(ARG("image"));
 		ImageRotateCCW(&img);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageRotateCCW", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageRotateCCW", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("image");
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		Image img = ValueToImage(context->GetVar(String("image")));
-		Color color = ValueToColor(context->GetVar(String("color")));
+		Image img = ValueToImage(ARG("image"));
+		Color color = ValueToColor(ARG("color"));
 		ImageColorTint(&img, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageColorTint", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageColorTint", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("image");
 	i->code = INTRINSIC_LAMBDA {
-		Image img = ValueToImage(context->GetVar(String("image")));
+		Image img = ValueToImage(ARG("image"));
 		ImageColorInvert(&img);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageColorInvert", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageColorInvert", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("image");
 	i->code = INTRINSIC_LAMBDA {
-		Image img = ValueToImage(context->GetVar(String("image")));
+		Image img = ValueToImage(ARG("image"));
 		ImageColorGrayscale(&img);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageColorGrayscale", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageColorGrayscale", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("image");
 	i->AddParam("contrast");
 	i->code = INTRINSIC_LAMBDA {
-		Image img = ValueToImage(context->GetVar(String("image")));
-		float contrast = context->GetVar(String("contrast")).FloatValue();
+		Image img = ValueToImage(ARG("image"));
+		float contrast = ARG("contrast").FloatValue();
 		ImageColorContrast(&img, contrast);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageColorContrast", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageColorContrast", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("image");
 	i->AddParam("brightness");
 	i->code = INTRINSIC_LAMBDA {
-		Image img = ValueToImage(context->GetVar(String("image")));
-		int brightness = context->GetVar(String("brightness")).IntValue();
+		Image img = ValueToImage(ARG("image"));
+		int brightness = ARG("brightness").IntValue();
 		ImageColorBrightness(&img, brightness);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageColorBrightness", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageColorBrightness", i);
 
 	// Image drawing functions
 
 	i = Intrinsic::Create("");
 	i->AddParam("dst");
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		Image dst = ValueToImage(context->GetVar(String("dst")));
-		Color color = ValueToColor(context->GetVar(String("color")));
+		Image dst = ValueToImage(ARG("dst"));
+		Color color = ValueToColor(ARG("color"));
 		ImageClearBackground(&dst, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageClearBackground", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageClearBackground", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("dst");
 	i->AddParam("x", Value::zero);
 	i->AddParam("y", Value::zero);
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		Image dst = ValueToImage(context->GetVar(String("dst")));
-		int x = context->GetVar(String("x")).IntValue();
-		int y = context->GetVar(String("y")).IntValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+		Image dst = ValueToImage(ARG("dst"));
+		int x = ARG("x").IntValue();
+		int y = ARG("y").IntValue();
+		Color color = ValueToColor(ARG("color"));
 		ImageDrawPixel(&dst, x, y, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageDrawPixel", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageDrawPixel", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("dst");
-	i->AddParam("position", Vector2ToValue(Vector2{0, 0}));
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("position", DefaultVector2Value(Vector2{0, 0}));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		Image dst = ValueToImage(context->GetVar(String("dst")));
-		Vector2 position = ValueToVector2(context->GetVar(String("position")));
-		Color color = ValueToColor(context->GetVar(String("color")));
+		Image dst = ValueToImage(ARG("dst"));
+		Vector2 position = ValueToVector2(ARG("position"));
+		Color color = ValueToColor(ARG("color"));
 		ImageDrawPixelV(&dst, position, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageDrawPixelV", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageDrawPixelV", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("dst");
@@ -457,65 +539,65 @@ void AddRTexturesMethods(ValueDict raylibModule) {
 	i->AddParam("startPosY", Value::zero);
 	i->AddParam("endPosX", Value::zero);
 	i->AddParam("endPosY", Value::zero);
-	i->AddParam("color", ColorToValue(WHITE));
-	i->code = INTRINSIC_LAMBDA {
-		Image dst = ValueToImage(context->GetVar(String("dst")));
-		int startPosX = context->GetVar(String("startPosX")).IntValue();
-		int startPosY = context->GetVar(String("startPosY")).IntValue();
-		int endPosX = context->GetVar(String("endPosX")).IntValue();
-		int endPosY = context->GetVar(String("endPosY")).IntValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+	i->AddParam("color", DefaultColorValue(WHITE));
+	i->code = INTRINSIC_LAMBDA {
+		Image dst = ValueToImage(ARG("dst"));
+		int startPosX = ARG("startPosX").IntValue();
+		int startPosY = ARG("startPosY").IntValue();
+		int endPosX = ARG("endPosX").IntValue();
+		int endPosY = ARG("endPosY").IntValue();
+		Color color = ValueToColor(ARG("color"));
 		ImageDrawLine(&dst, startPosX, startPosY, endPosX, endPosY, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageDrawLine", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageDrawLine", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("dst");
-	i->AddParam("start", Vector2ToValue(Vector2{0, 0}));
-	i->AddParam("end", Vector2ToValue(Vector2{0, 0}));
-	i->AddParam("color", ColorToValue(WHITE));
-	i->code = INTRINSIC_LAMBDA {
-		Image dst = ValueToImage(context->GetVar(String("dst")));
-		Vector2 start = ValueToVector2(context->GetVar(String("start")));
-		Vector2 end = ValueToVector2(context->GetVar(String("end")));
-		Color color = ValueToColor(context->GetVar(String("color")));
+	i->AddParam("start", DefaultVector2Value(Vector2{0, 0}));
+	i->AddParam("end", DefaultVector2Value(Vector2{0, 0}));
+	i->AddParam("color", DefaultColorValue(WHITE));
+	i->code = INTRINSIC_LAMBDA {
+		Image dst = ValueToImage(ARG("dst"));
+		Vector2 start = ValueToVector2(ARG("start"));
+		Vector2 end = ValueToVector2(ARG("end"));
+		Color color = ValueToColor(ARG("color"));
 		ImageDrawLineV(&dst, start, end, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageDrawLineV", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageDrawLineV", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("dst");
 	i->AddParam("centerX", Value(100));
 	i->AddParam("centerY", Value(100));
 	i->AddParam("radius", Value(32));
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		Image dst = ValueToImage(context->GetVar(String("dst")));
-		int centerX = context->GetVar(String("centerX")).IntValue();
-		int centerY = context->GetVar(String("centerY")).IntValue();
-		int radius = context->GetVar(String("radius")).IntValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+		Image dst = ValueToImage(ARG("dst"));
+		int centerX = ARG("centerX").IntValue();
+		int centerY = ARG("centerY").IntValue();
+		int radius = ARG("radius").IntValue();
+		Color color = ValueToColor(ARG("color"));
 		ImageDrawCircle(&dst, centerX, centerY, radius, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageDrawCircle", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageDrawCircle", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("dst");
-	i->AddParam("center", Vector2ToValue(Vector2{100, 100}));
+	i->AddParam("center", DefaultVector2Value(Vector2{100, 100}));
 	i->AddParam("radius", Value(32));
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		Image dst = ValueToImage(context->GetVar(String("dst")));
-		Vector2 center = ValueToVector2(context->GetVar(String("center")));
-		int radius = context->GetVar(String("radius")).IntValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+		Image dst = ValueToImage(ARG("dst"));
+		Vector2 center = ValueToVector2(ARG("center"));
+		int radius = ARG("radius").IntValue();
+		Color color = ValueToColor(ARG("color"));
 		ImageDrawCircleV(&dst, center, radius, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageDrawCircleV", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageDrawCircleV", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("dst");
@@ -523,63 +605,63 @@ void AddRTexturesMethods(ValueDict raylibModule) {
 	i->AddParam("posY", Value::zero);
 	i->AddParam("width", Value(256));
 	i->AddParam("height", Value(256));
-	i->AddParam("color", ColorToValue(WHITE));
-	i->code = INTRINSIC_LAMBDA {
-		Image dst = ValueToImage(context->GetVar(String("dst")));
-		int posX = context->GetVar(String("posX")).IntValue();
-		int posY = context->GetVar(String("posY")).IntValue();
-		int width = context->GetVar(String("width")).IntValue();
-		int height = context->GetVar(String("height")).IntValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+	i->AddParam("color", DefaultColorValue(WHITE));
+	i->code = INTRINSIC_LAMBDA {
+		Image dst = ValueToImage(ARG("dst"));
+		int posX = ARG("posX").IntValue();
+		int posY = ARG("posY").IntValue();
+		int width = ARG("width").IntValue();
+		int height = ARG("height").IntValue();
+		Color color = ValueToColor(ARG("color"));
 		ImageDrawRectangle(&dst, posX, posY, width, height, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageDrawRectangle", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageDrawRectangle", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("dst");
 	i->AddParam("rec");
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		Image dst = ValueToImage(context->GetVar(String("dst")));
-		Rectangle rec = ValueToRectangle(context->GetVar(String("rec")));
-		Color color = ValueToColor(context->GetVar(String("color")));
+		Image dst = ValueToImage(ARG("dst"));
+		Rectangle rec = ValueToRectangle(ARG("rec"));
+		Color color = ValueToColor(ARG("color"));
 		ImageDrawRectangleRec(&dst, rec, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageDrawRectangleRec", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageDrawRectangleRec", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("dst");
 	i->AddParam("rec");
 	i->AddParam("thick", Value(1));
-	i->AddParam("color", ColorToValue(WHITE));
+	i->AddParam("color", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		Image dst = ValueToImage(context->GetVar(String("dst")));
-		Rectangle rec = ValueToRectangle(context->GetVar(String("rec")));
-		int thick = context->GetVar(String("thick")).IntValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+		Image dst = ValueToImage(ARG("dst"));
+		Rectangle rec = ValueToRectangle(ARG("rec"));
+		int thick = ARG("thick").IntValue();
+		Color color = ValueToColor(ARG("color"));
 		ImageDrawRectangleLines(&dst, rec, thick, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageDrawRectangleLines", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageDrawRectangleLines", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("dst");
 	i->AddParam("src");
 	i->AddParam("srcRec");
 	i->AddParam("dstRec");
-	i->AddParam("tint", ColorToValue(WHITE));
+	i->AddParam("tint", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		Image dst = ValueToImage(context->GetVar(String("dst")));
-		Image src = ValueToImage(context->GetVar(String("src")));
-		Rectangle srcRec = ValueToRectangle(context->GetVar(String("srcRec")));
-		Rectangle dstRec = ValueToRectangle(context->GetVar(String("dstRec")));
-		Color tint = ValueToColor(context->GetVar(String("tint")));
+		Image dst = ValueToImage(ARG("dst"));
+		Image src = ValueToImage(ARG("src"));
+		Rectangle srcRec = ValueToRectangle(ARG("srcRec"));
+		Rectangle dstRec = ValueToRectangle(ARG("dstRec"));
+		Color tint = ValueToColor(ARG("tint"));
 		ImageDraw(&dst, src, srcRec, dstRec, tint);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageDraw", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageDraw", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("dst");
@@ -587,18 +669,18 @@ void AddRTexturesMethods(ValueDict raylibModule) {
 	i->AddParam("posX", Value::zero);
 	i->AddParam("posY", Value::zero);
 	i->AddParam("fontSize", Value(20));
-	i->AddParam("color", ColorToValue(BLACK));
-	i->code = INTRINSIC_LAMBDA {
-		Image dst = ValueToImage(context->GetVar(String("dst")));
-		String text = context->GetVar(String("text")).ToString();
-		int posX = context->GetVar(String("posX")).IntValue();
-		int posY = context->GetVar(String("posY")).IntValue();
-		int fontSize = context->GetVar(String("fontSize")).IntValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+	i->AddParam("color", DefaultColorValue(BLACK));
+	i->code = INTRINSIC_LAMBDA {
+		Image dst = ValueToImage(ARG("dst"));
+		String text = ARG("text").ToString();
+		int posX = ARG("posX").IntValue();
+		int posY = ARG("posY").IntValue();
+		int fontSize = ARG("fontSize").IntValue();
+		Color color = ValueToColor(ARG("color"));
 		ImageDrawText(&dst, text.c_str(), posX, posY, fontSize, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageDrawText", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageDrawText", i);
 
 	// Texture configuration
 
@@ -606,32 +688,32 @@ void AddRTexturesMethods(ValueDict raylibModule) {
 	i->AddParam("texture");
 	i->AddParam("filter");
 	i->code = INTRINSIC_LAMBDA {
-		Texture tex = ValueToTexture(context->GetVar(String("texture")));
-		int filter = context->GetVar(String("filter")).IntValue();
+		Texture tex = ValueToTexture(ARG("texture"));
+		int filter = ARG("filter").IntValue();
 		SetTextureFilter(tex, filter);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("SetTextureFilter", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "SetTextureFilter", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("texture");
 	i->AddParam("wrap");
 	i->code = INTRINSIC_LAMBDA {
-		Texture tex = ValueToTexture(context->GetVar(String("texture")));
-		int wrap = context->GetVar(String("wrap")).IntValue();
+		Texture tex = ValueToTexture(ARG("texture"));
+		int wrap = ARG("wrap").IntValue();
 		SetTextureWrap(tex, wrap);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("SetTextureWrap", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "SetTextureWrap", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("texture");
 	i->code = INTRINSIC_LAMBDA {
-		Texture tex = ValueToTexture(context->GetVar(String("texture")));
+		Texture tex = ValueToTexture(ARG("texture"));
 		GenTextureMipmaps(&tex);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("GenTextureMipmaps", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GenTextureMipmaps", i);
 
 	// RenderTexture2D loading/unloading
 
@@ -639,44 +721,42 @@ void AddRTexturesMethods(ValueDict raylibModule) {
 	i->AddParam("width", Value(960));
 	i->AddParam("height", Value(640));
 	i->code = INTRINSIC_LAMBDA {
-		int width = context->GetVar(String("width")).IntValue();
-		int height = context->GetVar(String("height")).IntValue();
+		int width = ARG("width").IntValue();
+		int height = ARG("height").IntValue();
 		RenderTexture2D renderTexture = LoadRenderTexture(width, height);
 		return IntrinsicResult(RenderTextureToValue(renderTexture));
 	};
-	raylibModule.SetValue("LoadRenderTexture", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "LoadRenderTexture", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("target");
 	i->code = INTRINSIC_LAMBDA {
-		RenderTexture2D target = ValueToRenderTexture(context->GetVar(String("target")));
+		RenderTexture2D target = ValueToRenderTexture(ARG("target"));
 		UnloadRenderTexture(target);
-		// Free the heap-allocated RenderTexture2D struct
-		ValueDict map = context->GetVar(String("target")).GetDict();
-		Value handleVal = map.Lookup(String("_handle"), Value::zero);
-		RenderTexture2D* rtPtr = (RenderTexture2D*)(long)handleVal.IntValue();
-		delete rtPtr;
+		ReleaseRenderTexture(ARG("target"));
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("UnloadRenderTexture", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "UnloadRenderTexture", i);
 
 	// RenderTexture2D drawing
 
 	i = Intrinsic::Create("");
 	i->AddParam("target");
 	i->code = INTRINSIC_LAMBDA {
-		RenderTexture2D target = ValueToRenderTexture(context->GetVar(String("target")));
+		RenderTexture2D target = ValueToRenderTexture(ARG("target"));
+		NoteRenderBatch();
 		BeginTextureMode(target);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("BeginTextureMode", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "BeginTextureMode", i);
 
 	i = Intrinsic::Create("");
 	i->code = INTRINSIC_LAMBDA {
+		NoteRenderBatch();
 		EndTextureMode();
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("EndTextureMode", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "EndTextureMode", i);
 
 	// Color manipulation functions
 
@@ -684,65 +764,65 @@ void AddRTexturesMethods(ValueDict raylibModule) {
 	i->AddParam("color");
 	i->AddParam("alpha");
 	i->code = INTRINSIC_LAMBDA {
-		Color color = ValueToColor(context->GetVar(String("color")));
-		float alpha = context->GetVar(String("alpha")).FloatValue();
+		Color color = ValueToColor(ARG("color"));
+		float alpha = ARG("alpha").FloatValue();
 		Color result = ColorAlpha(color, alpha);
 		return IntrinsicResult(ColorToValue(result));
 	};
-	raylibModule.SetValue("ColorAlpha", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ColorAlpha", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("dst");
 	i->AddParam("src");
 	i->AddParam("tint");
 	i->code = INTRINSIC_LAMBDA {
-		Color dst = ValueToColor(context->GetVar(String("dst")));
-		Color src = ValueToColor(context->GetVar(String("src")));
-		Color tint = ValueToColor(context->GetVar(String("tint")));
+		Color dst = ValueToColor(ARG("dst"));
+		Color src = ValueToColor(ARG("src"));
+		Color tint = ValueToColor(ARG("tint"));
 		Color result = ColorAlphaBlend(dst, src, tint);
 		return IntrinsicResult(ColorToValue(result));
 	};
-	raylibModule.SetValue("ColorAlphaBlend", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ColorAlphaBlend", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("color");
 	i->AddParam("factor");
 	i->code = INTRINSIC_LAMBDA {
-		Color color = ValueToColor(context->GetVar(String("color")));
-		float factor = context->GetVar(String("factor")).FloatValue();
+		Color color = ValueToColor(ARG("color"));
+		float factor = ARG("factor").FloatValue();
 		Color result = ColorBrightness(color, factor);
 		return IntrinsicResult(ColorToValue(result));
 	};
-	raylibModule.SetValue("ColorBrightness", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ColorBrightness", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("color");
 	i->AddParam("contrast");
 	i->code = INTRINSIC_LAMBDA {
-		Color color = ValueToColor(context->GetVar(String("color")));
-		float contrast = context->GetVar(String("contrast")).FloatValue();
+		Color color = ValueToColor(ARG("color"));
+		float contrast = ARG("contrast").FloatValue();
 		Color result = ColorContrast(color, contrast);
 		return IntrinsicResult(ColorToValue(result));
 	};
-	raylibModule.SetValue("ColorContrast", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ColorContrast", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("hue");
 	i->AddParam("saturation");
 	i->AddParam("value");
 	i->code = INTRINSIC_LAMBDA {
-		float hue = context->GetVar(String("hue")).FloatValue();
-		float saturation = context->GetVar(String("saturation")).FloatValue();
-		float value = context->GetVar(String("value")).FloatValue();
+		float hue = ARG("hue").FloatValue();
+		float saturation = ARG("saturation").FloatValue();
+		float value = ARG("value").FloatValue();
 		Color result = ColorFromHSV(hue, saturation, value);
 		return IntrinsicResult(ColorToValue(result));
 	};
-	raylibModule.SetValue("ColorFromHSV", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ColorFromHSV", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("normalized");
 	i->code = INTRINSIC_LAMBDA {
-		ValueDict normalized = context->GetVar(String("normalized")).GetDict();
+		ValueDict normalized = ARG("normalized").GetDict();
 		Vector4 vec;
 		vec.x = normalized.Lookup(String("x"), Value::zero).FloatValue();
 		vec.y = normalized.Lookup(String("y"), Value::zero).FloatValue();
@@ -751,36 +831,36 @@ void AddRTexturesMethods(ValueDict raylibModule) {
 		Color result = ColorFromNormalized(vec);
 		return IntrinsicResult(ColorToValue(result));
 	};
-	raylibModule.SetValue("ColorFromNormalized", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ColorFromNormalized", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("col1");
 	i->AddParam("col2");
 	i->code = INTRINSIC_LAMBDA {
-		Color col1 = ValueToColor(context->GetVar(String("col1")));
-		Color col2 = ValueToColor(context->GetVar(String("col2")));
+		Color col1 = ValueToColor(ARG("col1"));
+		Color col2 = ValueToColor(ARG("col2"));
 		bool result = ColorIsEqual(col1, col2);
 		return IntrinsicResult(Value(result));
 	};
-	raylibModule.SetValue("ColorIsEqual", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ColorIsEqual", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("color1");
 	i->AddParam("color2");
 	i->AddParam("amount");
 	i->code = INTRINSIC_LAMBDA {
-		Color color1 = ValueToColor(context->GetVar(String("color1")));
-		Color color2 = ValueToColor(context->GetVar(String("color2")));
-		float amount = context->GetVar(String("amount")).FloatValue();
+		Color color1 = ValueToColor(ARG("color1"));
+		Color color2 = ValueToColor(ARG("color2"));
+		float amount = ARG("amount").FloatValue();
 		Color result = ColorLerp(color1, color2, amount);
 		return IntrinsicResult(ColorToValue(result));
 	};
-	raylibModule.SetValue("ColorLerp", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ColorLerp", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("color");
 	i->code = INTRINSIC_LAMBDA {
-		Color color = ValueToColor(context->GetVar(String("color")));
+		Color color = ValueToColor(ARG("color"));
 		Vector4 result = ColorNormalize(color);
 		ValueDict resultDict;
 		resultDict.SetValue(String("x"), Value(result.x));
@@ -789,23 +869,23 @@ void AddRTexturesMethods(ValueDict raylibModule) {
 		resultDict.SetValue(String("w"), Value(result.w));
 		return IntrinsicResult(Value(resultDict));
 	};
-	raylibModule.SetValue("ColorNormalize", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ColorNormalize", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("color");
 	i->AddParam("tint");
 	i->code = INTRINSIC_LAMBDA {
-		Color color = ValueToColor(context->GetVar(String("color")));
-		Color tint = ValueToColor(context->GetVar(String("tint")));
+		Color color = ValueToColor(ARG("color"));
+		Color tint = ValueToColor(ARG("tint"));
 		Color result = ColorTint(color, tint);
 		return IntrinsicResult(ColorToValue(result));
 	};
-	raylibModule.SetValue("ColorTint", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ColorTint", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("color");
 	i->code = INTRINSIC_LAMBDA {
-		Color color = ValueToColor(context->GetVar(String("color")));
+		Color color = ValueToColor(ARG("color"));
 		Vector3 result = ColorToHSV(color);
 		ValueDict resultDict;
 		resultDict.SetValue(String("x"), Value(result.x));
@@ -813,64 +893,79 @@ void AddRTexturesMethods(ValueDict raylibModule) {
 		resultDict.SetValue(String("z"), Value(result.z));
 		return IntrinsicResult(Value(resultDict));
 	};
-	raylibModule.SetValue("ColorToHSV", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ColorToHSV", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("color");
 	i->code = INTRINSIC_LAMBDA {
-		Color color = ValueToColor(context->GetVar(String("color")));
+		Color color = ValueToColor(ARG("color"));
 		int result = ColorToInt(color);
 		return IntrinsicResult(Value(result));
 	};
-	raylibModule.SetValue("ColorToInt", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ColorToInt", i);
+
+	// Color format for returned colors (MSRLWeb extension)
+	i = Intrinsic::Create("");
+	i->AddParam("format", COLOR_FORMAT_INT);
+	i->code = INTRINSIC_LAMBDA {
+		SetColorFormat(ARG("format").IntValue());
+		return IntrinsicResult::Null;
+	};
+	RegisterIntrinsic(raylibModule, "SetColorFormat", i);
+
+	i = Intrinsic::Create("");
+	i->code = INTRINSIC_LAMBDA {
+		return IntrinsicResult(GetColorFormat());
+	};
+	RegisterIntrinsic(raylibModule, "GetColorFormat", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("color");
 	i->AddParam("alpha");
 	i->code = INTRINSIC_LAMBDA {
-		Color color = ValueToColor(context->GetVar(String("color")));
-		float alpha = context->GetVar(String("alpha")).FloatValue();
+		Color color = ValueToColor(ARG("color"));
+		float alpha = ARG("alpha").FloatValue();
 		Color result = Fade(color, alpha);
 		return IntrinsicResult(ColorToValue(result));
 	};
-	raylibModule.SetValue("Fade", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "Fade", i);
 
 	// Pixel/Color accessor functions
 
 	i = Intrinsic::Create("");
 	i->AddParam("hexValue");
 	i->code = INTRINSIC_LAMBDA {
-		unsigned int hexValue = context->GetVar(String("hexValue")).IntValue();
+		unsigned int hexValue = (unsigned int)(long long)ARG("hexValue").DoubleValue();
 		Color result = GetColor(hexValue);
 		return IntrinsicResult(ColorToValue(result));
 	};
-	raylibModule.SetValue("GetColor", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetColor", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("srcPtr");
 	i->AddParam("format");
 	i->code = INTRINSIC_LAMBDA {
 		// srcPtr should be RawData
-		BinaryData* data = ValueToRawData(context->GetVar(String("srcPtr")));
+		BinaryData* data = ValueToRawData(ARG("srcPtr"));
 		if (!data) return IntrinsicResult::Null;
-		int format = context->GetVar(String("format")).IntValue();
+		int format = ARG("format").IntValue();
 		Color result = GetPixelColor(data->bytes, format);
 		return IntrinsicResult(ColorToValue(result));
 	};
-	raylibModule.SetValue("GetPixelColor", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetPixelColor", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("width");
 	i->AddParam("height");
 	i->AddParam("format");
 	i->code = INTRINSIC_LAMBDA {
-		int width = context->GetVar(String("width")).IntValue();
-		int height = context->GetVar(String("height")).IntValue();
-		int format = context->GetVar(String("format")).IntValue();
+		int width = ARG("width").IntValue();
+		int height = ARG("height").IntValue();
+		int format = ARG("format").IntValue();
 		int result = GetPixelDataSize(width, height, format);
 		return IntrinsicResult(Value(result));
 	};
-	raylibModule.SetValue("GetPixelDataSize", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetPixelDataSize", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("dstPtr");
@@ -878,14 +973,14 @@ void AddRTexturesMethods(ValueDict raylibModule) {
 	i->AddParam("format");
 	i->code = INTRINSIC_LAMBDA {
 		// dstPtr should be RawData
-		BinaryData* data = ValueToRawData(context->GetVar(String("dstPtr")));
+		BinaryData* data = ValueToRawData(ARG("dstPtr"));
 		if (!data) return IntrinsicResult::Null;
-		Color color = ValueToColor(context->GetVar(String("color")));
-		int format = context->GetVar(String("format")).IntValue();
+		Color color = ValueToColor(ARG("color"));
+		int format = ARG("format").IntValue();
 		SetPixelColor(data->bytes, color, format);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("SetPixelColor", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "SetPixelColor", i);
 
 	// Additional image generation functions
 
@@ -896,57 +991,57 @@ void AddRTexturesMethods(ValueDict raylibModule) {
 	i->AddParam("offsetY");
 	i->AddParam("scale");
 	i->code = INTRINSIC_LAMBDA {
-		int width = context->GetVar(String("width")).IntValue();
-		int height = context->GetVar(String("height")).IntValue();
-		float offsetX = context->GetVar(String("offsetX")).FloatValue();
-		float offsetY = context->GetVar(String("offsetY")).FloatValue();
-		float scale = context->GetVar(String("scale")).FloatValue();
+		int width = ARG("width").IntValue();
+		int height = ARG("height").IntValue();
+		float offsetX = ARG("offsetX").FloatValue();
+		float offsetY = ARG("offsetY").FloatValue();
+		float scale = ARG("scale").FloatValue();
 		Image result = GenImagePerlinNoise(width, height, offsetX, offsetY, scale);
 		return IntrinsicResult(ImageToValue(result));
 	};
-	raylibModule.SetValue("GenImagePerlinNoise", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GenImagePerlinNoise", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("text");
 	i->AddParam("fontSize");
 	i->AddParam("color");
 	i->code = INTRINSIC_LAMBDA {
-		String text = context->GetVar(String("text")).ToString();
-		int fontSize = context->GetVar(String("fontSize")).IntValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+		String text = ARG("text").ToString();
+		int fontSize = ARG("fontSize").IntValue();
+		Color color = ValueToColor(ARG("color"));
 		Image result = ImageText(text.c_str(), fontSize, color);
 		return IntrinsicResult(ImageToValue(result));
 	};
-	raylibModule.SetValue("GenImageText", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GenImageText", i);
 
 	// Validation functions
 
 	i = Intrinsic::Create("");
 	i->AddParam("image");
 	i->code = INTRINSIC_LAMBDA {
-		Image image = ValueToImage(context->GetVar(String("image")));
+		Image image = ValueToImage(ARG("image"));
 		bool result = IsImageValid(image);
 		return IntrinsicResult(Value(result));
 	};
-	raylibModule.SetValue("IsImageValid", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "IsImageValid", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("target");
 	i->code = INTRINSIC_LAMBDA {
-		RenderTexture2D target = ValueToRenderTexture(context->GetVar(String("target")));
+		RenderTexture2D target = ValueToRenderTexture(ARG("target"));
 		bool result = IsRenderTextureValid(target);
 		return IntrinsicResult(Value(result));
 	};
-	raylibModule.SetValue("IsRenderTextureValid", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "IsRenderTextureValid", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("texture");
 	i->code = INTRINSIC_LAMBDA {
-		Texture2D texture = ValueToTexture(context->GetVar(String("texture")));
+		Texture2D texture = ValueToTexture(ARG("texture"));
 		bool result = IsTextureValid(texture);
 		return IntrinsicResult(Value(result));
 	};
-	raylibModule.SetValue("IsTextureValid", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "IsTextureValid", i);
 
 	// Additional image loading functions
 
@@ -954,7 +1049,8 @@ void AddRTexturesMethods(ValueDict raylibModule) {
 	i->AddParam("fileName");
 	i->AddParam("frames");
 	i->code = INTRINSIC_LAMBDA {
-		String path = context->GetVar(String("fileName")).ToString();
+		String path = ARG("fileName").ToString();
+		if (!WaitForFile(path, partialResult)) return partialResult;
 		int frames = 0;
 		Image result = LoadImageAnim(path.c_str(), &frames);
 		// Return map with image and frames
@@ -963,15 +1059,15 @@ void AddRTexturesMethods(ValueDict raylibModule) {
 		resultDict.SetValue(String("frames"), Value(frames));
 		return IntrinsicResult(Value(resultDict));
 	};
-	raylibModule.SetValue("LoadImageAnim", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "LoadImageAnim", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("fileType");
 	i->AddParam("fileData");
 	i->AddParam("frames");
 	i->code = INTRINSIC_LAMBDA {
-		String fileType = context->GetVar(String("fileType")).ToString();
-		BinaryData* data = ValueToRawData(context->GetVar(String("fileData")));
+		String fileType = ARG("fileType").ToString();
+		BinaryData* data = ValueToRawData(ARG("fileData"));
 		if (!data) return IntrinsicResult::Null;
 		int frames = 0;
 		Image result = LoadImageAnimFromMemory(fileType.c_str(), data->bytes, data->length, &frames);
@@ -981,12 +1077,12 @@ void AddRTexturesMethods(ValueDict raylibModule) {
 		resultDict.SetValue(String("frames"), Value(frames));
 		return IntrinsicResult(Value(resultDict));
 	};
-	raylibModule.SetValue("LoadImageAnimFromMemory", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "LoadImageAnimFromMemory", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("image");
 	i->code = INTRINSIC_LAMBDA {
-		Image image = ValueToImage(context->GetVar(String("image")));
+		Image image = ValueToImage(ARG("image"));
 		int colorCount = image.width * image.height;
 		Color* colors = LoadImageColors(image);
 		// Convert to MiniScript list
@@ -997,43 +1093,43 @@ void AddRTexturesMethods(ValueDict raylibModule) {
 		UnloadImageColors(colors);
 		return IntrinsicResult(Value(result));
 	};
-	raylibModule.SetValue("LoadImageColors", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "LoadImageColors", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("fileType");
 	i->AddParam("fileData");
 	i->code = INTRINSIC_LAMBDA {
-		String fileType = context->GetVar(String("fileType")).ToString();
-		BinaryData* data = ValueToRawData(context->GetVar(String("fileData")));
+		String fileType = ARG("fileType").ToString();
+		BinaryData* data = ValueToRawData(ARG("fileData"));
 		if (!data) return IntrinsicResult::Null;
 		Image result = LoadImageFromMemory(fileType.c_str(), data->bytes, data->length);
 		if (!IsImageValid(result)) return IntrinsicResult::Null;
 		return IntrinsicResult(ImageToValue(result));
 	};
-	raylibModule.SetValue("LoadImageFromMemory", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "LoadImageFromMemory", i);
 
 	i = Intrinsic::Create("");
 	i->code = INTRINSIC_LAMBDA {
 		Image result = LoadImageFromScreen();
 		return IntrinsicResult(ImageToValue(result));
 	};
-	raylibModule.SetValue("LoadImageFromScreen", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "LoadImageFromScreen", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("texture");
 	i->code = INTRINSIC_LAMBDA {
-		Texture2D texture = ValueToTexture(context->GetVar(String("texture")));
+		Texture2D texture = ValueToTexture(ARG("texture"));
 		Image result = LoadImageFromTexture(texture);
 		return IntrinsicResult(ImageToValue(result));
 	};
-	raylibModule.SetValue("LoadImageFromTexture", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "LoadImageFromTexture", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("image");
 	i->AddParam("colorCount");
 	i->code = INTRINSIC_LAMBDA {
-		Image image = ValueToImage(context->GetVar(String("image")));
-		int colorCount = context->GetVar(String("colorCount")).IntValue();
+		Image image = ValueToImage(ARG("image"));
+		int colorCount = ARG("colorCount").IntValue();
 		Color* colors = LoadImagePalette(image, colorCount, &colorCount);
 		// Convert to MiniScript list
 		ValueList result;
@@ -1043,7 +1139,7 @@ void AddRTexturesMethods(ValueDict raylibModule) {
 		UnloadImagePalette(colors);
 		return IntrinsicResult(Value(result));
 	};
-	raylibModule.SetValue("LoadImagePalette", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "LoadImagePalette", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("fileName");
@@ -1052,16 +1148,17 @@ void AddRTexturesMethods(ValueDict raylibModule) {
 	i->AddParam("format");
 	i->AddParam("headerSize");
 	i->code = INTRINSIC_LAMBDA {
-		String path = context->GetVar(String("fileName")).ToString();
-		int width = context->GetVar(String("width")).IntValue();
-		int height = context->GetVar(String("height")).IntValue();
-		int format = context->GetVar(String("format")).IntValue();
-		int headerSize = context->GetVar(String("headerSize")).IntValue();
+		String path = ARG("fileName").ToString();
+		if (!WaitForFile(path, partialResult)) return partialResult;
+		int width = ARG("width").IntValue();
+		int height = ARG("height").IntValue();
+		int format = ARG("format").IntValue();
+		int headerSize = ARG("headerSize").IntValue();
 		Image result = LoadImageRaw(path.c_str(), width, height, format, headerSize);
 		if (!IsImageValid(result)) return IntrinsicResult::Null;
 		return IntrinsicResult(ImageToValue(result));
 	};
-	raylibModule.SetValue("LoadImageRaw", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "LoadImageRaw", i);
 
 	// Memory management functions (no-ops as MiniScript handles memory)
 
@@ -1071,7 +1168,7 @@ void AddRTexturesMethods(ValueDict raylibModule) {
 		// No-op in MiniScript - memory is managed automatically
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("UnloadImageColors", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "UnloadImageColors", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("palette");
@@ -1079,108 +1176,97 @@ void AddRTexturesMethods(ValueDict raylibModule) {
 		// No-op in MiniScript - memory is managed automatically
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("UnloadImagePalette", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "UnloadImagePalette", i);
 
 	// Image manipulation - Alpha/Color
 
 	i = Intrinsic::Create("");
 	i->AddParam("image");
 	i->AddParam("threshold");
+	i->AddParam("into");
 	i->code = INTRINSIC_LAMBDA {
-		ValueDict imageMap = context->GetVar(String("image")).GetDict();
-		Value handleVal = imageMap.Lookup(String("_handle"), Value::zero);
-		Image* image = (Image*)(long)handleVal.IntValue();
+		Image* image = ValueToImagePtr(ARG("image"));
 		if (!image) return IntrinsicResult::Null;
-		float threshold = context->GetVar(String("threshold")).FloatValue();
+		float threshold = ARG("threshold").FloatValue();
 		Rectangle result = GetImageAlphaBorder(*image, threshold);
-		return IntrinsicResult(RectangleToValue(result));
+		return IntrinsicResult(RectangleToValue(result, ARG("into")));
 	};
-	raylibModule.SetValue("GetImageAlphaBorder", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetImageAlphaBorder", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("image");
 	i->AddParam("x");
 	i->AddParam("y");
 	i->code = INTRINSIC_LAMBDA {
-		Image image = ValueToImage(context->GetVar(String("image")));
-		int x = context->GetVar(String("x")).IntValue();
-		int y = context->GetVar(String("y")).IntValue();
+		Image image = ValueToImage(ARG("image"));
+		int x = ARG("x").IntValue();
+		int y = ARG("y").IntValue();
 		Color result = GetImageColor(image, x, y);
 		return IntrinsicResult(ColorToValue(result));
 	};
-	raylibModule.SetValue("GetImageColor", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "GetImageColor", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("image");
 	i->AddParam("color");
 	i->AddParam("threshold");
 	i->code = INTRINSIC_LAMBDA {
-		ValueDict imageMap = context->GetVar(String("image")).GetDict();
-		Value handleVal = imageMap.Lookup(String("_handle"), Value::zero);
-		Image* image = (Image*)(long)handleVal.IntValue();
+		Image* image = ValueToImagePtr(ARG("image"));
 		if (!image) return IntrinsicResult::Null;
-		Color color = ValueToColor(context->GetVar(String("color")));
-		float threshold = context->GetVar(String("threshold")).FloatValue();
+		Color color = ValueToColor(ARG("color"));
+		float threshold = ARG("threshold").FloatValue();
 		ImageAlphaClear(image, color, threshold);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageAlphaClear", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageAlphaClear", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("image");
 	i->AddParam("threshold");
 	i->code = INTRINSIC_LAMBDA {
-		ValueDict imageMap = context->GetVar(String("image")).GetDict();
-		Value handleVal = imageMap.Lookup(String("_handle"), Value::zero);
-		Image* image = (Image*)(long)handleVal.IntValue();
+		Image* image = ValueToImagePtr(ARG("image"));
 		if (!image) return IntrinsicResult::Null;
-		float threshold = context->GetVar(String("threshold")).FloatValue();
+		float threshold = ARG("threshold").FloatValue();
 		ImageAlphaCrop(image, threshold);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageAlphaCrop", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageAlphaCrop", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("image");
 	i->AddParam("alphaMask");
 	i->code = INTRINSIC_LAMBDA {
-		ValueDict imageMap = context->GetVar(String("image")).GetDict();
-		Value handleVal = imageMap.Lookup(String("_handle"), Value::zero);
-		Image* image = (Image*)(long)handleVal.IntValue();
+		Image* image = ValueToImagePtr(ARG("image"));
 		if (!image) return IntrinsicResult::Null;
-		Image alphaMask = ValueToImage(context->GetVar(String("alphaMask")));
+		Image alphaMask = ValueToImage(ARG("alphaMask"));
 		ImageAlphaMask(image, alphaMask);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageAlphaMask", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageAlphaMask", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("image");
 	i->code = INTRINSIC_LAMBDA {
-		ValueDict imageMap = context->GetVar(String("image")).GetDict();
-		Value handleVal = imageMap.Lookup(String("_handle"), Value::zero);
-		Image* image = (Image*)(long)handleVal.IntValue();
+		Image* image = ValueToImagePtr(ARG("image"));
 		if (!image) return IntrinsicResult::Null;
 		ImageAlphaPremultiply(image);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageAlphaPremultiply", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageAlphaPremultiply", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("image");
 	i->AddParam("color");
 	i->AddParam("replace");
 	i->code = INTRINSIC_LAMBDA {
-		ValueDict imageMap = context->GetVar(String("image")).GetDict();
-		Value handleVal = imageMap.Lookup(String("_handle"), Value::zero);
-		Image* image = (Image*)(long)handleVal.IntValue();
+		Image* image = ValueToImagePtr(ARG("image"));
 		if (!image) return IntrinsicResult::Null;
-		Color color = ValueToColor(context->GetVar(String("color")));
-		Color replace = ValueToColor(context->GetVar(String("replace")));
+		Color color = ValueToColor(ARG("color"));
+		Color replace = ValueToColor(ARG("replace"));
 		ImageColorReplace(image, color, replace);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageColorReplace", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageColorReplace", i);
 
 	// Image manipulation - Processing
 
@@ -1188,15 +1274,13 @@ void AddRTexturesMethods(ValueDict raylibModule) {
 	i->AddParam("image");
 	i->AddParam("blurSize");
 	i->code = INTRINSIC_LAMBDA {
-		ValueDict imageMap = context->GetVar(String("image")).GetDict();
-		Value handleVal = imageMap.Lookup(String("_handle"), Value::zero);
-		Image* image = (Image*)(long)handleVal.IntValue();
+		Image* image = ValueToImagePtr(ARG("image"));
 		if (!image) return IntrinsicResult::Null;
-		int blurSize = context->GetVar(String("blurSize")).IntValue();
+		int blurSize = ARG("blurSize").IntValue();
 		ImageBlurGaussian(image, blurSize);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageBlurGaussian", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageBlurGaussian", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("image");
@@ -1205,66 +1289,60 @@ void AddRTexturesMethods(ValueDict raylibModule) {
 	i->AddParam("bBpp");
 	i->AddParam("aBpp");
 	i->code = INTRINSIC_LAMBDA {
-		ValueDict imageMap = context->GetVar(String("image")).GetDict();
-		Value handleVal = imageMap.Lookup(String("_handle"), Value::zero);
-		Image* image = (Image*)(long)handleVal.IntValue();
+		Image* image = ValueToImagePtr(ARG("image"));
 		if (!image) return IntrinsicResult::Null;
-		int rBpp = context->GetVar(String("rBpp")).IntValue();
-		int gBpp = context->GetVar(String("gBpp")).IntValue();
-		int bBpp = context->GetVar(String("bBpp")).IntValue();
-		int aBpp = context->GetVar(String("aBpp")).IntValue();
+		int rBpp = ARG("rBpp").IntValue();
+		int gBpp = ARG("gBpp").IntValue();
+		int bBpp = ARG("bBpp").IntValue();
+		int aBpp = ARG("aBpp").IntValue();
 		ImageDither(image, rBpp, gBpp, bBpp, aBpp);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageDither", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageDither", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("image");
 	i->AddParam("newFormat");
 	i->code = INTRINSIC_LAMBDA {
-		ValueDict imageMap = context->GetVar(String("image")).GetDict();
-		Value handleVal = imageMap.Lookup(String("_handle"), Value::zero);
-		Image* image = (Image*)(long)handleVal.IntValue();
+		Image* image = ValueToImagePtr(ARG("image"));
 		if (!image) return IntrinsicResult::Null;
-		int newFormat = context->GetVar(String("newFormat")).IntValue();
+		int newFormat = ARG("newFormat").IntValue();
 		ImageFormat(image, newFormat);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageFormat", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageFormat", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("image");
 	i->AddParam("channel");
 	i->code = INTRINSIC_LAMBDA {
-		Image image = ValueToImage(context->GetVar(String("image")));
-		int channel = context->GetVar(String("channel")).IntValue();
+		Image image = ValueToImage(ARG("image"));
+		int channel = ARG("channel").IntValue();
 		Image result = ImageFromChannel(image, channel);
 		return IntrinsicResult(ImageToValue(result));
 	};
-	raylibModule.SetValue("ImageFromChannel", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageFromChannel", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("image");
 	i->AddParam("rec");
 	i->code = INTRINSIC_LAMBDA {
-		Image image = ValueToImage(context->GetVar(String("image")));
-		Rectangle rec = ValueToRectangle(context->GetVar(String("rec")));
+		Image image = ValueToImage(ARG("image"));
+		Rectangle rec = ValueToRectangle(ARG("rec"));
 		Image result = ImageFromImage(image, rec);
 		return IntrinsicResult(ImageToValue(result));
 	};
-	raylibModule.SetValue("ImageFromImage", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageFromImage", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("image");
 	i->AddParam("kernel");
 	i->AddParam("kernelSize");
 	i->code = INTRINSIC_LAMBDA {
-		ValueDict imageMap = context->GetVar(String("image")).GetDict();
-		Value handleVal = imageMap.Lookup(String("_handle"), Value::zero);
-		Image* image = (Image*)(long)handleVal.IntValue();
+		Image* image = ValueToImagePtr(ARG("image"));
 		if (!image) return IntrinsicResult::Null;
-		ValueList kernelList = context->GetVar(String("kernel")).GetList();
-		int kernelSize = context->GetVar(String("kernelSize")).IntValue();
+		ValueList kernelList = ARG("kernel").GetList();
+		int kernelSize = ARG("kernelSize").IntValue();
 		// Convert kernel list to float array
 		float* kernel = new float[kernelList.Count()];
 		for (int i = 0; i < kernelList.Count(); i++) {
@@ -1274,19 +1352,17 @@ void AddRTexturesMethods(ValueDict raylibModule) {
 		delete[] kernel;
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageKernelConvolution", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageKernelConvolution", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("image");
 	i->code = INTRINSIC_LAMBDA {
-		ValueDict imageMap = context->GetVar(String("image")).GetDict();
-		Value handleVal = imageMap.Lookup(String("_handle"), Value::zero);
-		Image* image = (Image*)(long)handleVal.IntValue();
+		Image* image = ValueToImagePtr(ARG("image"));
 		if (!image) return IntrinsicResult::Null;
 		ImageMipmaps(image);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageMipmaps", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageMipmaps", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("image");
@@ -1296,45 +1372,39 @@ void AddRTexturesMethods(ValueDict raylibModule) {
 	i->AddParam("newHeight");
 	i->AddParam("fill");
 	i->code = INTRINSIC_LAMBDA {
-		ValueDict imageMap = context->GetVar(String("image")).GetDict();
-		Value handleVal = imageMap.Lookup(String("_handle"), Value::zero);
-		Image* image = (Image*)(long)handleVal.IntValue();
+		Image* image = ValueToImagePtr(ARG("image"));
 		if (!image) return IntrinsicResult::Null;
-		int offsetX = context->GetVar(String("offsetX")).IntValue();
-		int offsetY = context->GetVar(String("offsetY")).IntValue();
-		int newWidth = context->GetVar(String("newWidth")).IntValue();
-		int newHeight = context->GetVar(String("newHeight")).IntValue();
-		Color fill = ValueToColor(context->GetVar(String("fill")));
+		int offsetX = ARG("offsetX").IntValue();
+		int offsetY = ARG("offsetY").IntValue();
+		int newWidth = ARG("newWidth").IntValue();
+		int newHeight = ARG("newHeight").IntValue();
+		Color fill = ValueToColor(ARG("fill"));
 		ImageResizeCanvas(image, newWidth, newHeight, offsetX, offsetY, fill);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageResizeCanvas", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageResizeCanvas", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("image");
 	i->AddParam("degrees");
 	i->code = INTRINSIC_LAMBDA {
-		ValueDict imageMap = context->GetVar(String("image")).GetDict();
-		Value handleVal = imageMap.Lookup(String("_handle"), Value::zero);
-		Image* image = (Image*)(long)handleVal.IntValue();
+		Image* image = ValueToImagePtr(ARG("image"));
 		if (!image) return IntrinsicResult::Null;
-		int degrees = context->GetVar(String("degrees")).IntValue();
+		int degrees = ARG("degrees").IntValue();
 		ImageRotate(image, degrees);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageRotate", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageRotate", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("image");
 	i->code = INTRINSIC_LAMBDA {
-		ValueDict imageMap = context->GetVar(String("image")).GetDict();
-		Value handleVal = imageMap.Lookup(String("_handle"), Value::zero);
-		Image* image = (Image*)(long)handleVal.IntValue();
+		Image* image = ValueToImagePtr(ARG("image"));
 		if (!image) return IntrinsicResult::Null;
 		ImageToPOT(image, BLACK);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageToPOT", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageToPOT", i);
 
 	// Image drawing functions
 
@@ -1345,18 +1415,16 @@ void AddRTexturesMethods(ValueDict raylibModule) {
 	i->AddParam("radius");
 	i->AddParam("color");
 	i->code = INTRINSIC_LAMBDA {
-		ValueDict dstMap = context->GetVar(String("dst")).GetDict();
-		Value handleVal = dstMap.Lookup(String("_handle"), Value::zero);
-		Image* dst = (Image*)(long)handleVal.IntValue();
+		Image* dst = ValueToImagePtr(ARG("dst"));
 		if (!dst) return IntrinsicResult::Null;
-		int centerX = context->GetVar(String("centerX")).IntValue();
-		int centerY = context->GetVar(String("centerY")).IntValue();
-		int radius = context->GetVar(String("radius")).IntValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+		int centerX = ARG("centerX").IntValue();
+		int centerY = ARG("centerY").IntValue();
+		int radius = ARG("radius").IntValue();
+		Color color = ValueToColor(ARG("color"));
 		ImageDrawCircleLines(dst, centerX, centerY, radius, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageDrawCircleLines", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageDrawCircleLines", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("dst");
@@ -1364,17 +1432,15 @@ void AddRTexturesMethods(ValueDict raylibModule) {
 	i->AddParam("radius");
 	i->AddParam("color");
 	i->code = INTRINSIC_LAMBDA {
-		ValueDict dstMap = context->GetVar(String("dst")).GetDict();
-		Value handleVal = dstMap.Lookup(String("_handle"), Value::zero);
-		Image* dst = (Image*)(long)handleVal.IntValue();
+		Image* dst = ValueToImagePtr(ARG("dst"));
 		if (!dst) return IntrinsicResult::Null;
-		Vector2 center = ValueToVector2(context->GetVar(String("center")));
-		int radius = context->GetVar(String("radius")).IntValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+		Vector2 center = ValueToVector2(ARG("center"));
+		int radius = ARG("radius").IntValue();
+		Color color = ValueToColor(ARG("color"));
 		ImageDrawCircleLinesV(dst, center, radius, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageDrawCircleLinesV", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageDrawCircleLinesV", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("dst");
@@ -1383,34 +1449,30 @@ void AddRTexturesMethods(ValueDict raylibModule) {
 	i->AddParam("thick");
 	i->AddParam("color");
 	i->code = INTRINSIC_LAMBDA {
-		ValueDict dstMap = context->GetVar(String("dst")).GetDict();
-		Value handleVal = dstMap.Lookup(String("_handle"), Value::zero);
-		Image* dst = (Image*)(long)handleVal.IntValue();
+		Image* dst = ValueToImagePtr(ARG("dst"));
 		if (!dst) return IntrinsicResult::Null;
-		Vector2 start = ValueToVector2(context->GetVar(String("start")));
-		Vector2 end = ValueToVector2(context->GetVar(String("end")));
-		int thick = context->GetVar(String("thick")).IntValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+		Vector2 start = ValueToVector2(ARG("start"));
+		Vector2 end = ValueToVector2(ARG("end"));
+		int thick = ARG("thick").IntValue();
+		Color color = ValueToColor(ARG("color"));
 		ImageDrawLineEx(dst, start, end, thick, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageDrawLineEx", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageDrawLineEx", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("dst");
 	i->AddParam("rec");
 	i->AddParam("color");
 	i->code = INTRINSIC_LAMBDA {
-		ValueDict dstMap = context->GetVar(String("dst")).GetDict();
-		Value handleVal = dstMap.Lookup(String("_handle"), Value::zero);
-		Image* dst = (Image*)(long)handleVal.IntValue();
+		Image* dst = ValueToImagePtr(ARG("dst"));
 		if (!dst) return IntrinsicResult::Null;
-		Rectangle rec = ValueToRectangle(context->GetVar(String("rec")));
-		Color color = ValueToColor(context->GetVar(String("color")));
+		Rectangle rec = ValueToRectangle(ARG("rec"));
+		Color color = ValueToColor(ARG("color"));
 		ImageDrawRectangleV(dst, (Vector2){rec.x, rec.y}, (Vector2){rec.width, rec.height}, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageDrawRectangleV", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageDrawRectangleV", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("dst");
@@ -1421,20 +1483,18 @@ void AddRTexturesMethods(ValueDict raylibModule) {
 	i->AddParam("spacing");
 	i->AddParam("tint");
 	i->code = INTRINSIC_LAMBDA {
-		ValueDict dstMap = context->GetVar(String("dst")).GetDict();
-		Value handleVal = dstMap.Lookup(String("_handle"), Value::zero);
-		Image* dst = (Image*)(long)handleVal.IntValue();
+		Image* dst = ValueToImagePtr(ARG("dst"));
 		if (!dst) return IntrinsicResult::Null;
-		Font font = ValueToFont(context->GetVar(String("font")));
-		String text = context->GetVar(String("text")).ToString();
-		Vector2 position = ValueToVector2(context->GetVar(String("position")));
-		float fontSize = context->GetVar(String("fontSize")).FloatValue();
-		float spacing = context->GetVar(String("spacing")).FloatValue();
-		Color tint = ValueToColor(context->GetVar(String("tint")));
+		Font font = ValueToFont(ARG("font"));
+		String text = ARG("text").ToString();
+		Vector2 position = ValueToVector2(ARG("position"));
+		float fontSize = ARG("fontSize").FloatValue();
+		float spacing = ARG("spacing").FloatValue();
+		Color tint = ValueToColor(ARG("tint"));
 		ImageDrawTextEx(dst, font, text.c_str(), position, fontSize, spacing, tint);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageDrawTextEx", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageDrawTextEx", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("dst");
@@ -1443,18 +1503,16 @@ void AddRTexturesMethods(ValueDict raylibModule) {
 	i->AddParam("v3");
 	i->AddParam("color");
 	i->code = INTRINSIC_LAMBDA {
-		ValueDict dstMap = context->GetVar(String("dst")).GetDict();
-		Value handleVal = dstMap.Lookup(String("_handle"), Value::zero);
-		Image* dst = (Image*)(long)handleVal.IntValue();
+		Image* dst = ValueToImagePtr(ARG("dst"));
 		if (!dst) return IntrinsicResult::Null;
-		Vector2 v1 = ValueToVector2(context->GetVar(String("v1")));
-		Vector2 v2 = ValueToVector2(context->GetVar(String("v2")));
-		Vector2 v3 = ValueToVector2(context->GetVar(String("v3")));
-		Color color = ValueToColor(context->GetVar(String("color")));
+		Vector2 v1 = ValueToVector2(ARG("v1"));
+		Vector2 v2 = ValueToVector2(ARG("v2"));
+		Vector2 v3 = ValueToVector2(ARG("v3"));
+		Color color = ValueToColor(ARG("color"));
 		ImageDrawTriangle(dst, v1, v2, v3, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageDrawTriangle", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageDrawTriangle", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("dst");
@@ -1465,43 +1523,39 @@ void AddRTexturesMethods(ValueDict raylibModule) {
 	i->AddParam("c2");
 	i->AddParam("c3");
 	i->code = INTRINSIC_LAMBDA {
-		ValueDict dstMap = context->GetVar(String("dst")).GetDict();
-		Value handleVal = dstMap.Lookup(String("_handle"), Value::zero);
-		Image* dst = (Image*)(long)handleVal.IntValue();
+		Image* dst = ValueToImagePtr(ARG("dst"));
 		if (!dst) return IntrinsicResult::Null;
-		Vector2 v1 = ValueToVector2(context->GetVar(String("v1")));
-		Vector2 v2 = ValueToVector2(context->GetVar(String("v2")));
-		Vector2 v3 = ValueToVector2(context->GetVar(String("v3")));
-		Color c1 = ValueToColor(context->GetVar(String("c1")));
-		Color c2 = ValueToColor(context->GetVar(String("c2")));
-		Color c3 = ValueToColor(context->GetVar(String("c3")));
+		Vector2 v1 = ValueToVector2(ARG("v1"));
+		Vector2 v2 = ValueToVector2(ARG("v2"));
+		Vector2 v3 = ValueToVector2(ARG("v3"));
+		Color c1 = ValueToColor(ARG("c1"));
+		Color c2 = ValueToColor(ARG("c2"));
+		Color c3 = ValueToColor(ARG("c3"));
 		ImageDrawTriangleEx(dst, v1, v2, v3, c1, c2, c3);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageDrawTriangleEx", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageDrawTriangleEx", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("dst");
 	i->AddParam("points");
 	i->AddParam("color");
 	i->code = INTRINSIC_LAMBDA {
-		ValueDict dstMap = context->GetVar(String("dst")).GetDict();
-		Value handleVal = dstMap.Lookup(String("_handle"), Value::zero);
-		Image* dst = (Image*)(long)handleVal.IntValue();
+		Image* dst = ValueToImagePtr(ARG("dst"));
 		if (!dst) return IntrinsicResult::Null;
-		ValueList pointsList = context->GetVar(String("points")).GetList();
+		ValueList pointsList = ARG("points").GetList();
 		int pointCount = pointsList.Count();
 		if (pointCount < 3) return IntrinsicResult::Null;
 		Vector2* points = new Vector2[pointCount];
 		for (int i = 0; i < pointCount; i++) {
 			points[i] = ValueToVector2(pointsList[i]);
 		}
-		Color color = ValueToColor(context->GetVar(String("color")));
+		Color color = ValueToColor(ARG("color"));
 		ImageDrawTriangleFan(dst, points, pointCount, color);
 		delete[] points;
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageDrawTriangleFan", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageDrawTriangleFan", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("dst");
@@ -1510,54 +1564,50 @@ void AddRTexturesMethods(ValueDict raylibModule) {
 	i->AddParam("v3");
 	i->AddParam("color");
 	i->code = INTRINSIC_LAMBDA {
-		ValueDict dstMap = context->GetVar(String("dst")).GetDict();
-		Value handleVal = dstMap.Lookup(String("_handle"), Value::zero);
-		Image* dst = (Image*)(long)handleVal.IntValue();
+		Image* dst = ValueToImagePtr(ARG("dst"));
 		if (!dst) return IntrinsicResult::Null;
-		Vector2 v1 = ValueToVector2(context->GetVar(String("v1")));
-		Vector2 v2 = ValueToVector2(context->GetVar(String("v2")));
-		Vector2 v3 = ValueToVector2(context->GetVar(String("v3")));
-		Color color = ValueToColor(context->GetVar(String("color")));
+		Vector2 v1 = ValueToVector2(ARG("v1"));
+		Vector2 v2 = ValueToVector2(ARG("v2"));
+		Vector2 v3 = ValueToVector2(ARG("v3"));
+		Color color = ValueToColor(ARG("color"));
 		ImageDrawTriangleLines(dst, v1, v2, v3, color);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageDrawTriangleLines", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageDrawTriangleLines", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("dst");
 	i->AddParam("points");
 	i->AddParam("color");
 	i->code = INTRINSIC_LAMBDA {
-		ValueDict dstMap = context->GetVar(String("dst")).GetDict();
-		Value handleVal = dstMap.Lookup(String("_handle"), Value::zero);
-		Image* dst = (Image*)(long)handleVal.IntValue();
+		Image* dst = ValueToImagePtr(ARG("dst"));
 		if (!dst) return IntrinsicResult::Null;
-		ValueList pointsList = context->GetVar(String("points")).GetList();
+		ValueList pointsList = ARG("points").GetList();
 		int pointCount = pointsList.Count();
 		if (pointCount < 3) return IntrinsicResult::Null;
 		Vector2* points = new Vector2[pointCount];
 		for (int i = 0; i < pointCount; i++) {
 			points[i] = ValueToVector2(pointsList[i]);
 		}
-		Color color = ValueToColor(context->GetVar(String("color")));
+		Color color = ValueToColor(ARG("color"));
 		ImageDrawTriangleStrip(dst, points, pointCount, color);
 		delete[] points;
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("ImageDrawTriangleStrip", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageDrawTriangleStrip", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("text");
 	i->AddParam("fontSize");
 	i->AddParam("color");
 	i->code = INTRINSIC_LAMBDA {
-		String text = context->GetVar(String("text")).ToString();
-		int fontSize = context->GetVar(String("fontSize")).IntValue();
-		Color color = ValueToColor(context->GetVar(String("color")));
+		String text = ARG("text").ToString();
+		int fontSize = ARG("fontSize").IntValue();
+		Color color = ValueToColor(ARG("color"));
 		Image result = ImageText(text.c_str(), fontSize, color);
 		return IntrinsicResult(ImageToValue(result));
 	};
-	raylibModule.SetValue("ImageText", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageText", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("font");
@@ -1566,15 +1616,15 @@ void AddRTexturesMethods(ValueDict raylibModule) {
 	i->AddParam("spacing");
 	i->AddParam("tint");
 	i->code = INTRINSIC_LAMBDA {
-		Font font = ValueToFont(context->GetVar(String("font")));
-		String text = context->GetVar(String("text")).ToString();
-		float fontSize = context->GetVar(String("fontSize")).FloatValue();
-		float spacing = context->GetVar(String("spacing")).FloatValue();
-		Color tint = ValueToColor(context->GetVar(String("tint")));
+		Font font = ValueToFont(ARG("font"));
+		String text = ARG("text").ToString();
+		float fontSize = ARG("fontSize").FloatValue();
+		float spacing = ARG("spacing").FloatValue();
+		Color tint = ValueToColor(ARG("tint"));
 		Image result = ImageTextEx(font, text.c_str(), fontSize, spacing, tint);
 		return IntrinsicResult(ImageToValue(result));
 	};
-	raylibModule.SetValue("ImageTextEx", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "ImageTextEx", i);
 
 	// Additional texture functions
 
@@ -1582,12 +1632,12 @@ void AddRTexturesMethods(ValueDict raylibModule) {
 	i->AddParam("texture");
 	i->AddParam("nPatchInfo");
 	i->AddParam("dest");
-	i->AddParam("origin", Vector2ToValue(Vector2{0, 0}));
+	i->AddParam("origin", DefaultVector2Value(Vector2{0, 0}));
 	i->AddParam("rotation", Value::zero);
-	i->AddParam("tint", ColorToValue(WHITE));
+	i->AddParam("tint", DefaultColorValue(WHITE));
 	i->code = INTRINSIC_LAMBDA {
-		Texture2D texture = ValueToTexture(context->GetVar(String("texture")));
-		ValueDict nPatchDict = context->GetVar(String("nPatchInfo")).GetDict();
+		Texture2D texture = ValueToTexture(ARG("texture"));
+		ValueDict nPatchDict = ARG("nPatchInfo").GetDict();
 		NPatchInfo nPatchInfo;
 		ValueDict sourceDict = nPatchDict.Lookup(String("source"), Value::null).GetDict();
 		nPatchInfo.source.x = sourceDict.Lookup(String("x"), Value::zero).FloatValue();
@@ -1599,49 +1649,50 @@ void AddRTexturesMethods(ValueDict raylibModule) {
 		nPatchInfo.right = nPatchDict.Lookup(String("right"), Value::zero).IntValue();
 		nPatchInfo.bottom = nPatchDict.Lookup(String("bottom"), Value::zero).IntValue();
 		nPatchInfo.layout = nPatchDict.Lookup(String("layout"), Value::zero).IntValue();
-		Rectangle dest = ValueToRectangle(context->GetVar(String("dest")));
-		Vector2 origin = ValueToVector2(context->GetVar(String("origin")));
-		float rotation = context->GetVar(String("rotation")).FloatValue();
-		Color tint = ValueToColor(context->GetVar(String("tint")));
+		Rectangle dest = ValueToRectangle(ARG("dest"));
+		Vector2 origin = ValueToVector2(ARG("origin"));
+		float rotation = ARG("rotation").FloatValue();
+		Color tint = ValueToColor(ARG("tint"));
 		DrawTextureNPatch(texture, nPatchInfo, dest, origin, rotation, tint);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("DrawTextureNPatch", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "DrawTextureNPatch", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("texture");
 	i->AddParam("pixels");
 	i->code = INTRINSIC_LAMBDA {
-		Texture2D texture = ValueToTexture(context->GetVar(String("texture")));
-		BinaryData* data = ValueToRawData(context->GetVar(String("pixels")));
+		Texture2D texture = ValueToTexture(ARG("texture"));
+		BinaryData* data = ValueToRawData(ARG("pixels"));
 		if (!data) return IntrinsicResult::Null;
+		TraceScope trace("texture update", "upload");
 		UpdateTexture(texture, data->bytes);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("UpdateTexture", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "UpdateTexture", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("texture");
 	i->AddParam("rec");
 	i->AddParam("pixels");
 	i->code = INTRINSIC_LAMBDA {
-		Texture2D texture = ValueToTexture(context->GetVar(String("texture")));
-		Rectangle rec = ValueToRectangle(context->GetVar(String("rec")));
-		BinaryData* data = ValueToRawData(context->GetVar(String("pixels")));
+		Texture2D texture = ValueToTexture(ARG("texture"));
+		Rectangle rec = ValueToRectangle(ARG("rec"));
+		BinaryData* data = ValueToRawData(ARG("pixels"));
 		if (!data) return IntrinsicResult::Null;
 		UpdateTextureRec(texture, rec, data->bytes);
 		return IntrinsicResult::Null;
 	};
-	raylibModule.SetValue("UpdateTextureRec", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "UpdateTextureRec", i);
 
 	i = Intrinsic::Create("");
 	i->AddParam("image");
 	i->AddParam("layout");
 	i->code = INTRINSIC_LAMBDA {
-		Image image = ValueToImage(context->GetVar(String("image")));
-		int layout = context->GetVar(String("layout")).IntValue();
+		Image image = ValueToImage(ARG("image"));
+		int layout = ARG("layout").IntValue();
 		Texture2D result = LoadTextureCubemap(image, layout);
 		return IntrinsicResult(TextureToValue(result));
 	};
-	raylibModule.SetValue("LoadTextureCubemap", i->GetFunc());
+	RegisterIntrinsic(raylibModule, "LoadTextureCubemap", i);
 }
@@ -7,15 +7,13 @@
 
 #include "RawData.h"
 #include "MiniscriptInterpreter.h"
+#include "macros.h"
 #include <cstdlib>
 #include <cstring>
 #include <stdexcept>
 
 namespace MiniScript {
 
-// Macro to reduce boilerplate
-#define INTRINSIC_LAMBDA [](Context *context, IntrinsicResult partialResult) -> IntrinsicResult
-
 // Check if this system is little endian
 static bool IsSystemLittleEndian() {
     uint16_t test = 0x0001;
@@ -88,6 +86,10 @@ void BinaryData::TakeOwnership() {
     ownsBuffer = true;
 }
 
+bool BinaryData::IsNativeOrder() const {
+    return littleEndian == kSystemIsLittleEndian;
+}
+
 uint16_t BinaryData::SwapUInt16(uint16_t value) const {
     return ((value & 0xFF00) >> 8) | ((value & 0x00FF) << 8);
 }
@@ -295,7 +297,7 @@ ValueDict RawDataClass() {
     f->AddParam("self");
     f->AddParam("bytes", 32);
     f->code = INTRINSIC_LAMBDA {
-        int newSize = context->GetVar(String("bytes")).IntValue();
+        int newSize = ARG("bytes").IntValue();
         if (newSize < 0) {
             RuntimeException("bytes parameter must be >= 0").raise();
         }
@@ -332,7 +334,7 @@ ValueDict RawDataClass() {
     f->AddParam("self");
     f->AddParam("offset", 0);
     f->code = INTRINSIC_LAMBDA {
-        int offset = context->GetVar(String("offset")).IntValue();
+        int offset = ARG("offset").IntValue();
         BinaryData* data = GetBinaryData(context);
         if (data == nullptr) IndexException().raise();
 
@@ -349,8 +351,8 @@ ValueDict RawDataClass() {
     f->AddParam("offset", 0);
     f->AddParam("value", 0);
     f->code = INTRINSIC_LAMBDA {
-        int offset = context->GetVar(String("offset")).IntValue();
-        int value = context->GetVar(String("value")).IntValue();
+        int offset = ARG("offset").IntValue();
+        int value = ARG("value").IntValue();
         BinaryData* data = GetBinaryData(context);
         if (data == nullptr) IndexException().raise();
 
@@ -367,7 +369,7 @@ ValueDict RawDataClass() {
     f->AddParam("self");
     f->AddParam("offset", 0);
     f->code = INTRINSIC_LAMBDA {
-        int offset = context->GetVar(String("offset")).IntValue();
+        int offset = ARG("offset").IntValue();
         BinaryData* data = GetBinaryData(context);
         if (data == nullptr) IndexException().raise();
 
@@ -384,8 +386,8 @@ ValueDict RawDataClass() {
     f->AddParam("offset", 0);
     f->AddParam("value", 0);
     f->code = INTRINSIC_LAMBDA {
-        int offset = context->GetVar(String("offset")).IntValue();
-        int value = context->GetVar(String("value")).IntValue();
+        int offset = ARG("offset").IntValue();
+        int value = ARG("value").IntValue();
         BinaryData* data = GetBinaryData(context);
         if (data == nullptr) IndexException().raise();
 
@@ -402,7 +404,7 @@ ValueDict RawDataClass() {
     f->AddParam("self");
     f->AddParam("offset", 0);
     f->code = INTRINSIC_LAMBDA {
-        int offset = context->GetVar(String("offset")).IntValue();
+        int offset = ARG("offset").IntValue();
         BinaryData* data = GetBinaryData(context);
         if (data == nullptr) IndexException().raise();
 
@@ -419,8 +421,8 @@ ValueDict RawDataClass() {
     f->AddParam("offset", 0);
     f->AddParam("value", 0);
     f->code = INTRINSIC_LAMBDA {
-        int offset = context->GetVar(String("offset")).IntValue();
-        int value = context->GetVar(String("value")).IntValue();
+        int offset = ARG("offset").IntValue();
+        int value = ARG("value").IntValue();
         BinaryData* data = GetBinaryData(context);
         if (data == nullptr) IndexException().raise();
 
@@ -437,7 +439,7 @@ ValueDict RawDataClass() {
     f->AddParam("self");
     f->AddParam("offset", 0);
     f->code = INTRINSIC_LAMBDA {
-        int offset = context->GetVar(String("offset")).IntValue();
+        int offset = ARG("offset").IntValue();
         BinaryData* data = GetBinaryData(context);
         if (data == nullptr) IndexException().raise();
 
@@ -454,8 +456,8 @@ ValueDict RawDataClass() {
     f->AddParam("offset", 0);
     f->AddParam("value", 0);
     f->code = INTRINSIC_LAMBDA {
-        int offset = context->GetVar(String("offset")).IntValue();
-        int value = context->GetVar(String("value")).IntValue();
+        int offset = ARG("offset").IntValue();
+        int value = ARG("value").IntValue();
         BinaryData* data = GetBinaryData(context);
         if (data == nullptr) IndexException().raise();
 
@@ -472,7 +474,7 @@ ValueDict RawDataClass() {
     f->AddParam("self");
     f->AddParam("offset", 0);
     f->code = INTRINSIC_LAMBDA {
-        int offset = context->GetVar(String("offset")).IntValue();
+        int offset = ARG("offset").IntValue();
         BinaryData* data = GetBinaryData(context);
         if (data == nullptr) IndexException().raise();
 
@@ -489,8 +491,8 @@ ValueDict RawDataClass() {
     f->AddParam("offset", 0);
     f->AddParam("value", 0);
     f->code = INTRINSIC_LAMBDA {
-        int offset = context->GetVar(String("offset")).IntValue();
-        double value = context->GetVar(String("value")).DoubleValue();
+        int offset = ARG("offset").IntValue();
+        double value = ARG("value").DoubleValue();
         BinaryData* data = GetBinaryData(context);
         if (data == nullptr) IndexException().raise();
 
@@ -507,7 +509,7 @@ ValueDict RawDataClass() {
     f->AddParam("self");
     f->AddParam("offset", 0);
     f->code = INTRINSIC_LAMBDA {
-        int offset = context->GetVar(String("offset")).IntValue();
+        int offset = ARG("offset").IntValue();
         BinaryData* data = GetBinaryData(context);
         if (data == nullptr) IndexException().raise();
 
@@ -524,8 +526,8 @@ ValueDict RawDataClass() {
     f->AddParam("offset", 0);
     f->AddParam("value", 0);
     f->code = INTRINSIC_LAMBDA {
-        int offset = context->GetVar(String("offset")).IntValue();
-        int value = context->GetVar(String("value")).IntValue();
+        int offset = ARG("offset").IntValue();
+        int value = ARG("value").IntValue();
         BinaryData* data = GetBinaryData(context);
         if (data == nullptr) IndexException().raise();
 
@@ -542,7 +544,7 @@ ValueDict RawDataClass() {
     f->AddParam("self");
     f->AddParam("offset", 0);
     f->code = INTRINSIC_LAMBDA {
-        int offset = context->GetVar(String("offset")).IntValue();
+        int offset = ARG("offset").IntValue();
         BinaryData* data = GetBinaryData(context);
         if (data == nullptr) IndexException().raise();
 
@@ -559,8 +561,8 @@ ValueDict RawDataClass() {
     f->AddParam("offset", 0);
     f->AddParam("value", 0);
     f->code = INTRINSIC_LAMBDA {
-        int offset = context->GetVar(String("offset")).IntValue();
-        float value = context->GetVar(String("value")).FloatValue();
+        int offset = ARG("offset").IntValue();
+        float value = ARG("value").FloatValue();
         BinaryData* data = GetBinaryData(context);
         if (data == nullptr) IndexException().raise();
 
@@ -577,7 +579,7 @@ ValueDict RawDataClass() {
     f->AddParam("self");
     f->AddParam("offset", 0);
     f->code = INTRINSIC_LAMBDA {
-        int offset = context->GetVar(String("offset")).IntValue();
+        int offset = ARG("offset").IntValue();
         BinaryData* data = GetBinaryData(context);
         if (data == nullptr) IndexException().raise();
 
@@ -594,8 +596,8 @@ ValueDict RawDataClass() {
     f->AddParam("offset", 0);
     f->AddParam("value", 0);
     f->code = INTRINSIC_LAMBDA {
-        int offset = context->GetVar(String("offset")).IntValue();
-        double value = context->GetVar(String("value")).DoubleValue();
+        int offset = ARG("offset").IntValue();
+        double value = ARG("value").DoubleValue();
         BinaryData* data = GetBinaryData(context);
         if (data == nullptr) IndexException().raise();
 
@@ -613,8 +615,8 @@ ValueDict RawDataClass() {
     f->AddParam("offset", 0);
     f->AddParam("bytes", -1);
     f->code = INTRINSIC_LAMBDA {
-        int offset = context->GetVar(String("offset")).IntValue();
-        int byteCount = context->GetVar(String("bytes")).IntValue();
+        int offset = ARG("offset").IntValue();
+        int byteCount = ARG("bytes").IntValue();
         BinaryData* data = GetBinaryData(context);
         if (data == nullptr) IndexException().raise();
 
@@ -632,8 +634,8 @@ ValueDict RawDataClass() {
     f->AddParam("offset", 0);
     f->AddParam("value", "");
     f->code = INTRINSIC_LAMBDA {
-        int offset = context->GetVar(String("offset")).IntValue();
-        String value = context->GetVar(String("value")).ToString();
+        int offset = ARG("offset").IntValue();
+        String value = ARG("value").ToString();
         if (value.empty()) return IntrinsicResult(Value::zero);
 
         BinaryData* data = GetBinaryData(context);
@@ -677,4 +679,22 @@ BinaryData* ValueToRawData(Value value) {
     return data;
 }
 
+BinaryData* ValueToRecordBuffer(Value value, int& count, int& stride, int recordSize, const char* funcName) {
+    BinaryData* data = ValueToRawData(value);
+    if (data == nullptr || data->bytes == nullptr) {
+        RuntimeException(String(funcName) + ": RawData required").raise();
+    }
+    if (stride <= 0) stride = recordSize;
+    if (stride < recordSize) {
+        RuntimeException(String(funcName) + ": stride must be at least " + String::Format(recordSize)).raise();
+    }
+    int fit = data->length < recordSize ? 0 : (data->length - recordSize) / stride + 1;
+    if (count < 0) {
+        count = fit;
+    } else if (count > fit) {
+        RuntimeException(String(funcName) + ": RawData too small for " + String::Format(count) + " records").raise();
+    }
+    return data;
+}
+
 } // namespace MiniScript
@@ -39,6 +39,10 @@ public:
     // Take ownership of the buffer (we will free it)
     void TakeOwnership();
 
+    // True if the buffer's byte order is this system's, so its values can
+    // be used in place without swapping
+    bool IsNativeOrder() const;
+
     // Typed read/write methods
     uint8_t GetUInt8(int offset) const;
     void SetUInt8(int offset, uint8_t value);
@@ -81,6 +85,13 @@ ValueDict RawDataClass();
 Value RawDataToValue(BinaryData* data);
 BinaryData* ValueToRawData(Value value);
 
+// Get the BinaryData of a RawData holding packed records (as used by the batch
+// drawing functions), checking that it holds `count` records of `recordSize`
+// bytes, `stride` bytes apart.  A stride of 0 means recordSize; a negative
+// count means as many records as fit (and is updated to that number).
+// Raises a runtime error if the value isn't a RawData, or is too small.
+BinaryData* ValueToRecordBuffer(Value value, int& count, int& stride, int recordSize, const char* funcName);
+
 } // namespace MiniScript
 
 #endif // RAWDATA_H
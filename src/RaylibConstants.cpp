@@ -7,39 +7,47 @@
 
 #include "RaylibIntrinsics.h"
 #include "RaylibTypes.h"
+#include "scheduler.h"
 #include "raylib.h"
 #include "MiniscriptTypes.h"
 
 using namespace MiniScript;
 
+// Add a color constant: a map (e.g. RED), and the same color as a packed
+// number (e.g. RED_INT), which is quicker to pass and can't be changed
+static void AddColorConstant(ValueDict raylibModule, const char *name, Color color) {
+	raylibModule.SetValue(name, ColorToMap(color));
+	raylibModule.SetValue(String(name) + "_INT", Value((double)PackColor(color)));
+}
+
 void AddConstants(ValueDict raylibModule) {
 	// Add color constants (all colors from raylib.h)
-	raylibModule.SetValue("LIGHTGRAY", ColorToValue(LIGHTGRAY));
-	raylibModule.SetValue("GRAY", ColorToValue(GRAY));
-	raylibModule.SetValue("DARKGRAY", ColorToValue(DARKGRAY));
-	raylibModule.SetValue("YELLOW", ColorToValue(YELLOW));
-	raylibModule.SetValue("GOLD", ColorToValue(GOLD));
-	raylibModule.SetValue("ORANGE", ColorToValue(ORANGE));
-	raylibModule.SetValue("PINK", ColorToValue(PINK));
-	raylibModule.SetValue("RED", ColorToValue(RED));
-	raylibModule.SetValue("MAROON", ColorToValue(MAROON));
-	raylibModule.SetValue("GREEN", ColorToValue(GREEN));
-	raylibModule.SetValue("LIME", ColorToValue(LIME));
-	raylibModule.SetValue("DARKGREEN", ColorToValue(DARKGREEN));
-	raylibModule.SetValue("SKYBLUE", ColorToValue(SKYBLUE));
-	raylibModule.SetValue("BLUE", ColorToValue(BLUE));
-	raylibModule.SetValue("DARKBLUE", ColorToValue(DARKBLUE));
-	raylibModule.SetValue("PURPLE", ColorToValue(PURPLE));
-	raylibModule.SetValue("VIOLET", ColorToValue(VIOLET));
-	raylibModule.SetValue("DARKPURPLE", ColorToValue(DARKPURPLE));
-	raylibModule.SetValue("BEIGE", ColorToValue(BEIGE));
-	raylibModule.SetValue("BROWN", ColorToValue(BROWN));
-	raylibModule.SetValue("DARKBROWN", ColorToValue(DARKBROWN));
-	raylibModule.SetValue("WHITE", ColorToValue(WHITE));
-	raylibModule.SetValue("BLACK", ColorToValue(BLACK));
-	raylibModule.SetValue("BLANK", ColorToValue(BLANK));
-	raylibModule.SetValue("MAGENTA", ColorToValue(MAGENTA));
-	raylibModule.SetValue("RAYWHITE", ColorToValue(RAYWHITE));
+	AddColorConstant(raylibModule, "LIGHTGRAY", LIGHTGRAY);
+	AddColorConstant(raylibModule, "GRAY", GRAY);
+	AddColorConstant(raylibModule, "DARKGRAY", DARKGRAY);
+	AddColorConstant(raylibModule, "YELLOW", YELLOW);
+	AddColorConstant(raylibModule, "GOLD", GOLD);
+	AddColorConstant(raylibModule, "ORANGE", ORANGE);
+	AddColorConstant(raylibModule, "PINK", PINK);
+	AddColorConstant(raylibModule, "RED", RED);
+	AddColorConstant(raylibModule, "MAROON", MAROON);
+	AddColorConstant(raylibModule, "GREEN", GREEN);
+	AddColorConstant(raylibModule, "LIME", LIME);
+	AddColorConstant(raylibModule, "DARKGREEN", DARKGREEN);
+	AddColorConstant(raylibModule, "SKYBLUE", SKYBLUE);
+	AddColorConstant(raylibModule, "BLUE", BLUE);
+	AddColorConstant(raylibModule, "DARKBLUE", DARKBLUE);
+	AddColorConstant(raylibModule, "PURPLE", PURPLE);
+	AddColorConstant(raylibModule, "VIOLET", VIOLET);
+	AddColorConstant(raylibModule, "DARKPURPLE", DARKPURPLE);
+	AddColorConstant(raylibModule, "BEIGE", BEIGE);
+	AddColorConstant(raylibModule, "BROWN", BROWN);
+	AddColorConstant(raylibModule, "DARKBROWN", DARKBROWN);
+	AddColorConstant(raylibModule, "WHITE", WHITE);
+	AddColorConstant(raylibModule, "BLACK", BLACK);
+	AddColorConstant(raylibModule, "BLANK", BLANK);
+	AddColorConstant(raylibModule, "MAGENTA", MAGENTA);
+	AddColorConstant(raylibModule, "RAYWHITE", RAYWHITE);
 
 	// Add keyboard key constants
 	raylibModule.SetValue("KEY_NULL", Value(KEY_NULL));
@@ -232,4 +240,12 @@ void AddConstants(ValueDict raylibModule) {
 	raylibModule.SetValue("LOG_ERROR", Value(LOG_ERROR));
 	raylibModule.SetValue("LOG_FATAL", Value(LOG_FATAL));
 	raylibModule.SetValue("LOG_NONE", Value(LOG_NONE));
+
+	// Add frame pacing constants (MSRLWeb extension)
+	raylibModule.SetValue("FRAME_PACING_MANUAL", Value(FRAME_PACING_MANUAL));
+	raylibModule.SetValue("FRAME_PACING_END_DRAWING", Value(FRAME_PACING_END_DRAWING));
+
+	// Add color format constants (MSRLWeb extension)
+	raylibModule.SetValue("COLOR_FORMAT_MAP", Value(COLOR_FORMAT_MAP));
+	raylibModule.SetValue("COLOR_FORMAT_INT", Value(COLOR_FORMAT_INT));
 }
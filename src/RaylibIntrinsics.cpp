@@ -9,13 +9,15 @@
 #include "RaylibTypes.h"
 #include "RawData.h"
 #include "raylib.h"
+#include "asyncload.h"
+#include "framestats.h"
+#include "profiler.h"
 #include "MiniscriptInterpreter.h"
 #include "MiniscriptTypes.h"
-#include <emscripten.h>
-#include <emscripten/fetch.h>
 #include <math.h>
 #include <string.h>
 #include <map>
+#include <utility>
 #include "macros.h"
 
 using namespace MiniScript;
@@ -30,6 +32,80 @@ void AddRTexturesMethods(ValueDict raylibModule);
 // And one more for all the constants
 void AddConstants(ValueDict raylibModule);
 
+// The raylib module is built from this table, one submodule at a time.
+// Building it all at once takes a noticeable while (hundreds of intrinsics),
+// so we do it a piece per frame while the main script is loading; anything
+// left when the script first uses the module is finished then.
+struct RaylibSubmodule {
+	const char *name;
+	void (*add)(ValueDict raylibModule);
+};
+
+static const RaylibSubmodule raylibSubmodules[] = {
+	{ "core", AddRCoreMethods },
+	{ "shapes", AddRShapesMethods },
+	{ "textures", AddRTexturesMethods },
+	{ "text", AddRTextMethods },
+	{ "audio", AddRAudioMethods },
+	{ "asyncload", AddAsyncLoadMethods },
+	{ "constants", AddConstants }
+};
+static const int raylibSubmoduleCount = sizeof(raylibSubmodules) / sizeof(raylibSubmodules[0]);
+
+static ValueDict raylibModule;
+static int raylibSubmodulesBuilt = 0;
+static StartupStats startupStats = { 0, 0, 0, 0 };
+
+bool BuildRaylibModuleStep() {
+	if (raylibSubmodulesBuilt >= raylibSubmoduleCount) return true;
+	double startTime = GetTime();
+	raylibSubmodules[raylibSubmodulesBuilt].add(raylibModule);
+	raylibSubmodulesBuilt++;
+	startupStats.moduleBuildTime += GetTime() - startTime;
+	startupStats.moduleEntries = raylibModule.Count();
+	return raylibSubmodulesBuilt >= raylibSubmoduleCount;
+}
+
+StartupStats& GetStartupStats() {
+	return startupStats;
+}
+
+// Every raylib intrinsic is wrapped in a trampoline that counts its calls,
+// and profiles them when that's turned on (see profiler.cpp).  Intrinsic code
+// is a plain function pointer, with no room for data, so each wrapped
+// intrinsic gets a trampoline of its own: CountedIntrinsic<N> calls the Nth
+// wrapped function.  (Intrinsics beyond the limit are left unwrapped.)
+static const int kMaxCountedIntrinsics = 1024;
+static IntrinsicCode countedCode[kMaxCountedIntrinsics];
+static int countedIntrinsics = 0;
+
+template <int N>
+static IntrinsicResult CountedIntrinsic(Context *context, IntrinsicResult partialResult) {
+	// (An intrinsic that's waiting on something is called again with its
+	// partial result; count only the first call.)
+	if (partialResult.Done()) CountIntrinsicCall();
+	if (intrinsicProfiling) return ProfileIntrinsic(N, countedCode[N], context, partialResult);
+	return countedCode[N](context, partialResult);
+}
+
+template <int... N>
+static const IntrinsicCode* CountingTrampolines(std::integer_sequence<int, N...>) {
+	static const IntrinsicCode trampolines[] = { &CountedIntrinsic<N>... };
+	return trampolines;
+}
+
+void RegisterIntrinsic(ValueDict raylibModule, const char *name, Intrinsic *i) {
+	static const IntrinsicCode* trampolines =
+		CountingTrampolines(std::make_integer_sequence<int, kMaxCountedIntrinsics>());
+	if (countedIntrinsics < kMaxCountedIntrinsics) {
+		countedCode[countedIntrinsics] = i->code;
+		i->code = trampolines[countedIntrinsics];
+		countedIntrinsics++;
+		AddProfiledIntrinsic(name);
+	}
+	raylibModule.SetValue(name, i->GetFunc());
+}
+
 // Add intrinsics to the interpreter
 void AddRaylibIntrinsics() {
 	Intrinsic *f;
@@ -62,17 +138,7 @@ void AddRaylibIntrinsics() {
 	// Create and register the main raylib module
 	f = Intrinsic::Create("raylib");
 	f->code = INTRINSIC_LAMBDA {
-		static ValueDict raylibModule;
-
-		if (raylibModule.Count() == 0) {
-			AddRAudioMethods(raylibModule);
-			AddRCoreMethods(raylibModule);
-			AddRShapesMethods(raylibModule);
-			AddRTextMethods(raylibModule);
-			AddRTexturesMethods(raylibModule);
-			AddConstants(raylibModule);
-		}
-
+		while (!BuildRaylibModuleStep()) {}
 		return IntrinsicResult(raylibModule);
 	};
 }
@@ -10,9 +10,33 @@
 
 namespace MiniScript {
 	class Interpreter;
+	class Intrinsic;
+	class ValueDict;
 }
 
 // Add Raylib intrinsics to the global state
 void AddRaylibIntrinsics();
 
+// Build the next part of the raylib module (which is otherwise built when
+// first used); returns true when the module is complete
+bool BuildRaylibModuleStep();
+
+// Add an intrinsic to the raylib module under the given name (wrapping it
+// so that its calls are counted; see GetFrameStats)
+void RegisterIntrinsic(MiniScript::ValueDict raylibModule, const char *name, MiniScript::Intrinsic *i);
+
+// Timing of startup, for finding out what delays the first frame
+// (all times in seconds; the last two are since the window was opened)
+struct StartupStats {
+	double moduleBuildTime;		// total time spent building the raylib module
+	int moduleEntries;			// number of functions and constants in it
+	double scriptStartTime;		// when the main script started running
+	double firstFrameTime;		// when the script first called EndDrawing
+};
+
+StartupStats& GetStartupStats();
+
+// Whether the script is between BeginDrawing and EndDrawing
+bool IsDrawingFrame();
+
 #endif // RAYLIBINTRINSICS_H
@@ -1,4 +1,13 @@
 #include "RaylibTypes.h"
+#include "handletable.h"
+#include "RawData.h"
+#include "loadfile.h"
+#include "MiniscriptIntrinsics.h"
+#include <algorithm>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
 
 ValueDict ImageClass() {
 	static ValueDict map;
@@ -89,13 +98,272 @@ ValueDict RenderTextureClass() {
 	return map;
 }
 
+//--------------------------------------------------------------------------------
+// Resource handles
+//--------------------------------------------------------------------------------
+
+// Each resource map's _handle refers to an entry in one of these tables
+static HandleTable<Image> images;
+static HandleTable<Texture> textures;
+static HandleTable<Font> fonts;
+static HandleTable<Wave> waves;
+static HandleTable<Music> musics;
+static HandleTable<Sound> sounds;
+static HandleTable<AudioStream> audioStreams;
+static HandleTable<RenderTexture2D> renderTextures;
+
+// Pinned files that music streams play from, by music handle
+static std::map<ResourceHandle, std::string> musicFiles;
+
+enum ResourceKind {
+	RESOURCE_IMAGE,
+	RESOURCE_TEXTURE,
+	RESOURCE_FONT,
+	RESOURCE_WAVE,
+	RESOURCE_MUSIC,
+	RESOURCE_SOUND,
+	RESOURCE_SOUND_ALIAS,
+	RESOURCE_AUDIO_STREAM,
+	RESOURCE_RENDER_TEXTURE
+};
+
+static const char* resourceKindNames[] = {
+	"Image", "Texture", "Font", "Wave", "Music", "Sound", "SoundAlias", "AudioStream", "RenderTexture"
+};
+
+static const Value handleKey("_handle");
+
+// VM whose current script line is recorded as each resource's creation site
+// (while resourceTracking is on)
+static Machine* resourceSiteVM = nullptr;
+static bool resourceTracking = false;
+
+void SetResourceSiteVM(Machine* vm) {
+	resourceSiteVM = vm;
+}
+
+void SetResourceTracking(bool enabled) {
+	resourceTracking = enabled;
+}
+
+bool IsResourceTracking() {
+	return resourceTracking;
+}
+
+// Unpin the file the given music was playing from, if any
+static void UnpinMusicFile(ResourceHandle handle) {
+	auto it = musicFiles.find(handle);
+	if (it == musicFiles.end()) return;
+	UnpinPreloadedFile(it->second.c_str());
+	musicFiles.erase(it);
+}
+
+// Is the resource with the given handle still loaded?
+static bool IsResourceLoaded(ResourceKind kind, ResourceHandle handle) {
+	switch (kind) {
+		case RESOURCE_IMAGE: return images.Get(handle) != nullptr;
+		case RESOURCE_TEXTURE: return textures.Get(handle) != nullptr;
+		case RESOURCE_FONT: return fonts.Get(handle) != nullptr;
+		case RESOURCE_WAVE: return waves.Get(handle) != nullptr;
+		case RESOURCE_MUSIC: return musics.Get(handle) != nullptr;
+		case RESOURCE_SOUND:
+		case RESOURCE_SOUND_ALIAS: return sounds.Get(handle) != nullptr;
+		case RESOURCE_AUDIO_STREAM: return audioStreams.Get(handle) != nullptr;
+		case RESOURCE_RENDER_TEXTURE: return renderTextures.Get(handle) != nullptr;
+	}
+	return false;
+}
+
+// Unload a resource the script has lost track of, if it hasn't already
+// been unloaded.  (A font's or render texture's own texture is unloaded
+// along with it, so we drop that texture's entry too.)
+static void UnloadResource(ResourceKind kind, ResourceHandle handle, ResourceHandle textureHandle) {
+	switch (kind) {
+		case RESOURCE_IMAGE:
+			if (Image* p = images.Get(handle)) { UnloadImage(*p); images.Remove(handle); }
+			break;
+		case RESOURCE_TEXTURE:
+			if (Texture* p = textures.Get(handle)) { UnloadTexture(*p); textures.Remove(handle); }
+			break;
+		case RESOURCE_FONT:
+			if (Font* p = fonts.Get(handle)) { UnloadFont(*p); fonts.Remove(handle); }
+			textures.Remove(textureHandle);
+			break;
+		case RESOURCE_WAVE:
+			if (Wave* p = waves.Get(handle)) { UnloadWave(*p); waves.Remove(handle); }
+			break;
+		case RESOURCE_MUSIC:
+			if (Music* p = musics.Get(handle)) { UnloadMusicStream(*p); musics.Remove(handle); }
+			UnpinMusicFile(handle);
+			break;
+		case RESOURCE_SOUND:
+			if (Sound* p = sounds.Get(handle)) { UnloadSound(*p); sounds.Remove(handle); }
+			break;
+		case RESOURCE_SOUND_ALIAS:
+			if (Sound* p = sounds.Get(handle)) { UnloadSoundAlias(*p); sounds.Remove(handle); }
+			break;
+		case RESOURCE_AUDIO_STREAM:
+			if (AudioStream* p = audioStreams.Get(handle)) { UnloadAudioStream(*p); audioStreams.Remove(handle); }
+			break;
+		case RESOURCE_RENDER_TEXTURE:
+			if (RenderTexture2D* p = renderTextures.Get(handle)) { UnloadRenderTexture(*p); renderTextures.Remove(handle); }
+			textures.Remove(textureHandle);
+			break;
+	}
+}
+
+// Remove the table entry of a borrowed resource (one raylib owns) whose map
+// the script has dropped, without unloading the resource.  (Each map of a
+// borrowed resource, like each call's result from GetFontDefault, has its
+// own entry.  A font's texture has its own map, which removes that entry.)
+static void ForgetResource(ResourceKind kind, ResourceHandle handle) {
+	switch (kind) {
+		case RESOURCE_IMAGE: images.Remove(handle); break;
+		case RESOURCE_TEXTURE: textures.Remove(handle); break;
+		case RESOURCE_FONT: fonts.Remove(handle); break;
+		case RESOURCE_WAVE: waves.Remove(handle); break;
+		case RESOURCE_MUSIC: musics.Remove(handle); break;
+		case RESOURCE_SOUND:
+		case RESOURCE_SOUND_ALIAS: sounds.Remove(handle); break;
+		case RESOURCE_AUDIO_STREAM: audioStreams.Remove(handle); break;
+		case RESOURCE_RENDER_TEXTURE: renderTextures.Remove(handle); break;
+	}
+}
+
+// A resource the script has dropped, waiting to be unloaded
+struct DroppedResource {
+	ResourceKind kind;
+	ResourceHandle handle;
+	ResourceHandle textureHandle;
+};
+
+static std::vector<DroppedResource> droppedResources;
+
+void UnloadDroppedResources() {
+	// (Index loop, in case unloading drops anything more.)
+	for (size_t i = 0; i < droppedResources.size(); i++) {
+		const DroppedResource& dropped = droppedResources[i];
+		UnloadResource(dropped.kind, dropped.handle, dropped.textureHandle);
+	}
+	droppedResources.clear();
+}
+
+// The value stored in a resource map's _handle.  MiniScript deletes it when
+// the last copy of the map goes away; if the script never unloaded the
+// resource, we queue it to be unloaded then (or for a borrowed one, just
+// remove its table entry).  All of these are kept in a list, for the
+// resource report.
+class ResourceRef : public RefCountedStorage {
+public:
+	ResourceRef(ResourceKind kind, ResourceHandle handle, bool owned, long bytes)
+	: kind(kind), handle(handle), textureHandle(0), owned(owned), bytes(bytes), prev(nullptr) {
+		if (resourceTracking && resourceSiteVM) {
+			ValueList stack = Intrinsics::StackList(resourceSiteVM);
+			if (stack.Count() > 0) site = stack[0].ToString();
+		}
+		next = first;
+		if (first) first->prev = this;
+		first = this;
+	}
+
+	virtual ~ResourceRef() {
+		if (!owned) {
+			ForgetResource(kind, handle);
+		} else if (IsResourceLoaded(kind, handle)) {
+			DroppedResource dropped = { kind, handle, textureHandle };
+			droppedResources.push_back(dropped);
+		}
+		if (prev) prev->next = next; else first = next;
+		if (next) next->prev = prev;
+	}
+
+	ResourceKind kind;
+	ResourceHandle handle;
+	ResourceHandle textureHandle;	// handle of a font's or render texture's texture
+	bool owned;						// false for resources raylib owns (e.g. the default font)
+	long bytes;						// approximate memory used (CPU or GPU)
+	String site;					// script location where it was created
+
+	ResourceRef *prev, *next;
+	static ResourceRef *first;
+};
+
+ResourceRef* ResourceRef::first = nullptr;
+
+static Value NewResourceRef(ResourceKind kind, ResourceHandle handle, bool owned, long bytes) {
+	return Value::NewHandle(new ResourceRef(kind, handle, owned, bytes));
+}
+
+// Get the handle stored in a resource map (0 if it's not a map, or has none)
+static ResourceHandle GetHandle(Value value) {
+	if (value.type != ValueType::Map) return 0;
+	Value handleVal = value.GetDict().Lookup(handleKey, Value::zero);
+	if (handleVal.type != ValueType::Handle) return 0;
+	return ((ResourceRef*)handleVal.data.ref)->handle;
+}
+
+// Look up the item for a resource map, returning nullptr if it has no handle,
+// and raising a runtime error if its handle is stale (it's been unloaded).
+template <typename T>
+static T* LookupHandle(HandleTable<T>& table, Value value, const char *typeName) {
+	ResourceHandle handle = GetHandle(value);
+	if (handle == 0) return nullptr;
+	T* item = table.Get(handle);
+	if (!item) {
+		RuntimeException(String(typeName) + " has already been unloaded (or is invalid)").raise();
+	}
+	return item;
+}
+
+static long TextureBytes(Texture texture) {
+	return GetPixelDataSize(texture.width, texture.height, texture.format);
+}
+
+ValueList GetResourceReport() {
+	// Group the loaded resources by type and creation site
+	typedef std::pair<int, std::string> GroupKey;		// (kind, site)
+	typedef std::pair<long, long> GroupTotals;			// (count, bytes)
+	std::map<GroupKey, GroupTotals> groups;
+	for (ResourceRef *ref = ResourceRef::first; ref; ref = ref->next) {
+		if (!ref->owned || !IsResourceLoaded(ref->kind, ref->handle)) continue;
+		GroupTotals& totals = groups[GroupKey((int)ref->kind, std::string(ref->site.c_str()))];
+		totals.first++;
+		totals.second += ref->bytes;
+	}
+
+	// ...and list them, biggest first
+	std::vector<std::pair<GroupKey, GroupTotals>> sorted(groups.begin(), groups.end());
+	std::sort(sorted.begin(), sorted.end(), [](const std::pair<GroupKey, GroupTotals>& a, const std::pair<GroupKey, GroupTotals>& b) {
+		return a.second.second > b.second.second;
+	});
+
+	ValueList result;
+	for (auto& group : sorted) {
+		ValueDict entry;
+		entry.SetValue(String("type"), String(resourceKindNames[group.first.first]));
+		entry.SetValue(String("site"), String(group.first.second.c_str()));
+		entry.SetValue(String("count"), Value((double)group.second.first));
+		entry.SetValue(String("bytes"), Value((double)group.second.second));
+		result.Add(entry);
+	}
+	return result;
+}
+
+void GetResourceTotals(long *count, long *bytes) {
+	*count = 0;
+	*bytes = 0;
+	for (ResourceRef *ref = ResourceRef::first; ref; ref = ref->next) {
+		if (!ref->owned || !IsResourceLoaded(ref->kind, ref->handle)) continue;
+		(*count)++;
+		*bytes += ref->bytes;
+	}
+}
+
 // Convert a Raylib Texture to a MiniScript map
-// Allocates the Texture on the heap and stores pointer in _handle
-Value TextureToValue(Texture texture) {
-	Texture* texPtr = new Texture(texture);
+Value TextureToValue(Texture texture, bool owned) {
 	ValueDict map;
 	map.SetValue(Value::magicIsA, TextureClass());
-	map.SetValue(String("_handle"), Value((long)texPtr));
+	map.SetValue(handleKey, NewResourceRef(RESOURCE_TEXTURE, textures.Add(texture), owned, TextureBytes(texture)));
 	map.SetValue(String("id"), Value((int)texture.id));
 	map.SetValue(String("width"), Value(texture.width));
 	map.SetValue(String("height"), Value(texture.height));
@@ -105,28 +373,24 @@ Value TextureToValue(Texture texture) {
 }
 
 // Extract a Raylib Texture from a MiniScript map
-// Returns the Texture by dereferencing the _handle pointer
 Texture ValueToTexture(Value value) {
-	if (value.type != ValueType::Map) {
-		// Return empty texture if not a map
-		return Texture{0, 0, 0, 0, 0};
-	}
-	ValueDict map = value.GetDict();
-	Value handleVal = map.Lookup(String("_handle"), Value::zero);
-	Texture* texPtr = (Texture*)(long)handleVal.IntValue();
+	Texture* texPtr = LookupHandle(textures, value, "Texture");
 	if (texPtr == nullptr) {
 		return Texture{0, 0, 0, 0, 0};
 	}
 	return *texPtr;
 }
 
+void ReleaseTexture(Value value) {
+	textures.Remove(GetHandle(value));
+}
+
 // Convert a Raylib Image to a MiniScript map
-// Allocates the Image on the heap and stores pointer in _handle
-Value ImageToValue(Image image) {
-	Image* imgPtr = new Image(image);
+Value ImageToValue(Image image, bool owned) {
+	long bytes = GetPixelDataSize(image.width, image.height, image.format);
 	ValueDict map;
 	map.SetValue(Value::magicIsA, ImageClass());
-	map.SetValue(String("_handle"), Value((long)imgPtr));
+	map.SetValue(handleKey, NewResourceRef(RESOURCE_IMAGE, images.Add(image), owned, bytes));
 	map.SetValue(String("width"), Value(image.width));
 	map.SetValue(String("height"), Value(image.height));
 	map.SetValue(String("mipmaps"), Value(image.mipmaps));
@@ -135,28 +399,38 @@ Value ImageToValue(Image image) {
 }
 
 // Extract a Raylib Image from a MiniScript map
-// Returns the Image by dereferencing the _handle pointer
 Image ValueToImage(Value value) {
-	if (value.type != ValueType::Map) {
-		// Return empty image if not a map
-		return Image{nullptr, 0, 0, 0, 0};
-	}
-	ValueDict map = value.GetDict();
-	Value handleVal = map.Lookup(String("_handle"), Value::zero);
-	Image* imgPtr = (Image*)(long)handleVal.IntValue();
+	Image* imgPtr = LookupHandle(images, value, "Image");
 	if (imgPtr == nullptr) {
 		return Image{nullptr, 0, 0, 0, 0};
 	}
 	return *imgPtr;
 }
 
+Image* ValueToImagePtr(Value value) {
+	return LookupHandle(images, value, "Image");
+}
+
+void ReleaseImage(Value value) {
+	images.Remove(GetHandle(value));
+}
+
 // Convert a Raylib Font to a MiniScript map
-Value FontToValue(Font font) {
-	Font* fontPtr = new Font(font);
+Value FontToValue(Font font, bool owned) {
+	long bytes = TextureBytes(font.texture) + font.glyphCount * (long)(sizeof(GlyphInfo) + sizeof(Rectangle));
+	for (int i = 0; font.glyphs && i < font.glyphCount; i++) {
+		Image& glyph = font.glyphs[i].image;
+		bytes += GetPixelDataSize(glyph.width, glyph.height, glyph.format);
+	}
+	// (The font's texture belongs to the font, and is unloaded with it.)
+	Value textureVal = TextureToValue(font.texture, false);
+	ResourceRef *ref = new ResourceRef(RESOURCE_FONT, fonts.Add(font), owned, bytes);
+	ref->textureHandle = GetHandle(textureVal);
+
 	ValueDict map;
 	map.SetValue(Value::magicIsA, FontClass());
-	map.SetValue(String("_handle"), Value((long)fontPtr));
-	map.SetValue(String("texture"), TextureToValue(font.texture));
+	map.SetValue(handleKey, Value::NewHandle(ref));
+	map.SetValue(String("texture"), textureVal);
 	map.SetValue(String("baseSize"), Value(font.baseSize));
 	map.SetValue(String("glyphCount"), Value(font.glyphCount));
 	map.SetValue(String("glyphPadding"), Value(font.glyphPadding));
@@ -170,29 +444,28 @@ Font ValueToFont(Value value) {
 		printf("ValueToFont: value is not a map, returning default font\n");
 		return GetFontDefault();
 	}
-	ValueDict map = value.GetDict();
-	Value handleVal = map.Lookup(String("_handle"), Value::zero);
-	long handle = handleVal.IntValue();
-	if (handle == 0) {
+	Font* fontPtr = LookupHandle(fonts, value, "Font");
+	if (fontPtr == nullptr) {
 		// If no handle, return default font
 		printf("ValueToFont: handle is 0, returning default font\n");
 		return GetFontDefault();
 	}
-	Font* fontPtr = (Font*)handle;
-	if (fontPtr == nullptr) {
-		printf("ValueToFont: fontPtr is null, returning default font\n");
-		return GetFontDefault();
-	}
-	Font font = *fontPtr;
-	return font;
+	return *fontPtr;
+}
+
+void ReleaseFont(Value value) {
+	if (value.type != ValueType::Map) return;
+	// (UnloadFont unloads the font's texture too)
+	ReleaseTexture(value.GetDict().Lookup(String("texture"), Value::null));
+	fonts.Remove(GetHandle(value));
 }
 
 // Convert a Raylib Wave to a MiniScript map
 Value WaveToValue(Wave wave) {
-	Wave* wavePtr = new Wave(wave);
+	long bytes = (long)wave.frameCount * wave.channels * wave.sampleSize / 8;
 	ValueDict map;
 	map.SetValue(Value::magicIsA, WaveClass());
-	map.SetValue(String("_handle"), Value((long)wavePtr));
+	map.SetValue(handleKey, NewResourceRef(RESOURCE_WAVE, waves.Add(wave), true, bytes));
 	map.SetValue(String("frameCount"), Value((int)wave.frameCount));
 	map.SetValue(String("sampleRate"), Value((int)wave.sampleRate));
 	map.SetValue(String("sampleSize"), Value((int)wave.sampleSize));
@@ -202,24 +475,25 @@ Value WaveToValue(Wave wave) {
 
 // Extract a Raylib Wave from a MiniScript map
 Wave ValueToWave(Value value) {
-	if (value.type != ValueType::Map) {
-		return Wave{NULL, 0, 0, 0, 0};
-	}
-	ValueDict map = value.GetDict();
-	Value handleVal = map.Lookup(String("_handle"), Value::zero);
-	Wave* wavePtr = (Wave*)(long)handleVal.IntValue();
+	Wave* wavePtr = LookupHandle(waves, value, "Wave");
 	if (wavePtr == nullptr) {
 		return Wave{NULL, 0, 0, 0, 0};
 	}
 	return *wavePtr;
 }
 
+void ReleaseWave(Value value) {
+	waves.Remove(GetHandle(value));
+}
+
 // Convert a Raylib Music to a MiniScript map
-Value MusicToValue(Music music) {
-	Music* musicPtr = new Music(music);
+Value MusicToValue(Music music, const char *pinnedFile) {
+	// (Music is streamed, so it needs little memory of its own.)
+	ResourceHandle handle = musics.Add(music);
+	if (pinnedFile) musicFiles[handle] = pinnedFile;
 	ValueDict map;
 	map.SetValue(Value::magicIsA, MusicClass());
-	map.SetValue(String("_handle"), Value((long)musicPtr));
+	map.SetValue(handleKey, NewResourceRef(RESOURCE_MUSIC, handle, true, 0));
 	map.SetValue(String("frameCount"), Value((int)music.frameCount));
 	map.SetValue(String("looping"), Value(music.looping ? 1 : 0));
 	return Value(map);
@@ -227,48 +501,49 @@ Value MusicToValue(Music music) {
 
 // Extract a Raylib Music from a MiniScript map
 Music ValueToMusic(Value value) {
-	if (value.type != ValueType::Map) {
-		return Music{};
-	}
-	ValueDict map = value.GetDict();
-	Value handleVal = map.Lookup(String("_handle"), Value::zero);
-	Music* musicPtr = (Music*)(long)handleVal.IntValue();
+	Music* musicPtr = LookupHandle(musics, value, "Music");
 	if (musicPtr == nullptr) {
 		return Music{};
 	}
 	return *musicPtr;
 }
 
+void ReleaseMusic(Value value) {
+	ResourceHandle handle = GetHandle(value);
+	musics.Remove(handle);
+	UnpinMusicFile(handle);
+}
+
 // Convert a Raylib Sound to a MiniScript map
-Value SoundToValue(Sound sound) {
-	Sound* soundPtr = new Sound(sound);
+Value SoundToValue(Sound sound, bool isAlias) {
+	// (An alias shares the sound data of its source.)
+	long bytes = isAlias ? 0 : (long)sound.frameCount * sound.stream.channels * sound.stream.sampleSize / 8;
+	ResourceKind kind = isAlias ? RESOURCE_SOUND_ALIAS : RESOURCE_SOUND;
 	ValueDict map;
 	map.SetValue(Value::magicIsA, SoundClass());
-	map.SetValue(String("_handle"), Value((long)soundPtr));
+	map.SetValue(handleKey, NewResourceRef(kind, sounds.Add(sound), true, bytes));
 	map.SetValue(String("frameCount"), Value((int)sound.frameCount));
 	return Value(map);
 }
 
 // Extract a Raylib Sound from a MiniScript map
 Sound ValueToSound(Value value) {
-	if (value.type != ValueType::Map) {
-		return Sound{};
-	}
-	ValueDict map = value.GetDict();
-	Value handleVal = map.Lookup(String("_handle"), Value::zero);
-	Sound* soundPtr = (Sound*)(long)handleVal.IntValue();
+	Sound* soundPtr = LookupHandle(sounds, value, "Sound");
 	if (soundPtr == nullptr) {
 		return Sound{};
 	}
 	return *soundPtr;
 }
 
+void ReleaseSound(Value value) {
+	sounds.Remove(GetHandle(value));
+}
+
 // Convert a Raylib AudioStream to a MiniScript map
 Value AudioStreamToValue(AudioStream stream) {
-	AudioStream* streamPtr = new AudioStream(stream);
 	ValueDict map;
 	map.SetValue(Value::magicIsA, AudioStreamClass());
-	map.SetValue(String("_handle"), Value((long)streamPtr));
+	map.SetValue(handleKey, NewResourceRef(RESOURCE_AUDIO_STREAM, audioStreams.Add(stream), true, 0));
 	map.SetValue(String("sampleRate"), Value((int)stream.sampleRate));
 	map.SetValue(String("sampleSize"), Value((int)stream.sampleSize));
 	map.SetValue(String("channels"), Value((int)stream.channels));
@@ -277,51 +552,84 @@ Value AudioStreamToValue(AudioStream stream) {
 
 // Extract a Raylib AudioStream from a MiniScript map
 AudioStream ValueToAudioStream(Value value) {
-	if (value.type != ValueType::Map) {
-		return AudioStream{};
-	}
-	ValueDict map = value.GetDict();
-	Value handleVal = map.Lookup(String("_handle"), Value::zero);
-	AudioStream* streamPtr = (AudioStream*)(long)handleVal.IntValue();
+	AudioStream* streamPtr = LookupHandle(audioStreams, value, "AudioStream");
 	if (streamPtr == nullptr) {
 		return AudioStream{};
 	}
 	return *streamPtr;
 }
 
+void ReleaseAudioStream(Value value) {
+	audioStreams.Remove(GetHandle(value));
+}
+
 // Convert a Raylib RenderTexture2D to a MiniScript map
-// Allocates the RenderTexture2D on the heap and stores pointer in _handle
 Value RenderTextureToValue(RenderTexture2D renderTexture) {
-	RenderTexture2D* rtPtr = new RenderTexture2D(renderTexture);
+	// (Color buffer, plus a depth buffer of about the same size.)
+	long bytes = TextureBytes(renderTexture.texture) + (long)renderTexture.depth.width * renderTexture.depth.height * 4;
+	Value textureVal = TextureToValue(renderTexture.texture, false);
+	ResourceRef *ref = new ResourceRef(RESOURCE_RENDER_TEXTURE, renderTextures.Add(renderTexture), true, bytes);
+	ref->textureHandle = GetHandle(textureVal);
+
 	ValueDict map;
 	map.SetValue(Value::magicIsA, RenderTextureClass());
-	map.SetValue(String("_handle"), Value((long)rtPtr));
+	map.SetValue(handleKey, Value::NewHandle(ref));
 	map.SetValue(String("id"), Value((int)renderTexture.id));
-	map.SetValue(String("texture"), TextureToValue(renderTexture.texture));
+	map.SetValue(String("texture"), textureVal);
 	return Value(map);
 }
 
 // Extract a Raylib RenderTexture2D from a MiniScript map
-// Returns the RenderTexture2D by dereferencing the _handle pointer
 RenderTexture2D ValueToRenderTexture(Value value) {
-	if (value.type != ValueType::Map) {
-		return RenderTexture2D{};
-	}
-	ValueDict map = value.GetDict();
-	Value handleVal = map.Lookup(String("_handle"), Value::zero);
-	RenderTexture2D* rtPtr = (RenderTexture2D*)(long)handleVal.IntValue();
+	RenderTexture2D* rtPtr = LookupHandle(renderTextures, value, "RenderTexture");
 	if (rtPtr == nullptr) {
 		return RenderTexture2D{};
 	}
 	return *rtPtr;
 }
 
+void ReleaseRenderTexture(Value value) {
+	if (value.type != ValueType::Map) return;
+	// (UnloadRenderTexture unloads its texture too)
+	ReleaseTexture(value.GetDict().Lookup(String("texture"), Value::null));
+	renderTextures.Remove(GetHandle(value));
+}
+
+// Keys of the small maps (colors, vectors, rectangles) we convert all the time
+static const Value rKey("r"), gKey("g"), bKey("b"), aKey("a");
+static const Value xKey("x"), yKey("y"), widthKey("width"), heightKey("height");
+
+static int colorFormat = COLOR_FORMAT_MAP;
+
+Color UnpackColor(unsigned int packed) {
+	return Color{(unsigned char)(packed >> 24), (unsigned char)(packed >> 16),
+		(unsigned char)(packed >> 8), (unsigned char)packed};
+}
+
+unsigned int PackColor(Color color) {
+	return ((unsigned int)color.r << 24) | (color.g << 16) | (color.b << 8) | color.a;
+}
+
+void SetColorFormat(int format) {
+	colorFormat = format;
+}
+
+int GetColorFormat() {
+	return colorFormat;
+}
+
 // Convert a MiniScript map to a Raylib Color
 // Expects a map with "r", "g", "b", and optionally "a" keys (0-255);
-// or, a 3- or 4-element list in the order [r, g, b, a].
+// or, a 3- or 4-element list in the order [r, g, b, a];
+// or, a number packed as 0xRRGGBBAA (as from ColorToInt).
 Color ValueToColor(Value value) {
 	Color result;
 
+	// Handle packed format (negative numbers are from ColorToInt, which is signed)
+	if (value.type == ValueType::Number) {
+		return UnpackColor((unsigned int)(long long)value.DoubleValue());
+	}
+
 	// Handle list format: [r, g, b, a] or [r, g, b]
 	if (value.type == ValueType::List) {
 		ValueList list = value.GetList();
@@ -339,10 +647,10 @@ Color ValueToColor(Value value) {
 	if (value.type == ValueType::Map) {
 		ValueDict map = value.GetDict();
 
-		Value rVal = map.Lookup(String("r"), Value::zero);
-		Value gVal = map.Lookup(String("g"), Value::zero);
-		Value bVal = map.Lookup(String("b"), Value::zero);
-		Value aVal = map.Lookup(String("a"), Value::null);
+		Value rVal = map.Lookup(rKey, Value::zero);
+		Value gVal = map.Lookup(gKey, Value::zero);
+		Value bVal = map.Lookup(bKey, Value::zero);
+		Value aVal = map.Lookup(aKey, Value::null);
 
 		result.r = (unsigned char)(rVal.IntValue());
 		result.g = (unsigned char)(gVal.IntValue());
@@ -356,16 +664,22 @@ Color ValueToColor(Value value) {
 	return WHITE;
 }
 
-// Convert a Raylib Color to a MiniScript map
-Value ColorToValue(Color color) {
+Value ColorToMap(Color color) {
 	ValueDict map;
-	map.SetValue(String("r"), Value((int)color.r));
-	map.SetValue(String("g"), Value((int)color.g));
-	map.SetValue(String("b"), Value((int)color.b));
-	map.SetValue(String("a"), Value((int)color.a));
+	map.SetValue(rKey, Value((int)color.r));
+	map.SetValue(gKey, Value((int)color.g));
+	map.SetValue(bKey, Value((int)color.b));
+	map.SetValue(aKey, Value((int)color.a));
 	return Value(map);
 }
 
+// Convert a Raylib Color to a MiniScript map (or packed number, depending on
+// the color format)
+Value ColorToValue(Color color) {
+	if (colorFormat == COLOR_FORMAT_INT) return Value((double)PackColor(color));
+	return ColorToMap(color);
+}
+
 // Convert a MiniScript value to a Raylib Rectangle
 // Accepts either a map with "x", "y", "width", "height" keys OR a list with 4 elements
 Rectangle ValueToRectangle(Value value) {
@@ -380,10 +694,10 @@ Rectangle ValueToRectangle(Value value) {
 	} else if (value.type == ValueType::Map) {
 		// Map format: {x: ..., y: ..., width: ..., height: ...}
 		ValueDict map = value.GetDict();
-		Value xVal = map.Lookup(String("x"), Value::zero);
-		Value yVal = map.Lookup(String("y"), Value::zero);
-		Value widthVal = map.Lookup(String("width"), Value::zero);
-		Value heightVal = map.Lookup(String("height"), Value::zero);
+		Value xVal = map.Lookup(xKey, Value::zero);
+		Value yVal = map.Lookup(yKey, Value::zero);
+		Value widthVal = map.Lookup(widthKey, Value::zero);
+		Value heightVal = map.Lookup(heightKey, Value::zero);
 
 		Rectangle result;
 		result.x = xVal.FloatValue();
@@ -398,16 +712,41 @@ Rectangle ValueToRectangle(Value value) {
 	}
 }
 
+// Set an element of a list we're reusing, growing the list if needed
+static void SetListItem(ValueList list, long index, double value) {
+	while (list.Count() <= index) list.Add(Value::zero);
+	list[index] = Value(value);
+}
+
 // Convert a Raylib Rectangle to a MiniScript map
 Value RectangleToValue(Rectangle rect) {
 	ValueDict map;
-	map.SetValue(String("x"), Value(rect.x));
-	map.SetValue(String("y"), Value(rect.y));
-	map.SetValue(String("width"), Value(rect.width));
-	map.SetValue(String("height"), Value(rect.height));
+	map.SetValue(xKey, Value(rect.x));
+	map.SetValue(yKey, Value(rect.y));
+	map.SetValue(widthKey, Value(rect.width));
+	map.SetValue(heightKey, Value(rect.height));
 	return Value(map);
 }
 
+Value RectangleToValue(Rectangle rect, Value into) {
+	if (into.type == ValueType::Map) {
+		ValueDict map = into.GetDict();
+		map.SetValue(xKey, Value(rect.x));
+		map.SetValue(yKey, Value(rect.y));
+		map.SetValue(widthKey, Value(rect.width));
+		map.SetValue(heightKey, Value(rect.height));
+		return into;
+	} else if (into.type == ValueType::List) {
+		ValueList list = into.GetList();
+		SetListItem(list, 0, rect.x);
+		SetListItem(list, 1, rect.y);
+		SetListItem(list, 2, rect.width);
+		SetListItem(list, 3, rect.height);
+		return into;
+	}
+	return RectangleToValue(rect);
+}
+
 // Convert a MiniScript value to a Raylib Vector2
 // Accepts either a map with "x", "y" keys OR a list with 2 elements
 Vector2 ValueToVector2(Value value) {
@@ -420,8 +759,8 @@ Vector2 ValueToVector2(Value value) {
 	} else if (value.type == ValueType::Map) {
 		// Map format: {x: ..., y: ...}
 		ValueDict map = value.GetDict();
-		Value xVal = map.Lookup(String("x"), Value::zero);
-		Value yVal = map.Lookup(String("y"), Value::zero);
+		Value xVal = map.Lookup(xKey, Value::zero);
+		Value yVal = map.Lookup(yKey, Value::zero);
 		return Vector2{xVal.FloatValue(), yVal.FloatValue()};
 	} else {
 		// Default to zero vector if not a map or list
@@ -432,7 +771,74 @@ Vector2 ValueToVector2(Value value) {
 // Convert a Raylib Vector2 to a MiniScript map
 Value Vector2ToValue(Vector2 vec) {
 	ValueDict map;
-	map.SetValue(String("x"), Value(vec.x));
-	map.SetValue(String("y"), Value(vec.y));
+	map.SetValue(xKey, Value(vec.x));
+	map.SetValue(yKey, Value(vec.y));
 	return Value(map);
 }
+
+Value Vector2ToValue(Vector2 vec, Value into) {
+	if (into.type == ValueType::Map) {
+		ValueDict map = into.GetDict();
+		map.SetValue(xKey, Value(vec.x));
+		map.SetValue(yKey, Value(vec.y));
+		return into;
+	} else if (into.type == ValueType::List) {
+		ValueList list = into.GetList();
+		SetListItem(list, 0, vec.x);
+		SetListItem(list, 1, vec.y);
+		return into;
+	}
+	return Vector2ToValue(vec);
+}
+
+static_assert(sizeof(Vector2) == 2 * sizeof(float), "Vector2 must be packed float pairs");
+
+PointArray::PointArray(Value value) : data(nullptr), count(0), ownData(nullptr) {
+	if (value.type == ValueType::List) {
+		ValueList list = value.GetList();
+		count = list.Count();
+		if (count == 0) return;
+		ownData = new Vector2[count];
+		for (int i = 0; i < count; i++) ownData[i] = ValueToVector2(list[i]);
+		data = ownData;
+		return;
+	}
+	BinaryData* raw = ValueToRawData(value);
+	if (raw == nullptr || raw->bytes == nullptr) return;
+	count = raw->length / (int)sizeof(Vector2);
+	if (count == 0) return;
+	if (raw->IsNativeOrder()) {
+		// Use the buffer as is (malloc'd, so suitably aligned)
+		data = (Vector2*)raw->bytes;
+	} else {
+		ownData = new Vector2[count];
+		for (int i = 0; i < count; i++) {
+			ownData[i] = Vector2{raw->GetFloat(i * 8), raw->GetFloat(i * 8 + 4)};
+		}
+		data = ownData;
+	}
+}
+
+PointArray::~PointArray() {
+	delete[] ownData;
+}
+
+Value DefaultColorValue(Color color) {
+	static std::map<unsigned int, Value> cache;
+	unsigned int key = PackColor(color);
+	auto it = cache.find(key);
+	if (it != cache.end()) return it->second;
+	Value result = ColorToMap(color);
+	cache[key] = result;
+	return result;
+}
+
+Value DefaultVector2Value(Vector2 vec) {
+	static std::map<std::pair<float, float>, Value> cache;
+	std::pair<float, float> key(vec.x, vec.y);
+	auto it = cache.find(key);
+	if (it != cache.end()) return it->second;
+	Value result = Vector2ToValue(vec);
+	cache[key] = result;
+	return result;
+}
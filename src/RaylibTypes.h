@@ -14,68 +14,123 @@ ValueDict SoundClass();
 ValueDict AudioStreamClass();
 ValueDict RenderTextureClass();
 
+// Resource maps (Texture, Image, Font, etc.) keep the raylib struct in a
+// handle table (see handletable.h), and store its handle in _handle.
+// ValueToX raises a runtime error if the handle is stale (the resource has
+// been unloaded); ReleaseX removes the table entry, and should be called
+// when the resource is unloaded.
+
+// Resources are unloaded automatically when the script no longer has any
+// reference to their map, unless they're "borrowed" (owned by raylib, like
+// the default font), or the script unloaded them already.  This waits until
+// UnloadDroppedResources, which is called when no frame is being drawn:
+// raylib may still have a dropped texture's quads in its render batch.
+void UnloadDroppedResources();
+
 // Convert a Raylib Texture to a MiniScript map
-// Allocates the Texture on the heap and stores pointer in _handle
-Value TextureToValue(Texture texture);
+Value TextureToValue(Texture texture, bool owned = true);
 
 // Extract a Raylib Texture from a MiniScript map
-// Returns the Texture by dereferencing the _handle pointer
 Texture ValueToTexture(Value value);
+void ReleaseTexture(Value value);
 
 // Convert a Raylib Image to a MiniScript map
-// Allocates the Image on the heap and stores pointer in _handle
-Value ImageToValue(Image image);
+Value ImageToValue(Image image, bool owned = true);
 
 // Extract a Raylib Image from a MiniScript map
-// Returns the Image by dereferencing the _handle pointer
 Image ValueToImage(Value value);
+void ReleaseImage(Value value);
+
+// Get a pointer to the Image of a MiniScript map, for functions that modify
+// it in place; nullptr if the map has no handle
+Image* ValueToImagePtr(Value value);
 
 // Convert a Raylib Font to a MiniScript map
-Value FontToValue(Font font);
+Value FontToValue(Font font, bool owned = true);
 
 // Extract a Raylib Font from a MiniScript map
 Font ValueToFont(Value value);
+void ReleaseFont(Value value);
 
 // Convert a Raylib Wave to a MiniScript map
 Value WaveToValue(Wave wave);
 
 // Extract a Raylib Wave from a MiniScript map
 Wave ValueToWave(Value value);
+void ReleaseWave(Value value);
 
-// Convert a Raylib Music to a MiniScript map
-Value MusicToValue(Music music);
+// Convert a Raylib Music to a MiniScript map.  If the music streams from a
+// pinned preloaded file (see loadfile.h), give its path, and the file is
+// unpinned when the music is unloaded.
+Value MusicToValue(Music music, const char *pinnedFile = nullptr);
 
 // Extract a Raylib Music from a MiniScript map
 Music ValueToMusic(Value value);
+void ReleaseMusic(Value value);
 
-// Convert a Raylib Sound to a MiniScript map
-Value SoundToValue(Sound sound);
+// Convert a Raylib Sound (or sound alias) to a MiniScript map
+Value SoundToValue(Sound sound, bool isAlias = false);
 
 // Extract a Raylib Sound from a MiniScript map
 Sound ValueToSound(Value value);
+void ReleaseSound(Value value);
 
 // Convert a Raylib AudioStream to a MiniScript map
 Value AudioStreamToValue(AudioStream stream);
 
 // Extract a Raylib AudioStream from a MiniScript map
 AudioStream ValueToAudioStream(Value value);
+void ReleaseAudioStream(Value value);
 
 // Convert a Raylib RenderTexture2D to a MiniScript map
-// Allocates the RenderTexture2D on the heap and stores pointer in _handle
 Value RenderTextureToValue(RenderTexture2D renderTexture);
 
 // Extract a Raylib RenderTexture2D from a MiniScript map
-// Returns the RenderTexture2D by dereferencing the _handle pointer
 RenderTexture2D ValueToRenderTexture(Value value);
+void ReleaseRenderTexture(Value value);
+
+// Set the VM whose current script line is recorded as each resource's
+// creation site
+void SetResourceSiteVM(Machine* vm);
+
+// Turn recording of creation sites on or off (it's off by default, since
+// getting the script's call stack on every load takes time)
+void SetResourceTracking(bool enabled);
+bool IsResourceTracking();
+
+// List the loaded resources, grouped by type and creation site: a list of
+// maps with type, site, count and bytes, biggest first
+ValueList GetResourceReport();
+
+// Get the number of loaded resources (of all types), and their approximate size
+void GetResourceTotals(long *count, long *bytes);
 
 // Convert a MiniScript map to a Raylib Color
 // Expects a map with "r", "g", "b", and optionally "a" keys (0-255);
-// or, a 3- or 4-element list in the order [r, g, b, a].
+// or, a 3- or 4-element list in the order [r, g, b, a];
+// or, a number packed as 0xRRGGBBAA (as from ColorToInt).
 Color ValueToColor(Value value);
 
-// Convert a Raylib Color to a MiniScript map
+// Formats in which colors are returned to scripts (see SetColorFormat)
+enum ColorFormat {
+	COLOR_FORMAT_MAP = 0,		// {"r": r, "g": g, "b": b, "a": a}
+	COLOR_FORMAT_INT = 1		// a number, 0xRRGGBBAA
+};
+
+void SetColorFormat(int format);
+int GetColorFormat();
+
+// Convert a packed 0xRRGGBBAA color to a Raylib Color, and back
+Color UnpackColor(unsigned int packed);
+unsigned int PackColor(Color color);
+
+// Convert a Raylib Color to a MiniScript map (or packed number, depending on
+// the color format)
 Value ColorToValue(Color color);
 
+// Convert a Raylib Color to a MiniScript map, whatever the color format
+Value ColorToMap(Color color);
+
 // Convert a MiniScript value to a Raylib Rectangle
 // Accepts either a map with "x", "y", "width", "height" keys OR a list with 4 elements
 Rectangle ValueToRectangle(Value value);
@@ -83,9 +138,43 @@ Rectangle ValueToRectangle(Value value);
 // Convert a Raylib Rectangle to a MiniScript map
 Value RectangleToValue(Rectangle rect);
 
+// Store a Rectangle in an existing map or list (as passed in a function's
+// `into` parameter), and return that; or if `into` is neither, make a new map.
+// This lets scripts reuse one map for a result they get every frame.
+Value RectangleToValue(Rectangle rect, Value into);
+
 // Convert a MiniScript value to a Raylib Vector2
 // Accepts either a map with "x", "y" keys OR a list with 2 elements
 Vector2 ValueToVector2(Value value);
 
 // Convert a Raylib Vector2 to a MiniScript map
-Value Vector2ToValue(Vector2 vec);
\ No newline at end of file
+Value Vector2ToValue(Vector2 vec);
+
+// Store a Vector2 in an existing map or list, as with RectangleToValue above
+Value Vector2ToValue(Vector2 vec, Value into);
+
+// The points passed to a polyline/polygon function: either a list of Vector2
+// values, which are converted into a temporary array, or a RawData of packed
+// float pairs (x, y), which is used in place, without copying (unless its
+// byte order isn't the native one).
+class PointArray {
+public:
+	PointArray(Value value);
+	~PointArray();
+
+	Vector2* data;
+	int count;
+
+private:
+	Vector2* ownData;	// array we allocated, if any
+
+	PointArray(const PointArray&) = delete;
+	PointArray& operator=(const PointArray&) = delete;
+};
+
+// Get a shared Color or Vector2 map for use as an intrinsic's parameter
+// default.  Each distinct value is built only once, however many intrinsics
+// use it.  (Intrinsics only read their parameters, so sharing is safe; but
+// scripts can change maps they hold, so don't hand these to scripts.)
+Value DefaultColorValue(Color color);
+Value DefaultVector2Value(Vector2 vec);
\ No newline at end of file
@@ -0,0 +1,125 @@
+//
+// asyncload.cpp
+// MSRLWeb
+//
+// Non-blocking asset loading.
+//
+// The synchronous loaders (LoadTexture etc.) fetch their file first, using
+// WaitForFile, and the script waits until it arrives, so a LoadTexture in
+// the middle of a level stalls the game.  The Load*Async intrinsics (defined
+// with their synchronous counterparts) instead start a background fetch and
+// return a handle at once; the script can poll it with IsAsyncLoadReady, and
+// collect the object with GetAsyncLoadResult, which waits (like import) if
+// it isn't there yet.
+//
+
+#include "asyncload.h"
+#include "loadfile.h"
+#include "RaylibIntrinsics.h"
+#include "MiniscriptInterpreter.h"
+#include "macros.h"
+#include <stdio.h>
+#include <map>
+
+using namespace MiniScript;
+
+struct AsyncLoad {
+	String fileName;
+	long fetchId;
+	AsyncLoadDecoder decode;
+};
+
+static std::map<long, AsyncLoad> asyncLoads;
+static long nextAsyncHandle = 1;
+
+long StartAsyncLoad(const char *fileName, AsyncLoadDecoder decode) {
+	long handle = nextAsyncHandle++;
+	AsyncLoad& load = asyncLoads[handle];
+	load.fileName = fileName;
+	load.fetchId = StartFetch(fileName);
+	load.decode = decode;
+	return handle;
+}
+
+bool WaitForFile(String path, IntrinsicResult& partialResult) {
+#ifdef PLATFORM_WEB
+	long fetchId;
+	if (partialResult.Done()) {
+		// First call: use the preloaded copy if there is one, else start fetching
+		if (CheckFileCache(path.c_str())) return true;
+		fetchId = StartFetch(path.c_str());
+	} else {
+		fetchId = (long)partialResult.Result().DoubleValue();
+	}
+	if (!IsFetchDone(fetchId)) {
+		partialResult = IntrinsicResult(Value((double)fetchId), false);
+		return false;
+	}
+	if (GetFetchStatus(fetchId) != 200) {
+		printf("Failed to load %s (status %d)\n", path.c_str(), GetFetchStatus(fetchId));
+	}
+	KeepFetchedFile(path.c_str(), fetchId);
+#endif
+	// (Native builds just let raylib read the file.)
+	return true;
+}
+
+// Look up the load for the given handle value, raising an error if there is none
+static std::map<long, AsyncLoad>::iterator FindAsyncLoad(Value handleVal, const char *funcName) {
+	auto it = asyncLoads.find((long)handleVal.DoubleValue());
+	if (it == asyncLoads.end()) {
+		RuntimeException(String(funcName) + ": invalid or finished async load handle").raise();
+	}
+	return it;
+}
+
+void AddAsyncLoadMethods(ValueDict raylibModule) {
+	Intrinsic *i;
+
+	i = Intrinsic::Create("");
+	i->AddParam("handle");
+	i->code = INTRINSIC_LAMBDA {
+		auto it = FindAsyncLoad(ARG("handle"), "IsAsyncLoadReady");
+		return IntrinsicResult(IsFetchDone(it->second.fetchId));
+	};
+	RegisterIntrinsic(raylibModule, "IsAsyncLoadReady", i);
+
+	i = Intrinsic::Create("");
+	i->AddParam("handle");
+	i->code = INTRINSIC_LAMBDA {
+		// On later calls, the handle is carried in our partial result
+		Value handleVal = partialResult.Done() ? ARG("handle") : partialResult.Result();
+		auto it = FindAsyncLoad(handleVal, "GetAsyncLoadResult");
+		if (!IsFetchDone(it->second.fetchId)) {
+			// Still loading
+			return IntrinsicResult(handleVal, false);
+		}
+
+		long fetchId = it->second.fetchId;
+		int size;
+		const unsigned char *data = GetFetchData(fetchId, &size);
+		Value result;
+		if (data) {
+			result = it->second.decode(data, size);
+		} else {
+			printf("GetAsyncLoadResult: failed to load %s (status %d)\n",
+				it->second.fileName.c_str(), GetFetchStatus(fetchId));
+		}
+		CloseFetch(fetchId);
+		asyncLoads.erase(it);
+		return IntrinsicResult(result);
+	};
+	RegisterIntrinsic(raylibModule, "GetAsyncLoadResult", i);
+
+	i = Intrinsic::Create("");
+	i->AddParam("handle");
+	i->code = INTRINSIC_LAMBDA {
+		auto it = asyncLoads.find((long)ARG("handle").DoubleValue());
+		if (it != asyncLoads.end()) {
+			CloseFetch(it->second.fetchId);
+			asyncLoads.erase(it);
+		}
+		return IntrinsicResult::Null;
+	};
+	RegisterIntrinsic(raylibModule, "CancelAsyncLoad", i);
+}
@@ -0,0 +1,33 @@
+//
+// asyncload.h
+// MSRLWeb
+//
+// Non-blocking asset loading: fetch a file in the background, and turn it
+// into a raylib object when the script asks for it
+//
+
+#ifndef ASYNCLOAD_H
+#define ASYNCLOAD_H
+
+#include "MiniscriptTypes.h"
+#include "MiniscriptIntrinsics.h"
+#include <functional>
+
+// Function that builds the finished object (e.g. a Texture map) from the
+// fetched file data, or returns null if the data can't be loaded
+typedef std::function<MiniScript::Value(const unsigned char *data, int size)> AsyncLoadDecoder;
+
+// Start loading the given file; returns a handle for the intrinsics below
+long StartAsyncLoad(const char *fileName, AsyncLoadDecoder decode);
+
+// For the (synchronous) file-loading intrinsics: make sure the given file is
+// preloaded, so raylib can load it without waiting on the network.  Returns
+// true when it's ready (or failed to load, which raylib will then report).
+// Otherwise returns false and updates partialResult, which the intrinsic
+// should return; it will be called again, and should call this again.
+bool WaitForFile(MiniScript::String path, MiniScript::IntrinsicResult& partialResult);
+
+// Add the IsAsyncLoadReady, GetAsyncLoadResult and CancelAsyncLoad intrinsics
+void AddAsyncLoadMethods(MiniScript::ValueDict raylibModule);
+
+#endif // ASYNCLOAD_H
@@ -0,0 +1,138 @@
+//
+// benchmark.cpp
+// MSRLWeb
+//
+// Benchmark mode, for catching performance regressions in CI.
+//
+// The host runs the script as fast as it can (no frame rate limit), and
+// raylib.GetFrameTime returns the fixed timestep, so every run simulates the
+// same frames.  A frame's time is the real time from the end of the one
+// before, so it covers everything the host does for the frame.
+//
+// A frame is one the script drew (ending with EndDrawing), however many main
+// loop iterations that took; anything the script does before its first
+// frame is setup, and isn't counted.
+//
+
+#include "benchmark.h"
+#include "framestats.h"
+#include "trace.h"
+#include "raylib.h"
+#include <stdio.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace MiniScript;
+
+struct BenchmarkFrame {
+	double frameTime;
+	double vmTime;
+	double renderTime;
+};
+
+static bool benchmarking = false;
+static int benchmarkFrames = 0;
+static double benchmarkTimestep = 1.0 / 60;
+static std::vector<BenchmarkFrame> frames;
+static double startTime = 0;
+static double lastFrameEnd = 0;
+static long intrinsicCalls = 0;
+static long drawCalls = 0;
+static long peakHeapBytes = 0;
+static BenchmarkFrame pending = { 0, 0, 0 };	// (the frame so far, until it's drawn)
+static long pendingCalls = 0;
+static long pendingDrawCalls = 0;
+
+void StartBenchmark(int frameCount, double timestep) {
+	benchmarking = true;
+	benchmarkFrames = frameCount;
+	if (timestep > 0) benchmarkTimestep = timestep;
+	frames.reserve(frameCount);
+}
+
+bool IsBenchmarking() {
+	return benchmarking;
+}
+
+double GetBenchmarkTimestep() {
+	return benchmarkTimestep;
+}
+
+bool BenchmarkEndFrame(bool drewFrame) {
+	const FrameStats& stats = GetFrameStats();
+	if (frames.empty() && !drewFrame) return false;		// (still setting up)
+	pending.vmTime += stats.vmTime;
+	pending.renderTime += stats.renderTime;
+	pendingCalls += stats.intrinsicCalls;
+	pendingDrawCalls += stats.drawCalls;
+	peakHeapBytes = std::max(peakHeapBytes, HeapBytesInUse());
+	if (!drewFrame) return false;
+
+	double now = GetTime();
+	if (frames.empty()) {
+		// (The first frame has no frame before it; count just its own work.)
+		startTime = lastFrameEnd = now - pending.vmTime - pending.renderTime;
+	}
+	pending.frameTime = now - lastFrameEnd;
+	frames.push_back(pending);
+	lastFrameEnd = now;
+	intrinsicCalls += pendingCalls;
+	drawCalls += pendingDrawCalls;
+	pending = BenchmarkFrame{ 0, 0, 0 };
+	pendingCalls = pendingDrawCalls = 0;
+	return (int)frames.size() >= benchmarkFrames;
+}
+
+// Append a JSON object of the mean, percentiles and maximum of the given
+// times (in milliseconds)
+static void AppendTimeSummary(std::string& out, const char *name, std::vector<double> times) {
+	char buf[256];
+	if (times.empty()) {
+		snprintf(buf, sizeof(buf), "\"%s\":null", name);
+		out += buf;
+		return;
+	}
+	std::sort(times.begin(), times.end());
+	double total = 0;
+	for (double t : times) total += t;
+	auto percentile = [&times](double p) {
+		size_t i = (size_t)(p / 100 * (times.size() - 1) + 0.5);
+		return times[i] * 1000;
+	};
+	snprintf(buf, sizeof(buf),
+		"\"%s\":{\"mean\":%.3f,\"p50\":%.3f,\"p90\":%.3f,\"p95\":%.3f,\"p99\":%.3f,\"max\":%.3f}",
+		name, total / times.size() * 1000, percentile(50), percentile(90), percentile(95),
+		percentile(99), times.back() * 1000);
+	out += buf;
+}
+
+String GetBenchmarkReport(const char *scriptPath, String status) {
+	std::vector<double> frameTimes, vmTimes, renderTimes;
+	for (const BenchmarkFrame& frame : frames) {
+		frameTimes.push_back(frame.frameTime);
+		vmTimes.push_back(frame.vmTime);
+		renderTimes.push_back(frame.renderTime);
+	}
+	int count = (int)frames.size();
+	char buf[256];
+
+	std::string out = "{\"script\":";
+	AppendJSONString(out, scriptPath);
+	out += ",\"status\":";
+	AppendJSONString(out, status.c_str());
+	snprintf(buf, sizeof(buf), ",\"frames\":%d,\"timestep\":%g,\"totalTime\":%.3f,",
+		count, benchmarkTimestep, count ? lastFrameEnd - startTime : 0.0);
+	out += buf;
+	AppendTimeSummary(out, "frameTimeMs", frameTimes);
+	out += ',';
+	AppendTimeSummary(out, "vmTimeMs", vmTimes);
+	out += ',';
+	AppendTimeSummary(out, "renderTimeMs", renderTimes);
+	snprintf(buf, sizeof(buf),
+		",\"intrinsicCalls\":%ld,\"intrinsicCallsPerFrame\":%.1f,\"drawCallsPerFrame\":%.1f,\"peakHeapBytes\":%ld}",
+		intrinsicCalls, count ? (double)intrinsicCalls / count : 0.0,
+		count ? (double)drawCalls / count : 0.0, peakHeapBytes);
+	out += buf;
+	return String(out.c_str());
+}
@@ -0,0 +1,29 @@
+//
+// benchmark.h
+// MSRLWeb
+//
+// Benchmark mode: run a script for a fixed number of frames with a fixed
+// timestep, and report frame times, VM time, call counts and memory as JSON
+//
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include "MiniscriptTypes.h"
+
+// Turn on benchmark mode (before the script starts)
+void StartBenchmark(int frames, double timestep);
+
+// Whether we're in benchmark mode, and the frame time scripts see then
+bool IsBenchmarking();
+double GetBenchmarkTimestep();
+
+// Record a main loop iteration that ran the script, and whether the script
+// drew a frame in it; returns true when the benchmark has run all its frames
+bool BenchmarkEndFrame(bool drewFrame);
+
+// Get the results as JSON.  The status is "ok" if all frames were run, or
+// else why not (e.g. "error: ..." if the script stopped with an error).
+MiniScript::String GetBenchmarkReport(const char *scriptPath, MiniScript::String status);
+
+#endif // BENCHMARK_H
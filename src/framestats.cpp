@@ -0,0 +1,91 @@
+//
+// framestats.cpp
+// MSRLWeb
+//
+// Per-frame counters, for raylib.GetFrameStats.
+//
+// raylib collects everything drawn into a render batch, and draws the batch
+// (one GPU draw call per change of texture or primitive type) at EndDrawing
+// and whenever the drawing mode changes.  rlgl has no way to ask for the
+// active batch, so we install one of our own, and the intrinsics that make
+// raylib draw it call NoteRenderBatch first, to count what's in it.  (Our
+// batch is larger than raylib's default on the web, so that it rarely fills
+// up mid-frame: raylib draws a full batch on its own, and we miss those.)
+//
+// Intrinsic calls are counted by the trampolines RegisterIntrinsic wraps
+// around every raylib intrinsic.
+//
+
+#include "framestats.h"
+#include "raylib.h"
+#include "rlgl.h"
+
+#if defined(PLATFORM_WEB) || defined(__linux__)
+#include <malloc.h>
+#endif
+
+// Size of our render batch, in quads (raylib's desktop default)
+static const int kBatchElements = 8192;
+
+static rlRenderBatch frameBatch;
+static bool haveBatch = false;
+
+static FrameStats current = { 0, 0, 0, 0, 0, 0 };
+static FrameStats last = { 0, 0, 0, 0, 0, 0 };
+static unsigned int lastTextureId = 0;
+
+long intrinsicCallCount = 0;
+
+void InitFrameStats() {
+	frameBatch = rlLoadRenderBatch(1, kBatchElements);
+	rlSetRenderBatchActive(&frameBatch);
+	haveBatch = true;
+}
+
+void CloseFrameStats() {
+	if (!haveBatch) return;
+	rlSetRenderBatchActive(nullptr);	// (draws ours, and goes back to raylib's)
+	rlUnloadRenderBatch(frameBatch);
+	haveBatch = false;
+}
+
+void NoteRenderBatch() {
+	if (!haveBatch) return;
+	for (int i = 0; i < frameBatch.drawCounter; i++) {
+		const rlDrawCall& draw = frameBatch.draws[i];
+		if (draw.vertexCount <= 0) continue;
+		current.drawCalls++;
+		current.vertices += draw.vertexCount;
+		if (draw.textureId != lastTextureId) {
+			current.textureSwitches++;
+			lastTextureId = draw.textureId;
+		}
+	}
+}
+
+void NoteRenderTime(double seconds) {
+	current.renderTime += seconds;
+}
+
+void EndFrameStats(double sliceTime) {
+	current.intrinsicCalls = intrinsicCallCount;
+	current.vmTime = sliceTime - current.renderTime;
+	if (current.vmTime < 0) current.vmTime = 0;
+	last = current;
+	current = FrameStats{ 0, 0, 0, 0, 0, 0 };
+	intrinsicCallCount = 0;
+}
+
+const FrameStats& GetFrameStats() {
+	return last;
+}
+
+long HeapBytesInUse() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+	return (long)mallinfo2().uordblks;
+#elif defined(PLATFORM_WEB) || defined(__linux__)
+	return (long)mallinfo().uordblks;
+#else
+	return 0;
+#endif
+}
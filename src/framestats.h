@@ -0,0 +1,47 @@
+//
+// framestats.h
+// MSRLWeb
+//
+// Per-frame counters: draw calls and vertices from raylib's render batch,
+// and calls and time spent in the bindings
+//
+
+#ifndef FRAMESTATS_H
+#define FRAMESTATS_H
+
+// Counters for one frame (one run of the scheduler)
+struct FrameStats {
+	long drawCalls;				// draw calls sent to the GPU
+	long vertices;				// vertices in those draw calls
+	long textureSwitches;		// draw calls using a different texture from the one before
+	long intrinsicCalls;		// calls to raylib intrinsics
+	double vmTime;				// seconds spent running the script (excluding renderTime)
+	double renderTime;			// seconds spent in EndDrawing (drawing the batch and presenting)
+};
+
+// Install our own render batch, so we can see what is drawn
+// (call after InitWindow; CloseFrameStats before CloseWindow)
+void InitFrameStats();
+void CloseFrameStats();
+
+// Count the draw calls waiting in the render batch; call this just before
+// anything that makes raylib draw it (EndDrawing, BeginMode2D, etc.)
+void NoteRenderBatch();
+
+// Note the time spent presenting a frame (in EndDrawing)
+void NoteRenderTime(double seconds);
+
+// Count a call to an intrinsic
+extern long intrinsicCallCount;
+inline void CountIntrinsicCall() { intrinsicCallCount++; }
+
+// Finish the current frame, given the time the scheduler ran the VM
+void EndFrameStats(double sliceTime);
+
+// Get the counters for the last finished frame
+const FrameStats& GetFrameStats();
+
+// Bytes of heap in use, or 0 if we can't tell on this platform
+long HeapBytesInUse();
+
+#endif // FRAMESTATS_H
@@ -0,0 +1,94 @@
+//
+// handletable.h
+// MSRLWeb
+//
+// Tables of raylib resources (images, textures, sounds, etc.), referred to
+// from MiniScript by generation-tagged handles
+//
+
+#ifndef HANDLETABLE_H
+#define HANDLETABLE_H
+
+#include <deque>
+#include <vector>
+
+// A handle combines a slot in the table with that slot's generation, which
+// changes whenever the slot's item is removed:
+//   handle = generation * kHandleSlotLimit + slot
+// So a handle to a removed item no longer matches its slot, even after the
+// slot is reused.  A resource map holds its handle in a ResourceRef (see
+// RaylibTypes.cpp), stored in the map's _handle as a MiniScript handle
+// value.  0 is never a valid handle.
+typedef long long ResourceHandle;
+static const ResourceHandle kHandleSlotLimit = 1 << 24;
+
+template <typename T>
+class HandleTable {
+public:
+	// Store an item, returning its handle
+	ResourceHandle Add(const T& item) {
+		int slot;
+		if (!freeSlots.empty()) {
+			slot = freeSlots.back();
+			freeSlots.pop_back();
+			items[slot] = item;
+		} else {
+			slot = (int)items.size();
+			items.push_back(item);
+			generations.push_back(1);
+			live.push_back(false);
+		}
+		live[slot] = true;
+		liveCount++;
+		return generations[slot] * kHandleSlotLimit + slot;
+	}
+
+	// Get the item for the given handle, or nullptr if the handle is not valid
+	// (e.g. its item has been removed).  The pointer stays good until then:
+	// items are kept in a deque, which never moves them as it grows.
+	T* Get(ResourceHandle handle) {
+		int slot = SlotFor(handle);
+		return slot < 0 ? nullptr : &items[slot];
+	}
+
+	// Remove the item for the given handle; returns false if it wasn't valid
+	bool Remove(ResourceHandle handle) {
+		int slot = SlotFor(handle);
+		if (slot < 0) return false;
+		items[slot] = T{};
+		live[slot] = false;
+		generations[slot]++;
+		freeSlots.push_back(slot);
+		liveCount--;
+		return true;
+	}
+
+	// Number of items currently stored
+	int Count() const { return liveCount; }
+
+	// Call f(handle, item) for each item currently stored, in slot order
+	template <typename F>
+	void ForEach(F f) {
+		for (int slot = 0; slot < (int)items.size(); slot++) {
+			if (live[slot]) f(generations[slot] * kHandleSlotLimit + slot, items[slot]);
+		}
+	}
+
+private:
+	// Get the slot for a handle, or -1 if it doesn't refer to a current item
+	int SlotFor(ResourceHandle handle) const {
+		if (handle <= 0) return -1;
+		int slot = (int)(handle % kHandleSlotLimit);
+		if (slot >= (int)items.size() || !live[slot]) return -1;
+		if (generations[slot] != handle / kHandleSlotLimit) return -1;
+		return slot;
+	}
+
+	std::deque<T> items;						// (contiguous in chunks)
+	std::vector<ResourceHandle> generations;	// current generation of each slot
+	std::vector<bool> live;						// whether each slot holds an item
+	std::vector<int> freeSlots;					// slots available for reuse
+	int liveCount = 0;
+};
+
+#endif // HANDLETABLE_H
@@ -0,0 +1,122 @@
+//
+// hud.cpp
+// MSRLWeb
+//
+// Performance overlay, drawn over the script's frame just before EndDrawing.
+//
+// The graph has a bar for each recent frame, stacked from the bottom: time
+// running the script (green), rendering and presenting in EndDrawing (blue),
+// and the rest of the frame, spent idle or in the browser (gray).  The line
+// across it is the target frame time; bars reaching the top took twice that.
+//
+
+#include "hud.h"
+#include "framestats.h"
+#include "scheduler.h"
+#include "RaylibTypes.h"
+#include "raylib.h"
+
+// Key that shows or hides the overlay
+static const int kToggleKey = KEY_F3;
+
+// Frames in the graph, and its size
+static const int kHistoryFrames = 120;
+static const int kBarWidth = 2;
+static const int kGraphHeight = 60;
+
+static const int kPadding = 6;
+static const int kFontSize = 10;
+static const int kLineHeight = 12;
+static const int kTextLines = 4;
+static const int kPanelWidth = kHistoryFrames * kBarWidth + 2 * kPadding;
+static const int kPanelHeight = kTextLines * kLineHeight + kGraphHeight + 3 * kPadding;
+
+struct HUDFrame {
+	float vmTime;
+	float renderTime;
+	float frameTime;
+};
+
+static bool hudVisible = false;
+static HUDFrame history[kHistoryFrames];
+static int nextFrame = 0;		// where the next frame goes in history
+static int frameCount = 0;
+
+void SetPerfHUDVisible(bool visible) {
+	hudVisible = visible;
+}
+
+bool IsPerfHUDVisible() {
+	return hudVisible;
+}
+
+void NotePerfHUDFrame() {
+	const FrameStats& stats = GetFrameStats();
+	// The scheduler measures a frame's length when the next one starts, so
+	// this is the length of the frame before; until then, assume no idle time.
+	if (frameCount > 0) {
+		int prev = (nextFrame + kHistoryFrames - 1) % kHistoryFrames;
+		history[prev].frameTime = (float)GetSchedulerStats().frameTime;
+	}
+	HUDFrame& frame = history[nextFrame];
+	frame.vmTime = (float)stats.vmTime;
+	frame.renderTime = (float)stats.renderTime;
+	frame.frameTime = (float)(stats.vmTime + stats.renderTime);
+	nextFrame = (nextFrame + 1) % kHistoryFrames;
+	if (frameCount < kHistoryFrames) frameCount++;
+}
+
+static void DrawGraph(int left, int bottom, float targetFrameTime) {
+	float scale = kGraphHeight / (2 * targetFrameTime);	// pixels per second
+	int first = (frameCount < kHistoryFrames) ? 0 : nextFrame;	// (oldest frame)
+	for (int i = 0; i < frameCount; i++) {
+		const HUDFrame& frame = history[(first + i) % kHistoryFrames];
+		int x = left + (kHistoryFrames - frameCount + i) * kBarWidth;
+		float idle = frame.frameTime - frame.vmTime - frame.renderTime;
+		if (idle < 0) idle = 0;
+		float parts[3] = { frame.vmTime, frame.renderTime, idle };
+		Color colors[3] = { LIME, SKYBLUE, GRAY };
+		int y = bottom;
+		for (int p = 0; p < 3 && y > bottom - kGraphHeight; p++) {
+			int height = (int)(parts[p] * scale + 0.5f);
+			if (y - height < bottom - kGraphHeight) height = y - (bottom - kGraphHeight);
+			DrawRectangle(x, y - height, kBarWidth, height, colors[p]);
+			y -= height;
+		}
+	}
+	DrawLine(left, bottom - kGraphHeight / 2, left + kHistoryFrames * kBarWidth,
+		bottom - kGraphHeight / 2, Fade(WHITE, 0.5f));
+}
+
+void DrawPerfHUD() {
+	if (IsKeyPressed(kToggleKey)) hudVisible = !hudVisible;
+	if (!hudVisible) return;
+
+	int left = GetScreenWidth() - kPanelWidth - kPadding;
+	int top = kPadding;
+	DrawRectangle(left, top, kPanelWidth, kPanelHeight, Fade(BLACK, 0.75f));
+
+	const FrameStats& stats = GetFrameStats();
+	const SchedulerStats& sched = GetSchedulerStats();
+	long resourceCount, resourceBytes;
+	GetResourceTotals(&resourceCount, &resourceBytes);
+	double idle = sched.frameTime - stats.vmTime - stats.renderTime;
+	if (idle < 0) idle = 0;
+
+	int x = left + kPadding;
+	int y = top + kPadding;
+	DrawText(TextFormat("%d FPS   frame %.1f ms", GetFPS(), sched.frameTime * 1000),
+		x, y, kFontSize, WHITE);
+	y += kLineHeight;
+	DrawText(TextFormat("script %.1f   render %.1f   idle %.1f ms",
+		stats.vmTime * 1000, stats.renderTime * 1000, idle * 1000), x, y, kFontSize, WHITE);
+	y += kLineHeight;
+	DrawText(TextFormat("%ld draws   %ld verts   %ld calls",
+		stats.drawCalls, stats.vertices, stats.intrinsicCalls), x, y, kFontSize, WHITE);
+	y += kLineHeight;
+	DrawText(TextFormat("heap %.1f MB   %ld resources (%.1f MB)",
+		HeapBytesInUse() / 1048576.0, resourceCount, resourceBytes / 1048576.0), x, y, kFontSize, WHITE);
+	y += kLineHeight + kPadding;
+
+	DrawGraph(x, y + kGraphHeight, (float)sched.targetFrameTime);
+}
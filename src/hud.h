@@ -0,0 +1,24 @@
+//
+// hud.h
+// MSRLWeb
+//
+// Performance overlay: a graph of recent frame times (split into script,
+// rendering and idle time), with draw, memory and resource counts
+//
+
+#ifndef HUD_H
+#define HUD_H
+
+// Show or hide the overlay (it can also be toggled with F3)
+void SetPerfHUDVisible(bool visible);
+bool IsPerfHUDVisible();
+
+// Record the last frame's times for the graph (call once per frame, after
+// EndFrameStats)
+void NotePerfHUDFrame();
+
+// Check the toggle key, and draw the overlay if it's visible; call just
+// before EndDrawing
+void DrawPerfHUD();
+
+#endif // HUD_H
@@ -0,0 +1,248 @@
+//
+// import.cpp
+// MSRLWeb
+//
+// The `import` intrinsic, and concurrent prefetching of imported libraries.
+//
+// Fetching a library only when the VM reaches its `import` call costs one
+// round-trip per library, one after another.  Instead, when a script arrives
+// we scan it for `import "name"` calls and request every library it names
+// right away, from all search paths at once; each library is scanned in turn
+// when it arrives.  The import intrinsic then usually finds its source
+// already here, and otherwise just waits on the request already in flight.
+// When the asset manifest lists a library, we request only the path it gives.
+//
+// Each library is also parsed only once per session: the compiled import
+// function is kept in its entry, and later imports of the same library just
+// run it again.  (We cache the code, not the resulting module map, so every
+// import still gets fresh module state, as in command-line MiniScript.)
+//
+
+#include "import.h"
+#include "loadfile.h"
+#include "MiniscriptInterpreter.h"
+#include "MiniscriptIntrinsics.h"
+#include "MiniscriptParser.h"
+#include <stdio.h>
+#include <string.h>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace MiniScript;
+
+// Search paths for import, in order of preference
+static const char* searchPaths[] = { "assets/", "assets/lib/" };
+static const int searchPathCount = 2;
+
+enum ImportState {
+	IMPORT_PENDING,		// still waiting on one or more fetches
+	IMPORT_FOUND,		// source is available
+	IMPORT_MISSING		// not found on any search path
+};
+
+// One library we have requested
+struct ImportEntry {
+	String libname;
+	long fetchIds[searchPathCount];	// one per search path (0 if closed or skipped)
+	ImportState state;
+	String source;				// (released once compiled)
+	FunctionStorage *code;		// compiled import function, or nullptr
+};
+
+static std::vector<ImportEntry> imports;
+static std::map<std::string, int> importIndex;	// libname -> index in imports
+
+//--------------------------------------------------------------------------------
+// Prefetching
+//--------------------------------------------------------------------------------
+
+// Start fetching the given entry's library.  If the asset manifest tells us
+// where the library is, fetch just that; otherwise, try all search paths at once.
+static void StartEntryFetches(ImportEntry& entry) {
+	int knownPath = -1;
+	for (int i = 0; i < searchPathCount && knownPath < 0; i++) {
+		String path = String(searchPaths[i]) + entry.libname + ".ms";
+		if (GetAssetSize(path.c_str()) >= 0) knownPath = i;
+	}
+	for (int i = 0; i < searchPathCount; i++) {
+		String path = String(searchPaths[i]) + entry.libname + ".ms";
+		if (knownPath < 0 || i == knownPath) entry.fetchIds[i] = StartFetch(path.c_str());
+		else entry.fetchIds[i] = 0;		// (treated as not found)
+	}
+	entry.state = IMPORT_PENDING;
+}
+
+// Find the import entry for the given library, starting its fetches if needed.
+// A library we failed to find before is fetched again, in case that failure
+// was a passing one (like a network error).
+static int RequestImport(String libname) {
+	std::string key(libname.c_str());
+	auto it = importIndex.find(key);
+	if (it != importIndex.end()) {
+		if (imports[it->second].state == IMPORT_MISSING) StartEntryFetches(imports[it->second]);
+		return it->second;
+	}
+
+	ImportEntry entry;
+	entry.libname = libname;
+	entry.code = nullptr;
+	StartEntryFetches(entry);
+	int index = (int)imports.size();
+	imports.push_back(entry);
+	importIndex[key] = index;
+	return index;
+}
+
+static void CloseEntryFetches(ImportEntry& entry) {
+	for (int i = 0; i < searchPathCount; i++) {
+		if (entry.fetchIds[i]) CloseFetch(entry.fetchIds[i]);
+		entry.fetchIds[i] = 0;
+	}
+}
+
+// Resolve a pending entry if we can.  The first search path that has the file
+// wins, so we can't settle on a later path until all earlier ones have failed.
+static void UpdateEntry(int index) {
+	if (imports[index].state != IMPORT_PENDING) return;
+	for (int i = 0; i < searchPathCount; i++) {
+		long fetchId = imports[index].fetchIds[i];
+		if (!IsFetchDone(fetchId)) return;	// must wait for this one
+		int size;
+		const unsigned char* data = GetFetchData(fetchId, &size);
+		if (!data) continue;				// not on this path; try the next
+
+		imports[index].source = String((const char*)data, size);
+		imports[index].state = IMPORT_FOUND;
+		CloseEntryFetches(imports[index]);
+		printf("import: fetched %s from %s\n", imports[index].libname.c_str(), searchPaths[i]);
+
+		// Look for imports of its own (note: this may grow the imports vector)
+		PrefetchImports(imports[index].source);
+		return;
+	}
+	imports[index].state = IMPORT_MISSING;
+	CloseEntryFetches(imports[index]);
+}
+
+static bool IsIdentChar(char c) {
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+		|| c == '_' || (unsigned char)c >= 0x80;
+}
+
+void PrefetchImports(String source) {
+	const char* s = source.c_str();
+	long len = (long)strlen(s);
+	long i = 0;
+	while (i < len) {
+		char c = s[i];
+		if (c == '/' && i+1 < len && s[i+1] == '/') {
+			// comment: skip to end of line
+			while (i < len && s[i] != '\n') i++;
+		} else if (c == '"') {
+			// string literal ("" is an escaped quote)
+			i++;
+			while (i < len) {
+				if (s[i] == '"') {
+					if (i+1 < len && s[i+1] == '"') i += 2;
+					else break;
+				} else i++;
+			}
+			i++;
+		} else if (IsIdentChar(c)) {
+			long start = i;
+			while (i < len && IsIdentChar(s[i])) i++;
+			if (i - start != 6 || strncmp(s + start, "import", 6) != 0) continue;
+			if (start > 0 && s[start-1] == '.') continue;	// e.g. foo.import
+			// Found `import`; look for a literal argument, with or without parens
+			long j = i;
+			while (j < len && (s[j] == ' ' || s[j] == '\t')) j++;
+			if (j < len && s[j] == '(') {
+				j++;
+				while (j < len && (s[j] == ' ' || s[j] == '\t')) j++;
+			}
+			if (j >= len || s[j] != '"') continue;
+			long nameStart = ++j;
+			while (j < len && s[j] != '"' && s[j] != '\n' && s[j] != '/') j++;
+			if (j >= len || s[j] != '"' || j == nameStart) continue;
+			int index = RequestImport(String(s + nameStart, j - nameStart));
+			UpdateEntry(index);
+			i = j + 1;
+		} else {
+			i++;
+		}
+	}
+}
+
+void UpdateImportPrefetch() {
+	// (Index loop, since resolving an entry may add more entries.)
+	for (int i = 0; i < (int)imports.size(); i++) UpdateEntry(i);
+}
+
+//--------------------------------------------------------------------------------
+// Import intrinsic
+//--------------------------------------------------------------------------------
+
+static IntrinsicResult intrinsic_import(Context *context, IntrinsicResult partialResult) {
+	// State 3: Import function has finished, store result in parent context
+	if (!partialResult.Done() && partialResult.Result().type == ValueType::String) {
+		// The import function has finished, and stored its result in Temp 0.
+		Value importedValues = context->GetTemp(0);
+		// Store these imported values in the parent context under the library name
+		String libname = partialResult.Result().ToString();
+		Context *callerContext = context->parent;
+		if (callerContext) {
+			callerContext->SetVar(libname, importedValues);
+		}
+		return IntrinsicResult::Null;
+	}
+
+	int index;
+	if (!partialResult.Done() && partialResult.Result().type == ValueType::Number) {
+		// State 2: waiting for the library source to arrive
+		index = (int)partialResult.Result().DoubleValue();
+		if (index < 0 || index >= (int)imports.size()) {
+			RuntimeException("import: internal error (fetch not found)").raise();
+		}
+	} else {
+		// State 1: Start the import (unless it was already prefetched)
+		String libname = context->GetVar("libname").ToString();
+		if (libname.empty()) {
+			RuntimeException("import: libname required").raise();
+		}
+		if (libname.IndexOfB('/') >= 0) {
+			RuntimeException("import: argument must be library name, not path").raise();
+		}
+		index = RequestImport(libname);
+	}
+
+	UpdateEntry(index);
+	ImportEntry& entry = imports[index];
+	if (entry.state == IMPORT_PENDING) {
+		// Still loading; return the entry index as partial result (number type)
+		return IntrinsicResult(Value((double)index), false);
+	}
+	if (entry.state == IMPORT_MISSING) {
+		RuntimeException("import: library not found: " + entry.libname).raise();
+	}
+
+	// Parse the code and build a function around it, unless we already have
+	if (!entry.code) {
+		Parser parser;
+		parser.errorContext = entry.libname + ".ms";
+		parser.Parse(entry.source);
+		entry.code = parser.CreateImport();	// (we keep this reference)
+		entry.source = String();
+	}
+	context->vm->ManuallyPushCall(entry.code, Value::Temp(0));
+
+	// Return partial result with the lib name (string type)
+	// We'll get invoked again after the import function finishes
+	return IntrinsicResult(entry.libname, false);
+}
+
+void AddImportIntrinsic() {
+	Intrinsic *importFunc = Intrinsic::Create("import");
+	importFunc->AddParam("libname", "");
+	importFunc->code = &intrinsic_import;
+}
@@ -0,0 +1,24 @@
+//
+// import.h
+// MSRLWeb
+//
+// The `import` intrinsic, and concurrent prefetching of imported libraries
+//
+
+#ifndef IMPORT_H
+#define IMPORT_H
+
+#include "SimpleString.h"
+
+// Add the `import` intrinsic to MiniScript
+void AddImportIntrinsic();
+
+// Scan MiniScript source for `import "name"` calls, and start fetching any
+// libraries we haven't already requested.  Libraries found this way are in
+// turn scanned for their own imports as soon as they arrive.
+void PrefetchImports(MiniScript::String source);
+
+// Check on outstanding prefetches (call once per frame)
+void UpdateImportPrefetch();
+
+#endif // IMPORT_H
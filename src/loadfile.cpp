@@ -2,55 +2,536 @@
 // loadfile.cpp
 // MSRLWeb
 //
-// raylib LoadFileData/LoadFileText hooks
+// raylib LoadFileData/LoadFileText hooks, asynchronous file fetching,
+// preloaded files, and the asset manifest and pack
 //
 
 #include "loadfile.h"
+#include "trace.h"
 #include "raylib.h"
-#include <emscripten.h>
-#include <emscripten/fetch.h>
 #include <cstring>
 #include <stdio.h>
+#include <stdlib.h>
+#include <list>
+#include <map>
+#include <string>
 
-EM_ASYNC_JS(unsigned char*, fetchData, (const char *_url, int *_size), {
-	const url = UTF8ToString(_url);
-	Module.print(`LoadFileData: Fetching ${url} as data...`);
-	return await fetch(url).then(async (response)=>{
-		if (response.status!==200) {
-			Module.print(`LoadFileData: Failed loading ${url} (${response.status} ${response.statusText})`);
-			return 0; // nullptr
-		}
-		const buffer = await response.arrayBuffer();
-		let size = buffer.byteLength;
-		Module.print(`LoadFileData: Successfully loaded ${size} byte(s)`);
-		// set the size variable
-		(new Int32Array(HEAP8.buffer, _size))[0] = size;
-		// allocate a buffer and copy the response into it
-		let ptr = Module._malloc(size);
-		(new Uint8Array(HEAP8.buffer, ptr, size)).set(new Uint8Array(buffer, 0, size));
-		return ptr;
-	});
-});
+#ifdef PLATFORM_WEB
+#include <emscripten.h>
 
-EM_ASYNC_JS(char*, fetchText, (const char *_url), {
+// Start fetching a URL in the background.  When it finishes, we fill in
+// state: [0] = 1 (done), [1] = HTTP status, [2] = malloc'd data, [3] = size.
+// If the C side abandons the fetch first, it sets state[0] to 2, and we free
+// the data and the state block when the fetch finishes.
+// If we know the size from the manifest, we stream the response straight
+// into a buffer of that size, rather than buffering it all in JavaScript and
+// then copying it.  (If the manifest turns out to be stale, we grow it.)
+EM_JS(void, js_fetch, (const char *_url, int expectedSize, int *state), {
 	const url = UTF8ToString(_url);
-	Module.print(`LoadFileText: Fetching ${url} as text...`);
-	return await fetch(url).then(async (response)=>{
-		if (response.status!==200) {
-			Module.print(`LoadFileText: Failed loading ${url} (${response.status} ${response.statusText})`);
-			return 0; // nullptr
+	const finish = (status, ptr, size) => {
+		const i = state >> 2;
+		if (HEAP32[i] === 2) {
+			if (ptr) Module._free(ptr);
+			Module._free(state);
+			return;
+		}
+		HEAP32[i+1] = status;
+		HEAP32[i+2] = ptr;
+		HEAP32[i+3] = size;
+		HEAP32[i] = 1;
+	};
+	(async () => {
+		let ptr = 0;
+		let size = 0;
+		try {
+			const response = await fetch(url);
+			if (response.status !== 200) {
+				finish(response.status, 0, 0);
+				return;
+			}
+			if (expectedSize > 0 && response.body) {
+				let capacity = expectedSize;
+				ptr = Module._malloc(capacity);
+				const reader = response.body.getReader();
+				for (;;) {
+					const {done, value} = await reader.read();
+					if (done) break;
+					if (size + value.length > capacity) {
+						capacity = Math.max(capacity * 2, size + value.length);
+						const grown = Module._malloc(capacity);
+						HEAPU8.copyWithin(grown, ptr, ptr + size);
+						Module._free(ptr);
+						ptr = grown;
+					}
+					HEAPU8.set(value, ptr + size);
+					size += value.length;
+				}
+			} else {
+				const buffer = await response.arrayBuffer();
+				size = buffer.byteLength;
+				ptr = Module._malloc(Math.max(size, 1));
+				HEAPU8.set(new Uint8Array(buffer), ptr);
+			}
+			finish(200, ptr, size);
+		} catch (err) {
+			Module.print(`Failed to fetch ${url}: ${err}`);
+			if (ptr) Module._free(ptr);
+			finish(0, 0, 0);
 		}
-		const text = await response.text();
-		let size = lengthBytesUTF8(text)+1; // null terminator
-		Module.print(`LoadFileText: Successfully loaded ${text.length} character(s) (${size} byte(s))`);
-		// allocate a buffer and copy the response into it
-		let ptr = Module._malloc(size);
-		stringToUTF8(text, ptr, size);
-		return ptr;
-	});
+	})();
 });
 
+// Without Asyncify we can't wait for the network inside raylib's loaders,
+// so these hooks only serve preloaded files: those in the asset pack, or
+// fetched ahead of time by the file-loading intrinsics (see WaitForFile).
+// They return copies, since raylib frees what these return.
+static unsigned char *LoadFileDataHook(const char *fileName, int *dataSize) {
+	int size;
+	const unsigned char *preloaded = GetPreloadedFile(fileName, &size);
+	if (!preloaded) {
+		printf("LoadFileData: %s has not been loaded\n", fileName);
+		*dataSize = 0;
+		return nullptr;
+	}
+	unsigned char *data = (unsigned char*)malloc(size > 0 ? size : 1);
+	if (data) memcpy(data, preloaded, size);
+	*dataSize = data ? size : 0;
+	return data;
+}
+
+static char *LoadFileTextHook(const char *fileName) {
+	int size;
+	const unsigned char *preloaded = GetPreloadedFile(fileName, &size);
+	if (!preloaded) {
+		printf("LoadFileText: %s has not been loaded\n", fileName);
+		return nullptr;
+	}
+	char *text = (char*)malloc(size + 1);
+	if (text) {
+		memcpy(text, preloaded, size);
+		text[size] = '\0';
+	}
+	return text;
+}
+
 void InstallLoadFileHooks() {
-	SetLoadFileDataCallback(fetchData);
-	SetLoadFileTextCallback(fetchText);
+	SetLoadFileDataCallback(LoadFileDataHook);
+	SetLoadFileTextCallback(LoadFileTextHook);
+}
+
+#else
+
+void InstallLoadFileHooks() {
+	// Native build: raylib reads from the local filesystem on its own
+}
+
+#endif // PLATFORM_WEB
+
+//--------------------------------------------------------------------------------
+// Asynchronous fetching
+//--------------------------------------------------------------------------------
+
+struct FetchInfo {
+	bool completed;
+	int status;
+	int size;
+	const unsigned char *packed;	// data in the asset pack, if served from there
+	unsigned char *data;			// malloc'd data, owned by the fetch
+	std::string traceName;			// name of its trace event, if traced
+#ifdef PLATFORM_WEB
+	int *state;						// shared with js_fetch (see above)
+#endif
+};
+
+static std::map<long, FetchInfo> activeFetches;
+static long nextFetchId = 1;
+
+// If the given file is in the asset pack, set up the fetch to be served
+// from there (already complete), and return true.
+static bool ServeFromPack(FetchInfo& info, const char *url) {
+	int size;
+	const unsigned char *packed = GetPackedFile(url, &size);
+	if (!packed) return false;
+	info.completed = true;
+	info.status = 200;
+	info.size = size;
+	info.packed = packed;
+	return true;
+}
+
+long StartFetch(const char *url) {
+	long fetchId = nextFetchId++;
+	FetchInfo& info = activeFetches[fetchId];
+	info.completed = false;
+	info.status = 0;
+	info.size = 0;
+	info.packed = nullptr;
+	info.data = nullptr;
+#ifdef PLATFORM_WEB
+	info.state = nullptr;
+	if (ServeFromPack(info, url)) return fetchId;
+
+	info.state = (int*)calloc(4, sizeof(int));
+	js_fetch(url, (int)GetAssetSize(url), info.state);
+	if (tracing) {
+		info.traceName = std::string("fetch ") + url;
+		TraceAsyncBegin(info.traceName.c_str(), "fetch", fetchId, GetTime());
+	}
+#else
+	if (ServeFromPack(info, url)) return fetchId;
+
+	// Native build: just read the file now
+	TraceScope trace("read file", "fetch");
+	info.completed = true;
+	info.status = 404;
+	FILE *f = fopen(url, "rb");
+	if (f == nullptr) return fetchId;
+	fseek(f, 0, SEEK_END);
+	long size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	if (size >= 0) {
+		info.data = (unsigned char*)malloc(size > 0 ? size : 1);
+		if (info.data != nullptr && fread(info.data, 1, size, f) == (size_t)size) {
+			info.status = 200;
+			info.size = (int)size;
+		} else {
+			free(info.data);
+			info.data = nullptr;
+			info.status = 500;
+		}
+	}
+	fclose(f);
+#endif
+	return fetchId;
+}
+
+bool IsFetchDone(long fetchId) {
+	auto it = activeFetches.find(fetchId);
+	if (it == activeFetches.end()) return true;
+	FetchInfo& info = it->second;
+#ifdef PLATFORM_WEB
+	if (!info.completed && info.state[0] == 1) {
+		info.completed = true;
+		info.status = info.state[1];
+		info.data = (unsigned char*)(size_t)info.state[2];
+		info.size = info.state[3];
+		free(info.state);
+		info.state = nullptr;
+		if (!info.traceName.empty()) TraceAsyncEnd(info.traceName.c_str(), "fetch", fetchId, GetTime());
+	}
+#endif
+	return info.completed;
+}
+
+int GetFetchStatus(long fetchId) {
+	auto it = activeFetches.find(fetchId);
+	if (it == activeFetches.end()) return 0;
+	return it->second.status;
+}
+
+const unsigned char *GetFetchData(long fetchId, int *size) {
+	*size = 0;
+	auto it = activeFetches.find(fetchId);
+	if (it == activeFetches.end() || !it->second.completed || it->second.status != 200) return nullptr;
+	*size = it->second.size;
+	if (it->second.packed) return it->second.packed;
+	return it->second.data;
+}
+
+void CloseFetch(long fetchId) {
+	auto it = activeFetches.find(fetchId);
+	if (it == activeFetches.end()) return;
+#ifdef PLATFORM_WEB
+	// An unfinished fetch cleans up after itself when it completes
+	if (it->second.state) {
+		it->second.state[0] = 2;
+		if (!it->second.traceName.empty()) {
+			TraceAsyncEnd(it->second.traceName.c_str(), "fetch", fetchId, GetTime());
+		}
+	}
+#endif
+	free(it->second.data);
+	activeFetches.erase(it);
+}
+
+//--------------------------------------------------------------------------------
+// Preloaded files: those fetched ahead of raylib asking for them.
+//
+// These are kept in an LRU cache with a byte budget, so loading the same
+// asset again (e.g. when a level is restarted) doesn't go back to the
+// network.  Eviction only happens when a new file is added, so a pointer from
+// GetPreloadedFile stays good until the next KeepFetchedFile, unless pinned.
+//--------------------------------------------------------------------------------
+
+struct PreloadedFile {
+	unsigned char *data;
+	int size;
+	int pins;			// PinPreloadedFile calls not yet undone
+	std::list<std::string>::iterator lruPos;
+};
+
+static std::map<std::string, PreloadedFile> preloadedFiles;
+static std::list<std::string> lruOrder;		// most recently used first
+static FileCacheStats cacheStats = { 0, 0, 0, 0, 0, 0, 16 * 1024 * 1024 };
+
+static void RemovePreloadedFile(std::map<std::string, PreloadedFile>::iterator it) {
+	if (!it->second.pins) cacheStats.bytes -= it->second.size;
+	cacheStats.files--;
+	free(it->second.data);
+	lruOrder.erase(it->second.lruPos);
+	preloadedFiles.erase(it);
+}
+
+// Evict least recently used files until we're within budget, sparing the
+// given one (which is about to be used)
+static void TrimFileCache(const std::string& keep) {
+	auto pos = lruOrder.end();
+	while (cacheStats.bytes > cacheStats.budget && pos != lruOrder.begin()) {
+		--pos;
+		auto it = preloadedFiles.find(*pos);
+		if (*pos == keep || it->second.pins) continue;
+		++pos;	// (step off the entry we're about to erase)
+		RemovePreloadedFile(it);
+		cacheStats.evictions++;
+	}
+}
+
+void KeepFetchedFile(const char *path, long fetchId) {
+	auto it = activeFetches.find(fetchId);
+	if (it == activeFetches.end()) return;
+	FetchInfo& info = it->second;
+	if (info.completed && info.status == 200 && info.data) {
+		if (path[0] == '.' && path[1] == '/') path += 2;
+		std::string key(path);
+		auto old = preloadedFiles.find(key);
+		if (old != preloadedFiles.end() && old->second.pins) {
+			// Still in use; keep the copy we have
+			CloseFetch(fetchId);
+			return;
+		}
+		if (old != preloadedFiles.end()) RemovePreloadedFile(old);
+		lruOrder.push_front(key);
+		PreloadedFile& file = preloadedFiles[key];
+		file.data = info.data;
+		file.size = info.size;
+		file.pins = 0;
+		file.lruPos = lruOrder.begin();
+		info.data = nullptr;	// (now owned by preloadedFiles)
+		cacheStats.bytes += file.size;
+		cacheStats.files++;
+		TrimFileCache(key);
+	}
+	CloseFetch(fetchId);
+}
+
+const unsigned char *GetPreloadedFile(const char *path, int *size) {
+	const unsigned char *packed = GetPackedFile(path, size);
+	if (packed) return packed;
+	if (path[0] == '.' && path[1] == '/') path += 2;
+	auto it = preloadedFiles.find(path);
+	if (it == preloadedFiles.end()) return nullptr;
+	// Move to the front of the LRU order
+	lruOrder.splice(lruOrder.begin(), lruOrder, it->second.lruPos);
+	*size = it->second.size;
+	return it->second.data;
+}
+
+bool PinPreloadedFile(const char *path) {
+	int size;
+	if (GetPackedFile(path, &size)) return false;	// (always in memory anyway)
+	if (path[0] == '.' && path[1] == '/') path += 2;
+	auto it = preloadedFiles.find(path);
+	if (it == preloadedFiles.end()) return false;
+	if (it->second.pins++ == 0) {
+		cacheStats.bytes -= it->second.size;	// (no longer counts against the budget)
+	}
+	return true;
+}
+
+void UnpinPreloadedFile(const char *path) {
+	if (path[0] == '.' && path[1] == '/') path += 2;
+	auto it = preloadedFiles.find(path);
+	if (it == preloadedFiles.end() || it->second.pins == 0) return;
+	if (--it->second.pins == 0) {
+		cacheStats.bytes += it->second.size;
+		TrimFileCache(std::string());
+	}
+}
+
+bool CheckFileCache(const char *path) {
+	int size;
+	if (GetPackedFile(path, &size)) {
+		cacheStats.packHits++;
+		return true;
+	}
+	bool found = (GetPreloadedFile(path, &size) != nullptr);
+	if (found) cacheStats.hits++;
+	else cacheStats.misses++;
+	return found;
+}
+
+const FileCacheStats& GetFileCacheStats() {
+	return cacheStats;
+}
+
+void SetFileCacheBudget(long bytes) {
+	cacheStats.budget = bytes < 0 ? 0 : bytes;
+	TrimFileCache(std::string());
+}
+
+//--------------------------------------------------------------------------------
+// Asset manifest
+//--------------------------------------------------------------------------------
+
+static long manifestFetchId = 0;
+static bool haveManifest = false;
+static std::map<std::string, long> assetSizes;
+
+void LoadAssetManifest(const char *url) {
+	manifestFetchId = StartFetch(url);
+}
+
+// Parse the manifest: one "path<tab>size" line per asset
+static void ParseManifest(const char *data, int size) {
+	int lineStart = 0;
+	while (lineStart < size) {
+		int lineEnd = lineStart;
+		while (lineEnd < size && data[lineEnd] != '\n') lineEnd++;
+		int tab = lineStart;
+		while (tab < lineEnd && data[tab] != '\t') tab++;
+		if (tab > lineStart && tab < lineEnd) {
+			std::string path(data + lineStart, tab - lineStart);
+			assetSizes[path] = strtol(std::string(data + tab + 1, lineEnd - tab - 1).c_str(), nullptr, 10);
+		}
+		lineStart = lineEnd + 1;
+	}
+}
+
+bool IsAssetManifestReady() {
+	if (!manifestFetchId) return true;
+	if (!IsFetchDone(manifestFetchId)) return false;
+	int size;
+	const unsigned char *data = GetFetchData(manifestFetchId, &size);
+	if (data) {
+		ParseManifest((const char*)data, size);
+		haveManifest = true;
+		printf("Asset manifest loaded: %d file(s)\n", (int)assetSizes.size());
+	} else {
+		printf("No asset manifest; asset locations will be probed\n");
+	}
+	CloseFetch(manifestFetchId);
+	manifestFetchId = 0;
+	return true;
+}
+
+long GetAssetSize(const char *path) {
+	if (!haveManifest) return -1;
+	if (path[0] == '.' && path[1] == '/') path += 2;
+	auto it = assetSizes.find(path);
+	if (it == assetSizes.end()) return -1;
+	return it->second;
+}
+
+//--------------------------------------------------------------------------------
+// Asset pack
+//
+// Format (all integers little-endian uint32 unless noted):
+//	"MSPK", version (1), entry count
+//	per entry: path length (uint16), path bytes, flags, offset, stored size, size
+//	then the file data, at the given offsets from the start of the pack.
+// Flag bit 0 means the data is raw-deflate compressed; such entries are
+// inflated the first time they are asked for, and kept.
+//--------------------------------------------------------------------------------
+
+struct PackEntry {
+	int flags;
+	int offset;
+	int storedSize;
+	int size;
+	unsigned char *inflated;	// decompressed data (for compressed entries)
+};
+
+static const int kPackCompressed = 1;
+
+static long packFetchId = 0;
+static const unsigned char *packData = nullptr;
+static std::map<std::string, PackEntry> packEntries;
+
+void LoadAssetPack(const char *url) {
+	packFetchId = StartFetch(url);
+}
+
+static unsigned long ReadU32(const unsigned char *p) {
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned long)p[3] << 24);
+}
+
+// Read the pack index; returns false if the pack is malformed
+static bool ParsePack(const unsigned char *data, int size) {
+	if (size < 12 || memcmp(data, "MSPK", 4) != 0 || ReadU32(data + 4) != 1) return false;
+	unsigned long count = ReadU32(data + 8);
+	int pos = 12;
+	for (unsigned long i = 0; i < count; i++) {
+		if (pos + 2 > size) return false;
+		int pathLen = data[pos] | (data[pos+1] << 8);
+		pos += 2;
+		if (pos + pathLen + 16 > size) return false;
+		std::string path((const char*)data + pos, pathLen);
+		pos += pathLen;
+		PackEntry entry;
+		entry.flags = (int)ReadU32(data + pos);
+		entry.offset = (int)ReadU32(data + pos + 4);
+		entry.storedSize = (int)ReadU32(data + pos + 8);
+		entry.size = (int)ReadU32(data + pos + 12);
+		entry.inflated = nullptr;
+		pos += 16;
+		// (Checked without adding, so a huge offset or size can't overflow past the end.)
+		if (entry.offset < 0 || entry.offset > size) return false;
+		if (entry.storedSize < 0 || entry.storedSize > size - entry.offset) return false;
+		if (!(entry.flags & kPackCompressed) && entry.size != entry.storedSize) return false;
+		packEntries[path] = entry;
+	}
+	return true;
+}
+
+bool IsAssetPackReady() {
+	if (!packFetchId) return true;
+	if (!IsFetchDone(packFetchId)) return false;
+	int size;
+	const unsigned char *data = GetFetchData(packFetchId, &size);
+	if (data && ParsePack(data, size)) {
+		// Keep the fetch open: its buffer is the pack, for the rest of the session
+		packData = data;
+		printf("Asset pack loaded: %d file(s), %d bytes\n", (int)packEntries.size(), size);
+	} else {
+		if (data) printf("Asset pack is invalid; ignoring it\n");
+		packEntries.clear();
+		CloseFetch(packFetchId);
+	}
+	packFetchId = 0;
+	return true;
+}
+
+const unsigned char *GetPackedFile(const char *path, int *size) {
+	*size = 0;
+	if (!packData) return nullptr;
+	if (path[0] == '.' && path[1] == '/') path += 2;
+	auto it = packEntries.find(path);
+	if (it == packEntries.end()) return nullptr;
+	PackEntry& entry = it->second;
+	if (!(entry.flags & kPackCompressed)) {
+		*size = entry.size;
+		return packData + entry.offset;
+	}
+	if (!entry.inflated) {
+		int inflatedSize = 0;
+		entry.inflated = DecompressData(packData + entry.offset, entry.storedSize, &inflatedSize);
+		if (!entry.inflated || inflatedSize != entry.size) {
+			printf("Asset pack: failed to decompress %s\n", path);
+			if (entry.inflated) MemFree(entry.inflated);
+			entry.inflated = nullptr;
+			return nullptr;
+		}
+	}
+	*size = entry.size;
+	return entry.inflated;
 }
@@ -2,13 +2,96 @@
 // loadfile.h
 // MSRLWeb
 //
-// raylib LoadFileData/LoadFileText hooks
+// raylib LoadFileData/LoadFileText hooks, asynchronous file fetching,
+// preloaded files, and the asset manifest and pack
 //
 
 #ifndef LOADFILE_H
 #define LOADFILE_H
 
-// Install LoadFileData/LoadFileText callbacks
+// Install LoadFileData/LoadFileText callbacks.  On the web, these serve only
+// preloaded files (see GetPreloadedFile), since they can't wait for the network.
 void InstallLoadFileHooks();
 
+// Start fetching a file.  On the web this is an HTTP request via
+// the browser's fetch(); in the native build the file is read from the local
+// filesystem right away.  Returns an ID to poll with IsFetchDone.
+long StartFetch(const char *url);
+
+// Check whether a fetch has finished (successfully or not)
+bool IsFetchDone(long fetchId);
+
+// Get the HTTP-style status of a finished fetch (200 = OK)
+int GetFetchStatus(long fetchId);
+
+// Get the data of a finished, successful fetch.  The buffer remains valid
+// until CloseFetch is called.  Returns nullptr if there is no data.
+const unsigned char *GetFetchData(long fetchId, int *size);
+
+// Release a fetch and its data
+void CloseFetch(long fetchId);
+
+// Close a finished fetch, but keep its data (if it succeeded) as the
+// preloaded contents of the given file
+void KeepFetchedFile(const char *path, long fetchId);
+
+// Get the contents of a preloaded file: one in the asset pack, or kept with
+// KeepFetchedFile.  Returns nullptr if the file has not been preloaded.
+// Fetched files live in a cache with a limited budget, so the data is only
+// good until the next KeepFetchedFile, unless the file is pinned.
+const unsigned char *GetPreloadedFile(const char *path, int *size);
+
+// Keep the given preloaded file in memory until it's unpinned (for things
+// like music streams, which read their data as they play).  Returns false,
+// with nothing to unpin, if the file isn't in the cache (files in the asset
+// pack stay in memory anyway).  Pins are counted, so each successful pin
+// needs its own unpin.
+bool PinPreloadedFile(const char *path);
+void UnpinPreloadedFile(const char *path);
+
+// Check whether the given file is preloaded, counting a cache hit or miss
+// (or a pack hit, for a file in the asset pack)
+bool CheckFileCache(const char *path);
+
+// Statistics of the preloaded-file cache
+struct FileCacheStats {
+	long hits;			// loads served from the cache
+	long misses;		// loads that had to be fetched
+	long packHits;		// loads served from the asset pack (not cached)
+	long evictions;		// files dropped to stay within budget
+	long files;			// files currently cached
+	long bytes;			// bytes currently cached (not counting pinned files)
+	long budget;		// maximum bytes to keep
+};
+
+const FileCacheStats& GetFileCacheStats();
+void SetFileCacheBudget(long bytes);
+
+// Start loading the asset manifest (generated at build time by
+// generate_manifest.sh), which lists every asset path and its size.
+// If there is no manifest, everything still works; we just can't skip
+// probing for files or preallocate their buffers.
+void LoadAssetManifest(const char *url);
+
+// Check whether the manifest has finished loading (or failed to).
+bool IsAssetManifestReady();
+
+// Get the size of the given asset (e.g. "assets/lib/json.ms") according
+// to the manifest, or -1 if it is not listed or there is no manifest.
+long GetAssetSize(const char *path);
+
+// Start loading the asset pack (generated at build time by generate_pack.py),
+// which holds all the assets in one file.  Once it's in, files in the pack
+// are served from memory: by StartFetch, and as preloaded files.  As with
+// the manifest, having no pack is fine.
+void LoadAssetPack(const char *url);
+
+// Check whether the asset pack has finished loading (or failed to).
+bool IsAssetPackReady();
+
+// Get the contents of the given file from the asset pack, or nullptr if it
+// is not in the pack.  The data is owned by the pack and stays valid for the
+// rest of the session, so it can be given to raylib's Load*FromMemory.
+const unsigned char *GetPackedFile(const char *path, int *size);
+
 #endif
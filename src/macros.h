@@ -8,5 +8,15 @@
 // Macro to reduce boilerplate for lambda intrinsics
 #define INTRINSIC_LAMBDA [](Context *context, IntrinsicResult partialResult) -> IntrinsicResult
 
+// Get an intrinsic's argument by name (a string literal).  This is what
+// context->GetVar(String(name)) does, but much cheaper, since intrinsics are
+// called so often: the key is made once per call site rather than once per
+// call, and we look it up directly in the call's local variables (where the
+// arguments are), skipping GetVar's checks for `globals`, `outer` etc.
+// (Use GetVar for `self`, which isn't an ordinary local.)
+#define ARG(name) ([context]() -> Value { \
+	static const Value argKey(name); \
+	return context->variables.Lookup(argKey, Value::null); }())
+
 // Raylib version check
 #define RAYLIB_VERSION_GT(maj, min) (RAYLIB_VERSION_MAJOR>maj || RAYLIB_VERSION_MINOR>min)
@@ -7,10 +7,22 @@
 #include "MiniscriptIntrinsics.h"
 #include "MiniscriptParser.h"
 #include "RaylibIntrinsics.h"
+#include "RaylibTypes.h"
 #include "loadfile.h"
-#include <emscripten/emscripten.h>
-#include <emscripten/fetch.h>
+#include "import.h"
+#include "scheduler.h"
+#include "framestats.h"
+#include "profiler.h"
+#include "trace.h"
+#include "hud.h"
+#include "benchmark.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef PLATFORM_WEB
+#include <emscripten/emscripten.h>
+#endif
 
 using namespace MiniScript;
 
@@ -49,21 +61,28 @@ static void PrintErr(String s, bool lineBreak = true) {
 }
 
 //--------------------------------------------------------------------------------
-// Script loading via Emscripten fetch
+// Script loading (fetched on the web, local files natively)
 //--------------------------------------------------------------------------------
 
-void onScriptFetched(emscripten_fetch_t *fetch) {
-	if (fetch->status == 200) {
-		printf("Downloaded %llu bytes from URL %s\n", fetch->numBytes, fetch->url);
+static const char* scriptPath = "assets/main.ms";
+static long scriptFetchId = 0;
+
+void onScriptFetched() {
+	int size;
+	const unsigned char* data = GetFetchData(scriptFetchId, &size);
+	if (data) {
+		printf("Downloaded %d bytes from URL %s\n", size, scriptPath);
 
 		// Copy the script source (null-terminate it)
-		char* scriptData = (char*)malloc(fetch->numBytes + 1);
+		char* scriptData = (char*)malloc(size + 1);
 		if (scriptData) {
-			memcpy(scriptData, fetch->data, fetch->numBytes);
-			scriptData[fetch->numBytes] = '\0';
+			memcpy(scriptData, data, size);
+			scriptData[size] = '\0';
 			scriptSource = String(scriptData);
 			free(scriptData);
-			printf("Successfully loaded script from %s\n", fetch->url);
+			printf("Successfully loaded script from %s\n", scriptPath);
+			// Start fetching the libraries it imports, all at once
+			PrefetchImports(scriptSource);
 			// State remains LOADING until RunScript is called
 		} else {
 			loadError = "Memory allocation failed";
@@ -71,179 +90,87 @@ void onScriptFetched(emscripten_fetch_t *fetch) {
 			printf("Failed to allocate memory for script\n");
 		}
 	} else {
-		loadError = String("HTTP error: ") + String::Format(fetch->status);
+		int status = GetFetchStatus(scriptFetchId);
+		loadError = String("HTTP error: ") + String::Format(status);
 		scriptState = ERRORED;
-		printf("Failed to download %s: HTTP %d\n", fetch->url, fetch->status);
+		printf("Failed to download %s: HTTP %d\n", scriptPath, status);
 	}
 
-	emscripten_fetch_close(fetch);
+	CloseFetch(scriptFetchId);
+	scriptFetchId = 0;
 }
 
 void fetchScript(const char *url) {
 	printf("Fetching script from %s...\n", url);
-
-	emscripten_fetch_attr_t attr;
-	emscripten_fetch_attr_init(&attr);
-	strcpy(attr.requestMethod, "GET");
-	attr.attributes = EMSCRIPTEN_FETCH_LOAD_TO_MEMORY;
-	attr.onsuccess = onScriptFetched;
-	attr.onerror = onScriptFetched;  // Same handler checks status
-
-	emscripten_fetch(&attr, url);
+	scriptPath = url;
+	scriptFetchId = StartFetch(url);
 }
 
 //--------------------------------------------------------------------------------
-// Import intrinsic
+// Benchmark mode
 //--------------------------------------------------------------------------------
 
-#include <map>
-
-// Track import fetches
-struct ImportFetchData {
-	emscripten_fetch_t* fetch;
-	bool completed;
-	int status;
-	String libname;
-	int searchPathIndex;  // Which search path we're trying (0 = assets/, 1 = assets/lib/)
-	ImportFetchData() : fetch(nullptr), completed(false), status(0), searchPathIndex(0) {}
-};
-
-static std::map<long, ImportFetchData> activeImportFetches;
-static long nextImportFetchId = 1;
-
-// Callback when import fetch completes
-static void import_fetch_completed(emscripten_fetch_t *fetch) {
-	for (auto& pair : activeImportFetches) {
-		if (pair.second.fetch == fetch) {
-			pair.second.completed = true;
-			pair.second.status = fetch->status;
-			printf("import_fetch_completed: Fetch ID %ld completed with status %d\n", pair.first, fetch->status);
-			break;
-		}
-	}
-}
-
-static IntrinsicResult intrinsic_import(Context *context, IntrinsicResult partialResult) {
-	// State 3: Import function has finished, store result in parent context
-	if (!partialResult.Done() && partialResult.Result().type == ValueType::String) {
-		// The import function has finished, and stored its result in Temp 0.
-		Value importedValues = context->GetTemp(0);
-		// Store these imported values in the parent context under the library name
-		String libname = partialResult.Result().ToString();
-		Context *callerContext = context->parent;
-		if (callerContext) {
-			callerContext->SetVar(libname, importedValues);
-		}
-		return IntrinsicResult::Null;
-	}
-
-	// State 2: File has been fetched, parse and create import
-	if (!partialResult.Done() && partialResult.Result().type == ValueType::Number) {
-		long fetchId = (long)partialResult.Result().DoubleValue();
-		auto it = activeImportFetches.find(fetchId);
-		if (it == activeImportFetches.end()) {
-			RuntimeException("import: internal error (fetch not found)").raise();
-		}
-
-		ImportFetchData& data = it->second;
-
-		if (!data.completed) {
-			// Still loading
-			return partialResult;
-		}
-
-		// Fetch is complete
-		emscripten_fetch_t* fetch = data.fetch;
-		String libname = data.libname;
-
-		if (data.status == 200) {
-			// Success - parse the module source
-			char* moduleData = (char*)malloc(fetch->numBytes + 1);
-			if (!moduleData) {
-				emscripten_fetch_close(fetch);
-				activeImportFetches.erase(it);
-				RuntimeException("import: memory allocation failed").raise();
-			}
-			memcpy(moduleData, fetch->data, fetch->numBytes);
-			moduleData[fetch->numBytes] = '\0';
-			String moduleSource(moduleData);
-			free(moduleData);
-
-			emscripten_fetch_close(fetch);
-			activeImportFetches.erase(it);
-
-			// Parse the code and build a function around it
-			Parser parser;
-			parser.errorContext = libname + ".ms";
-			parser.Parse(moduleSource);
-			FunctionStorage *import = parser.CreateImport();
-			context->vm->ManuallyPushCall(import, Value::Temp(0));
-
-			// Return partial result with the lib name (string type)
-			// We'll get invoked again after the import function finishes
-			return IntrinsicResult(libname, false);
-		} else {
-			// Error loading file - try next search path if available
-			emscripten_fetch_close(fetch);
-			int nextPathIndex = data.searchPathIndex + 1;
-			activeImportFetches.erase(it);
-
-			const char* searchPaths[] = { "assets/", "assets/lib/" };
-			if (nextPathIndex < 2) {
-				// Try the next path
-				String path = String(searchPaths[nextPathIndex]) + libname + ".ms";
-
-				long newFetchId = nextImportFetchId++;
-				ImportFetchData& newData = activeImportFetches[newFetchId];
-				newData.libname = libname;
-				newData.searchPathIndex = nextPathIndex;
-
-				emscripten_fetch_attr_t attr;
-				emscripten_fetch_attr_init(&attr);
-				strcpy(attr.requestMethod, "GET");
-				attr.attributes = EMSCRIPTEN_FETCH_LOAD_TO_MEMORY;
-				attr.onsuccess = import_fetch_completed;
-				attr.onerror = import_fetch_completed;
-
-				newData.fetch = emscripten_fetch(&attr, path.c_str());
-
-				return IntrinsicResult(Value((double)newFetchId), false);
+#ifdef PLATFORM_WEB
+// Get a parameter from the page URL's query string (malloc'd), or nullptr
+EM_JS(char*, js_get_query_param, (const char *_name), {
+	const value = new URLSearchParams(window.location.search).get(UTF8ToString(_name));
+	if (value === null) return 0;
+	const bytes = new TextEncoder().encode(value);
+	const ptr = Module._malloc(bytes.length + 1);
+	HEAPU8.set(bytes, ptr);
+	HEAPU8[ptr + bytes.length] = 0;
+	return ptr;
+});
+
+// Hand the benchmark results to the page (for a test harness to collect)
+EM_JS(void, js_benchmark_done, (const char *_json), {
+	Module.benchmarkResult = JSON.parse(UTF8ToString(_json));
+	if (Module.onBenchmarkDone) Module.onBenchmarkDone(Module.benchmarkResult);
+});
+#endif
+
+// Longest the script may run in one frame in benchmark mode
+static const double kBenchmarkSliceLimit = 1.0;
+
+static bool benchmarkDone = false;
+static bool benchmarkCompleted = false;		// (ran all its frames)
+static const char* benchmarkOutPath = nullptr;	// (native only; else stdout)
+
+// Report the benchmark results, and stop
+static void FinishBenchmark(String status) {
+	if (benchmarkDone) return;
+	benchmarkDone = true;
+	String report = GetBenchmarkReport(scriptPath, status);
+	#ifdef PLATFORM_WEB
+		printf("Benchmark result: %s\n", report.c_str());
+		js_benchmark_done(report.c_str());
+		emscripten_cancel_main_loop();
+	#else
+		if (benchmarkOutPath) {
+			FILE* f = fopen(benchmarkOutPath, "w");
+			if (f) {
+				fprintf(f, "%s\n", report.c_str());
+				fclose(f);
 			} else {
-				// All paths exhausted
-				RuntimeException("import: library not found: " + libname).raise();
+				printf("Couldn't write %s\n", benchmarkOutPath);
 			}
+		} else {
+			printf("%s\n", report.c_str());
 		}
-	}
+	#endif
+}
 
-	// State 1: Start the import - fetch the file
-	String libname = context->GetVar("libname").ToString();
-	if (libname.empty()) {
-		RuntimeException("import: libname required").raise();
-	}
-	if (libname.IndexOfB('/') >= 0) {
-		RuntimeException("import: argument must be library name, not path").raise();
+// Check whether a running benchmark has finished (or the script stopped early)
+static void UpdateBenchmark(bool frameRun) {
+	if (!IsBenchmarking() || benchmarkDone) return;
+	if (frameRun && BenchmarkEndFrame(GetSchedulerStats().drewFrame)) {
+		benchmarkCompleted = true;
+		FinishBenchmark("ok");
+	} else if (scriptState == COMPLETE) {
+		FinishBenchmark("script finished early");
+	} else if (scriptState == ERRORED) {
+		FinishBenchmark("error: " + (loadError.empty() ? runtimeError : loadError));
 	}
-
-	// Try to find the file - start with assets/
-	String path = String("assets/") + libname + ".ms";
-
-	// Start async fetch
-	long fetchId = nextImportFetchId++;
-	ImportFetchData& data = activeImportFetches[fetchId];
-	data.libname = libname;
-	data.searchPathIndex = 0;
-
-	emscripten_fetch_attr_t attr;
-	emscripten_fetch_attr_init(&attr);
-	strcpy(attr.requestMethod, "GET");
-	attr.attributes = EMSCRIPTEN_FETCH_LOAD_TO_MEMORY;
-	attr.onsuccess = import_fetch_completed;
-	attr.onerror = import_fetch_completed;
-
-	data.fetch = emscripten_fetch(&attr, path.c_str());
-
-	// Return the fetch ID as partial result (number type)
-	return IntrinsicResult(Value((double)fetchId), false);
 }
 
 //--------------------------------------------------------------------------------
@@ -264,9 +191,7 @@ void InitMiniScript() {
 	AddRaylibIntrinsics();
 
 	// Add import intrinsic
-	Intrinsic *importFunc = Intrinsic::Create("import");
-	importFunc->AddParam("libname", "");
-	importFunc->code = &intrinsic_import;
+	AddImportIntrinsic();
 
 	printf("MiniScript interpreter initialized with Raylib intrinsics\n");
 }
@@ -284,9 +209,23 @@ void RunScript() {
 	printf("Compiling script...\n");
 	interpreter->Reset(scriptSource);
 	interpreter->Compile();
+	SetResourceSiteVM(interpreter->vm);
+
+	if (IsBenchmarking()) {
+		// Run frames back to back, rather than at the display's rate, and let
+		// each one run until the script yields (the limit is only there so a
+		// script that never yields can't hang the page)
+		#ifdef PLATFORM_WEB
+			emscripten_set_main_loop_timing(EM_TIMING_SETIMMEDIATE, 0);
+		#else
+			SetTargetFPS(0);
+		#endif
+		SchedulerSetFixedSlice(kBenchmarkSliceLimit);
+	}
 
 	printf("Starting script execution...\n");
 	scriptState = RUNNING;
+	GetStartupStats().scriptStartTime = GetTime();
 
 	// Don't run the script here - let the main loop handle incremental execution
 }
@@ -295,18 +234,47 @@ void RunScript() {
 // Main loop
 //--------------------------------------------------------------------------------
 
+// Print how long it took to get the script's first frame on screen (once)
+static void ReportStartup() {
+	static bool reported = false;
+	const StartupStats& stats = GetStartupStats();
+	if (reported || stats.firstFrameTime == 0) return;
+	printf("Startup: first frame at %.1f ms (script started at %.1f ms; raylib module: %d entries, built in %.1f ms)\n",
+		stats.firstFrameTime * 1000, stats.scriptStartTime * 1000,
+		stats.moduleEntries, stats.moduleBuildTime * 1000);
+	reported = true;
+}
+
 void MainLoop() {
+	// Check whether the main script has arrived
+	// (We wait for the asset manifest and pack too, so imports can use them.)
+	if (scriptFetchId && IsFetchDone(scriptFetchId) && IsAssetManifestReady() && IsAssetPackReady()) {
+		onScriptFetched();
+	}
+	UpdateImportPrefetch();
+
+	// While we wait, get the raylib module ready, a piece at a time
+	if (scriptState == LOADING) BuildRaylibModuleStep();
+
 	// Start the script when it's loaded but not yet started
 	if (scriptState == LOADING && !scriptSource.empty()) {
 		RunScript();
 	}
 
+	bool frameRun = false;
 	if (scriptState == RUNNING) {
 		// Script is running - hand control to MiniScript
 		// MiniScript will handle BeginDrawing/EndDrawing and everything else
 		if (!interpreter->Done()) {
+			frameRun = true;
 			try {
-				interpreter->RunUntilDone(0.1, false);  // Run until yield or timeout
+				double vmStart = GetTime();
+				SchedulerRunFrame(interpreter);  // Run until yield or frame budget used up
+				if (tracing) TraceComplete("vm", "frame", vmStart, GetTime());
+				EndFrameStats(GetSchedulerStats().vmTime);
+				NotePerfHUDFrame();
+				ProfilerEndFrame();
+				ReportStartup();
 			} catch (MiniscriptException& mse) {
 				PrintErr("Runtime Exception: " + mse.message);
 				interpreter->vm->Stop();
@@ -324,19 +292,20 @@ void MainLoop() {
 		if (scriptState == LOADING) {
 			// Loading screen
 			DrawText("MSRLWeb - MiniScript + Raylib", 10, 10, 30, DARKBLUE);
-			DrawText("Loading assets/main.ms...", 10, 50, 20, GRAY);
+			const char* loadingText = TextFormat("Loading %s", scriptPath);
+			DrawText(loadingText, 10, 50, 20, GRAY);
 
 			// Simple loading animation
 			int dots = ((int)(GetTime() * 2)) % 4;
 			const char* dotStr[] = {"", ".", "..", "..."};
-			DrawText(dotStr[dots], 250, 50, 20, GRAY);
+			DrawText(dotStr[dots], 10 + MeasureText(loadingText, 20), 50, 20, GRAY);
 		} else if (scriptState == ERRORED) {
 			// Error screen
 			DrawText("MSRLWeb - MiniScript + Raylib", 10, 10, 30, DARKBLUE);
 			if (!loadError.empty()) {
 				DrawText("Error loading script:", 10, 50, 20, RED);
 				DrawText(loadError.c_str(), 10, 80, 16, RED);
-				DrawText("Make sure assets/main.ms exists", 10, 110, 10, GRAY);
+				DrawText(TextFormat("Make sure %s exists", scriptPath), 10, 110, 10, GRAY);
 			} else if (!runtimeError.empty()) {
 				DrawText("The game has halted due to an error:", 10, 50, 20, RED);
 				DrawText(runtimeError.c_str(), 10, 80, 20, RED);
@@ -355,6 +324,12 @@ void MainLoop() {
 
 		EndDrawing();
 	}
+
+	// Unload what the script dropped, unless it's partway through drawing a
+	// frame (in which case EndDrawing will do it)
+	if (scriptState != RUNNING || !IsDrawingFrame()) UnloadDroppedResources();
+
+	UpdateBenchmark(frameRun);
 }
 
 //--------------------------------------------------------------------------------
@@ -363,22 +338,81 @@ void MainLoop() {
 
 void CleanupMiniScript() {
 	if (interpreter) {
+		SetResourceSiteVM(nullptr);
 		delete interpreter;
 		interpreter = nullptr;
 	}
+	UnloadDroppedResources();
 }
 
 //--------------------------------------------------------------------------------
 // Main
 //--------------------------------------------------------------------------------
 
-int main() {
+// How often --profile prints the intrinsic profile
+static const int kProfileReportFrames = 300;
+
+#ifndef PLATFORM_WEB
+// Write profiling results to a file (for --sample and --trace)
+static void WriteTextFile(const char* path, String text, const char* what) {
+	FILE* f = fopen(path, "w");
+	if (!f) {
+		printf("Couldn't write %s\n", path);
+		return;
+	}
+	fputs(text.c_str(), f);
+	fclose(f);
+	printf("Wrote %s to %s\n", what, path);
+}
+#endif
+
+int main(int argc, char *argv[]) {
 	// Initialize Raylib
 	const int screenWidth = 960;
 	const int screenHeight = 640;
 
+	#ifndef PLATFORM_WEB
+		// Native build: [--headless] [--profile] [--sample file] [--trace file]
+		//   [--bench frames [--timestep seconds] [--bench-out file]] [script path]
+		bool headless = false;
+		int benchFrames = 0;
+		double benchTimestep = 0;
+		const char* samplePath = nullptr;
+		const char* tracePath = nullptr;
+		for (int i = 1; i < argc; i++) {
+			if (strcmp(argv[i], "--headless") == 0) headless = true;
+			else if (strcmp(argv[i], "--profile") == 0) SetIntrinsicProfiling(true, kProfileReportFrames);
+			else if (strcmp(argv[i], "--sample") == 0 && i + 1 < argc) samplePath = argv[++i];
+			else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) tracePath = argv[++i];
+			else if (strcmp(argv[i], "--bench") == 0 && i + 1 < argc) benchFrames = atoi(argv[++i]);
+			else if (strcmp(argv[i], "--timestep") == 0 && i + 1 < argc) benchTimestep = atof(argv[++i]);
+			else if (strcmp(argv[i], "--bench-out") == 0 && i + 1 < argc) benchmarkOutPath = argv[++i];
+			else scriptPath = argv[i];
+		}
+		if (headless) SetConfigFlags(FLAG_WINDOW_HIDDEN);
+		if (samplePath) SetScriptSampling(true);
+		if (tracePath) SetTracing(true);
+	#else
+		// Web build: page URL parameters ?script=path&bench=frames&timestep=seconds
+		int benchFrames = 0;
+		double benchTimestep = 0;
+		char* param = js_get_query_param("script");
+		if (param) scriptPath = param;		// (kept for the session)
+		if ((param = js_get_query_param("bench"))) {
+			benchFrames = atoi(param);
+			free(param);
+		}
+		if ((param = js_get_query_param("timestep"))) {
+			benchTimestep = atof(param);
+			free(param);
+		}
+	#endif
+	if (benchFrames > 0) StartBenchmark(benchFrames, benchTimestep);
+
 	InitWindow(screenWidth, screenHeight, "MSRLWeb - MiniScript + Raylib");
+	InitFrameStats();
 	SetTargetFPS(60);
+	SchedulerSetTargetFPS(60);
 	InitAudioDevice();
 	InstallLoadFileHooks();
 
@@ -391,21 +425,36 @@ int main() {
 	// Initialize MiniScript
 	InitMiniScript();
 
-	// Start fetching the main script
-	fetchScript("assets/main.ms");
+	// Start fetching the asset manifest and pack, and the main script
+	LoadAssetManifest("assets/manifest.txt");
+	LoadAssetPack("assets/assets.pack");
+	fetchScript(scriptPath);
 
 	// Main loop
+	int exitCode = 0;
 	#ifdef PLATFORM_WEB
 		emscripten_set_main_loop(MainLoop, 0, 1);
 	#else
 		while (!WindowShouldClose()) {
 			MainLoop();
+			// When headless, there is no one to look at the final screen
+			if (headless && (scriptState == COMPLETE || scriptState == ERRORED)) break;
+			if (benchmarkDone) break;
+		}
+		if (scriptState == ERRORED) exitCode = 1;
+		if (IsBenchmarking() && !benchmarkCompleted) {
+			FinishBenchmark("window closed");		// (if not already reported)
+			exitCode = 1;
 		}
+		if (samplePath) WriteTextFile(samplePath, GetScriptProfile(), "script profile");
+		if (tracePath) WriteTextFile(tracePath, GetTraceJSON(), "trace");
 	#endif
 
 	// Cleanup
 	CleanupMiniScript();
+	CloseAudioDevice();
+	CloseFrameStats();
 	CloseWindow();
 
-	return 0;
+	return exitCode;
 }
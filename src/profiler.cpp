@@ -0,0 +1,197 @@
+//
+// profiler.cpp
+// MSRLWeb
+//
+// Opt-in profiling of the raylib intrinsics.
+//
+// Every raylib intrinsic already runs through a trampoline (see
+// RegisterIntrinsic), which counts its calls for GetFrameStats.  When
+// profiling is on, the trampoline also hands the call to ProfileIntrinsic,
+// which times it and adds it to that intrinsic's entry.  When it's off, the
+// only cost is the check of intrinsicProfiling.
+//
+// The time for an intrinsic that waits (e.g. LoadTexture fetching its file)
+// covers each of its calls, but not the frames in between.
+//
+// The sampling profiler finds where the script itself spends its time.  We
+// have no threads or timer interrupts to stop the VM with, so while it's on,
+// the scheduler runs the VM in pieces of sampleInterval, and after each one
+// we record where the VM is: the source location of each call on its stack
+// (as in an error's stack trace).  MiniScript functions have no names of
+// their own, so a frame is the line it was running.  Identical stacks are
+// counted together, and the result is in the "folded" format that flame
+// graph tools read.
+//
+
+#include "profiler.h"
+#include "raylib.h"
+#include <stdio.h>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#ifdef PLATFORM_WEB
+#include <emscripten.h>
+#endif
+
+using namespace MiniScript;
+
+// Number of intrinsics in the periodic console report
+static const int kReportLines = 15;
+
+// Most distinct call stacks the sampling profiler keeps (later ones are
+// counted together as "[other]")
+static const int kMaxSampledStacks = 10000;
+
+struct ProfileEntry {
+	String name;
+	long calls;				// since profiling was turned on
+	double time;
+	long intervalCalls;		// since the last console report
+	double intervalTime;
+};
+
+static std::vector<ProfileEntry> entries;
+
+bool intrinsicProfiling = false;
+static int reportFrames = 0;
+static int framesSinceReport = 0;
+
+int AddProfiledIntrinsic(const char *name) {
+	ProfileEntry entry = { String(name), 0, 0, 0, 0 };
+	entries.push_back(entry);
+	return (int)entries.size() - 1;
+}
+
+IntrinsicResult ProfileIntrinsic(int index, IntrinsicCode code, Context *context, IntrinsicResult partialResult) {
+	ProfileEntry& entry = entries[index];
+	if (partialResult.Done()) {
+		entry.calls++;
+		entry.intervalCalls++;
+	}
+	double startTime = GetTime();
+	IntrinsicResult result = code(context, partialResult);
+	double elapsed = GetTime() - startTime;
+	entry.time += elapsed;
+	entry.intervalTime += elapsed;
+	return result;
+}
+
+static void ClearIntervalCounts() {
+	for (ProfileEntry& entry : entries) {
+		entry.intervalCalls = 0;
+		entry.intervalTime = 0;
+	}
+	framesSinceReport = 0;
+}
+
+void SetIntrinsicProfiling(bool enabled, int frames) {
+	if (enabled && !intrinsicProfiling) {
+		for (ProfileEntry& entry : entries) {
+			entry.calls = 0;
+			entry.time = 0;
+		}
+		ClearIntervalCounts();
+	}
+	intrinsicProfiling = enabled;
+	reportFrames = frames;
+}
+
+ValueDict GetIntrinsicProfile() {
+	static const Value callsKey("calls");
+	static const Value timeKey("time");
+	ValueDict result;
+	for (const ProfileEntry& entry : entries) {
+		if (entry.calls == 0 && entry.time == 0) continue;
+		ValueDict item;
+		item.SetValue(callsKey, Value((double)entry.calls));
+		item.SetValue(timeKey, Value(entry.time));
+		result.SetValue(entry.name, item);
+	}
+	return result;
+}
+
+// Print the intrinsics that took the most time since the last report
+static void PrintReport() {
+	std::vector<const ProfileEntry*> busiest;
+	double totalTime = 0;
+	long totalCalls = 0;
+	for (const ProfileEntry& entry : entries) {
+		if (entry.intervalCalls == 0 && entry.intervalTime == 0) continue;
+		busiest.push_back(&entry);
+		totalTime += entry.intervalTime;
+		totalCalls += entry.intervalCalls;
+	}
+	std::sort(busiest.begin(), busiest.end(), [](const ProfileEntry* a, const ProfileEntry* b) {
+		return a->intervalTime > b->intervalTime;
+	});
+	printf("Intrinsic profile (%d frames): %ld calls, %.2f ms\n",
+		framesSinceReport, totalCalls, totalTime * 1000);
+	for (int i = 0; i < (int)busiest.size() && i < kReportLines; i++) {
+		const ProfileEntry* entry = busiest[i];
+		printf("  %-28s %8ld calls %9.3f ms %8.2f us/call\n", entry->name.c_str(),
+			entry->intervalCalls, entry->intervalTime * 1000,
+			entry->intervalCalls ? entry->intervalTime * 1e6 / entry->intervalCalls : 0);
+	}
+}
+
+void ProfilerEndFrame() {
+	if (!intrinsicProfiling || reportFrames <= 0) return;
+	if (++framesSinceReport < reportFrames) return;
+	PrintReport();
+	ClearIntervalCounts();
+}
+
+//--------------------------------------------------------------------------------
+// Sampling profiler
+//--------------------------------------------------------------------------------
+
+bool scriptSampling = false;
+double sampleInterval = 0.001;
+static std::map<std::string, long> sampledStacks;	// folded stack -> samples
+
+void SetScriptSampling(bool enabled, double interval) {
+	if (enabled && !scriptSampling) sampledStacks.clear();
+	scriptSampling = enabled;
+	if (interval > 0) sampleInterval = interval;
+}
+
+void SampleScriptStack(Machine *vm) {
+	ValueList stack = Intrinsics::StackList(vm);	// (innermost call first)
+	std::string folded;
+	for (long i = stack.Count() - 1; i >= 0; i--) {
+		std::string frame(stack[i].ToString().c_str());
+		std::replace(frame.begin(), frame.end(), ';', ',');
+		if (!folded.empty()) folded += ';';
+		folded += frame;
+	}
+	if (folded.empty()) return;
+	auto it = sampledStacks.find(folded);
+	if (it != sampledStacks.end()) it->second++;
+	else if ((int)sampledStacks.size() < kMaxSampledStacks) sampledStacks[folded] = 1;
+	else sampledStacks["[other]"]++;
+}
+
+String GetScriptProfile() {
+	std::string result;
+	for (const auto& entry : sampledStacks) {
+		result += entry.first;
+		result += ' ';
+		result += std::to_string(entry.second);
+		result += '\n';
+	}
+	return String(result.c_str());
+}
+
+#ifdef PLATFORM_WEB
+// For the browser's JavaScript console: Module._ProfileScript(1) starts
+// sampling, and Module._PrintScriptProfile() prints the samples so far
+extern "C" EMSCRIPTEN_KEEPALIVE void ProfileScript(int enabled) {
+	SetScriptSampling(enabled != 0);
+}
+
+extern "C" EMSCRIPTEN_KEEPALIVE void PrintScriptProfile() {
+	printf("%s", GetScriptProfile().c_str());
+}
+#endif
@@ -0,0 +1,50 @@
+//
+// profiler.h
+// MSRLWeb
+//
+// Opt-in profiling: calls and time spent in each raylib intrinsic, and
+// sampling of where the script spends its time
+//
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "MiniscriptTypes.h"
+#include "MiniscriptIntrinsics.h"
+
+// Whether intrinsic profiling is on (checked by every intrinsic call)
+extern bool intrinsicProfiling;
+
+// Note the name of the next intrinsic registered; returns its index
+int AddProfiledIntrinsic(const char *name);
+
+// Call the given intrinsic code, recording the call and its time
+MiniScript::IntrinsicResult ProfileIntrinsic(int index, MiniScript::IntrinsicCode code,
+	MiniScript::Context *context, MiniScript::IntrinsicResult partialResult);
+
+// Turn profiling on (clearing the counts) or off; with reportFrames > 0,
+// the busiest intrinsics are also printed every that many frames
+void SetIntrinsicProfiling(bool enabled, int reportFrames = 0);
+
+// Get the counts since profiling was turned on, as a map from intrinsic
+// name to a map of calls and time (seconds); intrinsics not called are left out
+MiniScript::ValueDict GetIntrinsicProfile();
+
+// Call once per frame (prints the periodic report, if it's due)
+void ProfilerEndFrame();
+
+// Whether the sampling profiler is on, and how often it samples (seconds)
+extern bool scriptSampling;
+extern double sampleInterval;
+
+// Turn the sampling profiler on (clearing its samples) or off
+void SetScriptSampling(bool enabled, double interval = 0.001);
+
+// Record a sample of the script's call stack (called by the scheduler)
+void SampleScriptStack(MiniScript::Machine *vm);
+
+// Get the samples so far in folded-stack format: one line per distinct call
+// stack, outermost frame first, separated by semicolons, then the count
+MiniScript::String GetScriptProfile();
+
+#endif // PROFILER_H
@@ -0,0 +1,180 @@
+//
+// scheduler.cpp
+// MSRLWeb
+//
+// Frame-budget-aware scheduling of MiniScript execution.
+//
+// Each frame, the VM gets a time slice that is a fraction of the frame period
+// (the target FPS, or the measured vsync cadence if that is shorter).  The
+// fraction adapts: when a script that uses its whole slice makes us miss a
+// frame, the slice shrinks; when such frames still land on time, it grows
+// back.  Scripts that are not presenting frames at all (loading, pure number
+// crunching) get the old generous slice, since there is no frame to protect.
+//
+// In FRAME_PACING_END_DRAWING mode (the default), raylib.EndDrawing ends the
+// slice itself, so a script that forgets to yield still runs one frame per
+// display refresh.  A plain `yield` right after such an EndDrawing would then
+// waste a whole frame doing nothing, so we absorb it and keep running.
+//
+// Benchmark mode runs frames back to back, so there is no frame period to
+// fit in; it gives every frame a long fixed slice instead, so each frame runs
+// until the script yields.
+//
+
+#include "scheduler.h"
+#include "profiler.h"
+#include "raylib.h"
+#include "MiniscriptInterpreter.h"
+#include <stdio.h>
+#include <algorithm>
+
+using namespace MiniScript;
+
+// Bounds on the fraction of a frame period the VM may use
+static const double kMinSliceFraction = 0.25;
+static const double kMaxSliceFraction = 0.85;
+
+// Slice used while the script is not drawing (matches the old fixed slice)
+static const double kUndrawnSlice = 0.1;
+
+// How many frames without an EndDrawing before we consider the script not drawing
+static const int kUndrawnFrameLimit = 10;
+
+// Minimum time between overrun reports on the console
+static const double kReportInterval = 1.0;
+
+static SchedulerStats stats = { 1.0 / 60, 0, 0, 0, 0, 0, 0, false };
+static double sliceFraction = 0.75;
+static double fixedSlice = 0;		// if nonzero, the slice every frame gets
+static double lastFrameStart = 0;
+static bool lastFrameOverran = false;
+static int framePacing = FRAME_PACING_END_DRAWING;
+static bool drewThisFrame = false;
+static bool lastFrameEndedAtDraw = false;
+static int framesSinceDraw = kUndrawnFrameLimit;
+static double lastReportTime = 0;
+static long unreportedOverruns = 0;
+
+void SchedulerSetTargetFPS(int fps) {
+	stats.targetFrameTime = (fps > 0) ? 1.0 / fps : 1.0 / 60;
+}
+
+void SchedulerSetFixedSlice(double seconds) {
+	fixedSlice = (seconds > 0) ? seconds : 0;
+}
+
+void SchedulerSetFramePacing(int mode) {
+	framePacing = (mode == FRAME_PACING_MANUAL) ? FRAME_PACING_MANUAL : FRAME_PACING_END_DRAWING;
+}
+
+int SchedulerGetFramePacing() {
+	return framePacing;
+}
+
+void SchedulerNoteFrameDrawn(Machine* vm) {
+	drewThisFrame = true;
+	if (framePacing == FRAME_PACING_END_DRAWING && vm) vm->yielding = true;
+}
+
+const SchedulerStats& GetSchedulerStats() {
+	return stats;
+}
+
+// Adjust the slice fraction based on how the previous frame went
+static void AdaptSlice(double period) {
+	if (!lastFrameOverran) return;	// script yielded in time; nothing to learn
+	if (stats.frameTime > period * 1.5) {
+		// We used the whole slice and still missed a frame: back off
+		sliceFraction *= 0.85;
+	} else if (stats.frameTime <= period * 1.25) {
+		// We used the whole slice but the frame was on time: there is headroom
+		sliceFraction += 0.02;
+	}
+	if (sliceFraction < kMinSliceFraction) sliceFraction = kMinSliceFraction;
+	if (sliceFraction > kMaxSliceFraction) sliceFraction = kMaxSliceFraction;
+}
+
+static void ReportOverrun(double now) {
+	unreportedOverruns++;
+	if (now - lastReportTime < kReportInterval) return;
+	printf("Frame budget overrun: script ran %.1f ms without yielding (budget %.1f ms); %ld overrun(s) since last report\n",
+		stats.vmTime * 1000, stats.slice * 1000, unreportedOverruns);
+	unreportedOverruns = 0;
+	lastReportTime = now;
+}
+
+// Run the VM for up to the given time.  While the sampling profiler is on,
+// we do this in pieces, sampling the call stack after each one.
+static void RunVM(Interpreter* interpreter, double timeLimit) {
+	if (!scriptSampling) {
+		interpreter->RunUntilDone(timeLimit, false);
+		return;
+	}
+	double start = GetTime();
+	while (true) {
+		double remaining = timeLimit - (GetTime() - start);
+		if (remaining <= 0) break;
+		interpreter->RunUntilDone(std::min(remaining, sampleInterval), false);
+		if (interpreter->Done() || interpreter->vm->yielding) break;
+		SampleScriptStack(interpreter->vm);
+	}
+}
+
+bool SchedulerRunFrame(Interpreter* interpreter) {
+	double start = GetTime();
+	if (lastFrameStart > 0) {
+		stats.frameTime = start - lastFrameStart;
+		// Only frames where the script yielded in time tell us the real
+		// display cadence; overrun frames are stretched by the script itself.
+		if (!lastFrameOverran && stats.frameTime > 0) {
+			if (stats.cadence == 0) stats.cadence = stats.frameTime;
+			else stats.cadence = stats.cadence * 0.9 + stats.frameTime * 0.1;
+		}
+	}
+	lastFrameStart = start;
+
+	double period = stats.targetFrameTime;
+	if (stats.cadence > 0 && stats.cadence < period) period = stats.cadence;
+
+	bool drawing = (framesSinceDraw < kUndrawnFrameLimit);
+	if (fixedSlice > 0) {
+		stats.slice = fixedSlice;
+	} else if (drawing) {
+		AdaptSlice(period);
+		stats.slice = period * sliceFraction;
+	} else {
+		stats.slice = kUndrawnSlice;
+	}
+
+	drewThisFrame = false;
+	RunVM(interpreter, stats.slice);
+
+	bool yielded = interpreter->vm && interpreter->vm->yielding;
+	if (yielded && !drewThisFrame && lastFrameEndedAtDraw
+			&& framePacing == FRAME_PACING_END_DRAWING) {
+		// An explicit yield right after EndDrawing already ended the last
+		// frame; don't spend this whole frame on it.
+		double remaining = stats.slice - (GetTime() - start);
+		if (remaining > 0) {
+			RunVM(interpreter, remaining);
+			yielded = interpreter->vm && interpreter->vm->yielding;
+		}
+	}
+	lastFrameEndedAtDraw = yielded && drewThisFrame && framePacing == FRAME_PACING_END_DRAWING;
+
+	double end = GetTime();
+	stats.vmTime = end - start;
+	stats.frames++;
+
+	lastFrameOverran = drawing && !yielded && !interpreter->Done();
+	if (lastFrameOverran) {
+		stats.overruns++;
+		ReportOverrun(end);
+	}
+
+	stats.drewFrame = drewThisFrame;
+	if (drewThisFrame) framesSinceDraw = 0;
+	else if (framesSinceDraw < kUndrawnFrameLimit) framesSinceDraw++;
+
+	return yielded;
+}
@@ -0,0 +1,58 @@
+//
+// scheduler.h
+// MSRLWeb
+//
+// Frame-budget-aware scheduling of MiniScript execution
+//
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+namespace MiniScript {
+	class Interpreter;
+	class Machine;
+}
+
+// Frame pacing modes: how the end of a script's frame is detected
+enum FramePacing {
+	FRAME_PACING_MANUAL = 0,		// script must call yield after EndDrawing
+	FRAME_PACING_END_DRAWING = 1	// EndDrawing ends the VM's time slice itself
+};
+
+// Statistics gathered by the scheduler, updated once per frame
+struct SchedulerStats {
+	double targetFrameTime;		// seconds per frame at the target FPS
+	double cadence;				// measured frame interval (smoothed), or 0 if unknown
+	double frameTime;			// real time between the starts of the last two frames
+	double slice;				// VM time budget given to the most recent frame
+	double vmTime;				// time actually spent in the VM in the most recent frame
+	long frames;				// frames run so far
+	long overruns;				// frames in which a drawing script used its whole slice
+	bool drewFrame;				// whether the script called EndDrawing in the most recent frame
+};
+
+// Set the frame rate the VM time slice is derived from
+// (called at startup and by raylib.SetTargetFPS)
+void SchedulerSetTargetFPS(int fps);
+
+// Give every frame the same fixed slice instead of adapting it to the frame
+// rate, or go back to adapting (with 0).  Benchmark mode sets a long one, so
+// that each frame runs until the script yields, however fast frames come.
+void SchedulerSetFixedSlice(double seconds);
+
+// Set or get the frame pacing mode (see FramePacing)
+void SchedulerSetFramePacing(int mode);
+int SchedulerGetFramePacing();
+
+// Note that the script presented a frame (called from raylib.EndDrawing);
+// with FRAME_PACING_END_DRAWING, this also makes the VM yield.
+void SchedulerNoteFrameDrawn(MiniScript::Machine* vm);
+
+// Run the interpreter for one frame: until the script yields, finishes,
+// or uses up its time slice for this frame.  Returns true if it yielded.
+bool SchedulerRunFrame(MiniScript::Interpreter* interpreter);
+
+// Get the scheduler statistics
+const SchedulerStats& GetSchedulerStats();
+
+#endif // SCHEDULER_H
@@ -0,0 +1,151 @@
+//
+// trace.cpp
+// MSRLWeb
+//
+// Trace events, exported in Chrome's trace event format (as read by
+// chrome://tracing, Perfetto, and speedscope).
+//
+// While tracing is on, the host records an event for each phase of a frame
+// (running the VM, BeginDrawing to EndDrawing, presenting the frame), each
+// fetch, and each texture upload.  Events go into a ring buffer, so tracing
+// can be left on for a whole session: the export is always the most recent
+// events.
+//
+
+#include "trace.h"
+#include "raylib.h"
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#ifdef PLATFORM_WEB
+#include <emscripten.h>
+#endif
+
+using namespace MiniScript;
+
+struct TraceEvent {
+	std::string name;
+	const char *category;
+	char phase;			// 'X' (complete), 'b' or 'e' (async begin/end)
+	double start;		// seconds
+	double duration;	// seconds (complete events only)
+	long id;			// async events only
+};
+
+bool tracing = false;
+static std::vector<TraceEvent> events;	// ring buffer
+static int nextEvent = 0;				// where the next event goes
+static int eventCount = 0;
+
+void SetTracing(bool enabled, int capacity) {
+	if (enabled && !tracing) {
+		events.clear();
+		events.resize(capacity > 0 ? capacity : kDefaultTraceCapacity);
+		nextEvent = 0;
+		eventCount = 0;
+	}
+	tracing = enabled;
+}
+
+static void AddEvent(const char *name, const char *category, char phase, double start, double duration, long id) {
+	if (!tracing || events.empty()) return;
+	TraceEvent& event = events[nextEvent];
+	event.name = name;
+	event.category = category;
+	event.phase = phase;
+	event.start = start;
+	event.duration = duration;
+	event.id = id;
+	nextEvent = (nextEvent + 1) % (int)events.size();
+	if (eventCount < (int)events.size()) eventCount++;
+}
+
+void TraceComplete(const char *name, const char *category, double start, double end) {
+	AddEvent(name, category, 'X', start, end - start, 0);
+}
+
+void TraceAsyncBegin(const char *name, const char *category, long id, double time) {
+	AddEvent(name, category, 'b', time, 0, id);
+}
+
+void TraceAsyncEnd(const char *name, const char *category, long id, double time) {
+	AddEvent(name, category, 'e', time, 0, id);
+}
+
+TraceScope::TraceScope(const char *name, const char *category)
+: name(name), category(category), start(tracing ? GetTime() : 0) {
+}
+
+TraceScope::~TraceScope() {
+	if (tracing) TraceComplete(name, category, start, GetTime());
+}
+
+void AppendJSONString(std::string& out, const char *s) {
+	out += '"';
+	for (; *s; s++) {
+		unsigned char c = (unsigned char)*s;
+		if (c == '"' || c == '\\') {
+			out += '\\';
+			out += (char)c;
+		} else if (c < 0x20) {
+			char buf[8];
+			snprintf(buf, sizeof(buf), "\\u%04x", c);
+			out += buf;
+		} else {
+			out += (char)c;
+		}
+	}
+	out += '"';
+}
+
+String GetTraceJSON() {
+	std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	int first = (eventCount < (int)events.size()) ? 0 : nextEvent;	// (oldest event)
+	char buf[128];
+	for (int i = 0; i < eventCount; i++) {
+		const TraceEvent& event = events[(first + i) % events.size()];
+		if (i > 0) out += ',';
+		out += "{\"name\":";
+		AppendJSONString(out, event.name.c_str());
+		out += ",\"cat\":";
+		AppendJSONString(out, event.category);
+		// (Times are in microseconds.)
+		snprintf(buf, sizeof(buf), ",\"ph\":\"%c\",\"ts\":%.1f,\"pid\":1,\"tid\":1",
+			event.phase, event.start * 1e6);
+		out += buf;
+		if (event.phase == 'X') {
+			snprintf(buf, sizeof(buf), ",\"dur\":%.1f", event.duration * 1e6);
+			out += buf;
+		} else {
+			snprintf(buf, sizeof(buf), ",\"id\":%ld", event.id);
+			out += buf;
+		}
+		out += '}';
+	}
+	out += "]}";
+	return String(out.c_str());
+}
+
+#ifdef PLATFORM_WEB
+// Have the browser save the given text as a file
+EM_JS(void, js_save_text, (const char *_name, const char *_text), {
+	const blob = new Blob([UTF8ToString(_text)], {type: 'application/json'});
+	const link = document.createElement('a');
+	link.href = URL.createObjectURL(blob);
+	link.download = UTF8ToString(_name);
+	link.click();
+	setTimeout(() => URL.revokeObjectURL(link.href), 0);
+});
+
+// For the browser's JavaScript console: Module._StartTrace() starts
+// recording, and Module._SaveTrace() downloads the events as trace.json
+extern "C" EMSCRIPTEN_KEEPALIVE void StartTrace() {
+	SetTracing(true);
+}
+
+extern "C" EMSCRIPTEN_KEEPALIVE void SaveTrace() {
+	String json = GetTraceJSON();
+	js_save_text("trace.json", json.c_str());
+}
+#endif
@@ -0,0 +1,49 @@
+//
+// trace.h
+// MSRLWeb
+//
+// Recording of trace events (frame phases, fetches, texture uploads), for
+// viewing a session's timeline in a Chrome-compatible trace viewer
+//
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "MiniscriptTypes.h"
+#include <string>
+
+// Number of events kept (the oldest are dropped first)
+static const int kDefaultTraceCapacity = 10000;
+
+// Whether trace events are being recorded
+extern bool tracing;
+
+// Start recording (discarding earlier events) or stop
+void SetTracing(bool enabled, int capacity = kDefaultTraceCapacity);
+
+// Record an event that took place from start to end (times from GetTime)
+void TraceComplete(const char *name, const char *category, double start, double end);
+
+// Record the start or end of something that overlaps other events (like a
+// fetch); the two are matched up by category and id
+void TraceAsyncBegin(const char *name, const char *category, long id, double time);
+void TraceAsyncEnd(const char *name, const char *category, long id, double time);
+
+// Get the recorded events in Chrome's trace event JSON format
+MiniScript::String GetTraceJSON();
+
+// Append a string to JSON output, with quotes and escapes
+void AppendJSONString(std::string& out, const char *s);
+
+// Records an event for the lifetime of the object (if tracing)
+class TraceScope {
+public:
+	TraceScope(const char *name, const char *category);
+	~TraceScope();
+private:
+	const char *name;
+	const char *category;
+	double start;
+};
+
+#endif // TRACE_H
@@ -7,6 +7,10 @@
 echo "Copying build/msrlweb.*"
 cp build/msrlweb.* docs/
 
+echo "Generating assets/manifest.txt and assets/assets.pack"
+./generate_manifest.sh
+python3 generate_pack.py
+
 echo "Copying build/assets"
 rm -rf docs/assets
 cp -r assets docs/